@@ -4,6 +4,7 @@
 #include <cstring>
 #include <iostream> 
 #include <mutex>
+#include <atomic>
 #include <boost/format.hpp>
 
 
@@ -194,5 +195,181 @@ namespace SoDa {
     // locks for tail and head pointer
     std::mutex pointer_mutex; 
   }; 
+
+  /**
+   * @class SPSCCircularBuffer
+   *
+   * @brief A lock-free circular buffer for exactly one producer
+   * thread and exactly one consumer thread.
+   *
+   * Unlike CircularBuffer, this never overwrites unread data -- put
+   * returns a short count when the buffer is full.  The head and
+   * tail indices count elements written and read since the buffer
+   * was created; the buffer size is a power of two so an index is
+   * turned into a position with a mask.
+   *
+   * The acquire/commit calls expose the free (or filled) region as
+   * at most two contiguous spans, so the producer can read from a
+   * socket directly into the buffer, and the consumer can hand the
+   * samples to a sink without an intermediate copy:
+   * \code
+   *   SoDa::SPSCCircularBuffer<char>::Span sp[2];
+   *   size_t n = cb.acquireWrite(sp, want);
+   *   size_t got = 0;
+   *   for(int i = 0; i < 2; i++) got += sock->read(sp[i].ptr, sp[i].len);
+   *   cb.commitWrite(got);
+   * \endcode
+   */
+  template<typename T> class SPSCCircularBuffer {
+  public:
+    /**
+     * @brief a contiguous piece of the buffer
+     */
+    struct Span {
+      T * ptr;
+      size_t len;
+    };
+
+    /**
+     * @brief constructor
+     *
+     * @param elements the minimum capacity -- rounded up to a power of two
+     */
+    SPSCCircularBuffer(size_t elements) {
+      buffer_elements = 1;
+      while(buffer_elements < elements) buffer_elements = buffer_elements << 1;
+      mask = buffer_elements - 1;
+      buffer = new T[buffer_elements];
+      head.store(0);
+      tail.store(0);
+      clear_request.store(false);
+    }
+
+    ~SPSCCircularBuffer() {
+      delete[] buffer;
+    }
+
+    /**
+     * @brief ask the consumer to throw away everything that is
+     * in the buffer now.  Safe to call from either thread; the buffer
+     * is emptied at the consumer's next acquireRead or get.
+     */
+    void clear() {
+      clear_request.store(true, std::memory_order_release);
+    }
+
+    /**
+     * @brief the number of elements waiting to be read.  Safe from either thread.
+     */
+    size_t numElements() const {
+      size_t t = tail.load(std::memory_order_acquire);
+      return head.load(std::memory_order_acquire) - t;
+    }
+
+    /**
+     * @brief the number of elements that can be written right now
+     */
+    size_t freeSpace() const {
+      return buffer_elements - numElements();
+    }
+
+    size_t capacity() const { return buffer_elements; }
+
+    /**
+     * @brief get up to len elements of free space.  Producer only.
+     *
+     * @param spans filled with the free region -- spans[1].len is
+     * zero unless the region wraps around the end of the buffer
+     * @param len the most elements we want
+     * @return the total length of the spans
+     */
+    size_t acquireWrite(Span spans[2], size_t len) {
+      size_t h = head.load(std::memory_order_relaxed);
+      size_t t = tail.load(std::memory_order_acquire);
+      size_t avail = buffer_elements - (h - t);
+      if(len > avail) len = avail;
+      return makeSpans(spans, h, len);
+    }
+
+    /**
+     * @brief publish n elements written into the spans from acquireWrite.  Producer only.
+     */
+    void commitWrite(size_t n) {
+      head.store(head.load(std::memory_order_relaxed) + n, std::memory_order_release);
+    }
+
+    /**
+     * @brief get up to len elements of unread data.  Consumer only.
+     *
+     * @param spans filled with the readable region, oldest first
+     * @param len the most elements we want
+     * @return the total length of the spans
+     */
+    size_t acquireRead(Span spans[2], size_t len) {
+      size_t h = head.load(std::memory_order_acquire);
+      if(clear_request.exchange(false, std::memory_order_acq_rel)) {
+	tail.store(h, std::memory_order_release);
+      }
+      size_t t = tail.load(std::memory_order_relaxed);
+      size_t avail = h - t;
+      if(len > avail) len = avail;
+      return makeSpans(spans, t, len);
+    }
+
+    /**
+     * @brief release n elements obtained from acquireRead.  Consumer only.
+     */
+    void commitRead(size_t n) {
+      tail.store(tail.load(std::memory_order_relaxed) + n, std::memory_order_release);
+    }
+
+    /**
+     * @brief copy in as much of the input as will fit.  Producer only.
+     * @return the number of elements written
+     */
+    size_t put(const T * in, size_t len) {
+      Span sp[2];
+      size_t n = acquireWrite(sp, len);
+      memcpy(sp[0].ptr, in, sizeof(T) * sp[0].len);
+      if(sp[1].len > 0) memcpy(sp[1].ptr, in + sp[0].len, sizeof(T) * sp[1].len);
+      commitWrite(n);
+      return n;
+    }
+
+    /**
+     * @brief copy out up to len elements.  Consumer only.
+     * @return the number of elements read
+     */
+    size_t get(T * out, size_t len) {
+      Span sp[2];
+      size_t n = acquireRead(sp, len);
+      memcpy(out, sp[0].ptr, sizeof(T) * sp[0].len);
+      if(sp[1].len > 0) memcpy(out + sp[0].len, sp[1].ptr, sizeof(T) * sp[1].len);
+      commitRead(n);
+      return n;
+    }
+
+  private:
+    size_t makeSpans(Span spans[2], size_t idx, size_t len) {
+      size_t pos = idx & mask;
+      size_t first = buffer_elements - pos;
+      if(first > len) first = len;
+      spans[0].ptr = buffer + pos;
+      spans[0].len = first;
+      spans[1].ptr = buffer;
+      spans[1].len = len - first;
+      return len;
+    }
+
+    T * buffer;
+    size_t buffer_elements; ///< always a power of two
+    size_t mask;            ///< buffer_elements - 1
+
+    // the producer owns head, the consumer owns tail.  Keep them
+    // on separate cache lines so they don't bounce between cores.
+    alignas(64) std::atomic<size_t> head; ///< number of elements written
+    alignas(64) std::atomic<size_t> tail; ///< number of elements read
+    std::atomic<bool> clear_request;      ///< consumer should discard everything
+  };
 }
 #endif
@@ -52,6 +52,11 @@ IFServer::IFServer(const std::string & name) : SoDa::Thread(name) {
 
   // we'll start with a center frequency of 0.  
   current_rx_center_freq = 0.0; 
+
+  // and the 3rd LO off, until the radio tells us otherwise.
+  rx_sample_rate = 625000.0;
+  current_lo3_freq = 0.0; 
+  IF_osc.setPhaseIncr(0.0); 
 }
 
 /**
@@ -137,8 +142,12 @@ bool IFServer::sendBuffer(SoDa::Buf * rxbuf) {
     *blen_p = buffer_length;
     *freq_p = current_rx_center_freq;
     
-    // copy the data
-    memcpy(cbuf, rxbuf->getComplexBuf(), buffer_length);
+    // The RX stream is the 3rd IF -- mix it down by the 3rd LO so
+    // the tuned signal is at DC, and copy it into the message.
+    unsigned int len = rxbuf->getComplexLen(); 
+    mix_buf.resize(len); 
+    IF_osc.mix(rxbuf->getComplexBuf(), mix_buf.data(), len);
+    memcpy(cbuf, mix_buf.data(), buffer_length);
 
     // send the message
     server_socket->put(message, message_size);
@@ -186,5 +195,25 @@ void IFServer::execRepCommand(SoDa::Command * cmd)
     current_rx_center_freq = cmd->dparms[0];
     // We'll use the current rx center freq setting in outbound messages
     break;
+  case SoDa::Command::RX_SAMP_RATE:
+    rx_sample_rate = cmd->dparms[0];
+    IF_osc.setPhaseIncr(current_lo3_freq * 2.0 * M_PI / rx_sample_rate);
+    break;
+  default:
+    break; 
+  }
+}
+
+void IFServer::execSetCommand(SoDa::Command * cmd)
+{
+  switch (cmd->target) {
+  case SoDa::Command::RX_LO3_FREQ:
+    // The RX stream isn't mixed by the 3rd LO -- we do that
+    // ourselves, in sendBuffer.
+    current_lo3_freq = cmd->dparms[0];
+    IF_osc.setPhaseIncr(current_lo3_freq * 2.0 * M_PI / rx_sample_rate);
+    break;
+  default:
+    break; 
   }
 }
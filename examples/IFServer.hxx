@@ -32,6 +32,9 @@
 #include <SoDaRadio/SoDaBase.hxx>
 #include <SoDaRadio/SoDaThread.hxx>
 #include <SoDaRadio/UDSockets.hxx>
+#include <SoDaRadio/QuadratureOscillator.hxx>
+#include <vector>
+#include <complex>
 /**
  * @file IFServer.hxx
  *
@@ -72,6 +75,10 @@ $ SoDaRadio
  * and makes them available on a unix domain socket called "IFServer"
  * and located in the directory from which SoDaRadio was started. 
  *
+ * The RX stream carries the 3rd IF, so IFServer mixes each buffer
+ * down by the 3rd LO (from the RX_LO3_FREQ command) before sending
+ * it -- the tuned signal is at DC. 
+ *
  * Each block is of the form: 
  *
  * uint32 buffer_length (bytes)
@@ -143,6 +150,14 @@ public:
    * referenced (RX_FE_FREQ, STOP...) and an optional data value. 
    */
   void execRepCommand(SoDa::Command * cmd);
+
+  /**
+   * @brief handle SET commands from the command stream -- we watch
+   * for the 3rd LO setting (RX_LO3_FREQ).
+   *
+   * @param cmd the incoming command
+   */
+  void execSetCommand(SoDa::Command * cmd);
   
 protected:
   /**
@@ -169,6 +184,11 @@ protected:
   SoDa::UD::ServerSocket * server_socket; 
 
   double current_rx_center_freq; 
+
+  double rx_sample_rate; ///< from the RX_SAMP_RATE report
+  double current_lo3_freq; ///< from the RX_LO3_FREQ report
+  SoDa::QuadratureOscillator IF_osc; ///< the 3rd LO
+  std::vector<std::complex<float>> mix_buf; ///< the mixed buffer, on its way to the socket
 };
 
 #endif
@@ -0,0 +1,233 @@
+/*
+  Copyright (c) 2026, Matthew H. Reilly (kb1vc)
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+  Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in
+  the documentation and/or other materials provided with the
+  distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * Check the VecOps demodulator kernels (fmDisc, mag, ssbCombine,
+ * sumSqPeak) against the scalar loops they replaced in BaseBandRX,
+ * for every kernel set this CPU can run, and time them.
+ *
+ * Usage: Demod_Test [IF_file]
+ *   IF_file is a raw complex<float> recording, as written by the
+ *   IFRecorder.  Without it we make up a few seconds of an FM
+ *   broadcast signal in noise.
+ */
+
+#include "../src/VecOps.hxx"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <sys/time.h>
+
+double curTime()
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return ((double) tv.tv_sec) + 1.0e-6 * ((double) tv.tv_usec); 
+}
+
+const unsigned int blen = 30000;
+
+// These are the loops from BaseBandRX before the vector kernels.
+void refFM(float * out, const std::complex<float> * in, float & last_phase_samp, unsigned int len)
+{
+  for(unsigned int i = 0; i < len; i++) {
+    float phase = arg(in[i]);
+    float dphase = phase - last_phase_samp;
+    if(dphase < -M_PI) dphase += 2.0 * M_PI;
+    if(dphase > M_PI) dphase -= 2.0 * M_PI;
+    out[i] = dphase; 
+    last_phase_samp = phase; 
+  }
+}
+
+float refMag(float * out, const std::complex<float> * in, unsigned int len)
+{
+  float sum = 0.0; 
+  for(unsigned int i = 0; i < len; i++) {
+    out[i] = abs(in[i]);
+    sum += out[i]; 
+  }
+  return sum; 
+}
+
+void refSSB(float * out, const std::complex<float> * in, float sbmul, unsigned int len)
+{
+  for(unsigned int i = 0; i < len; i++) {
+    out[i] = (float) (in[i].real() + sbmul * in[i].imag()); 
+  }
+}
+
+double refSumSq(const float * in, unsigned int len)
+{
+  double al = 0.0; 
+  for(unsigned int i = 0; i < len; i++) al += in[i] * in[i]; 
+  return al; 
+}
+
+void makeFM(std::vector<std::complex<float> > & v, unsigned int len)
+{
+  v.resize(len); 
+  double ph = 0.0;
+  srandom(1234);
+  for(unsigned int i = 0; i < len; i++) {
+    // 75 kHz deviation, a 1 kHz tone, 20 kHz off center
+    double f = 20e3 + 75e3 * sin(2.0 * M_PI * 1e3 * i / 625e3);
+    ph = remainder(ph + 2.0 * M_PI * f / 625e3, 2.0 * M_PI);
+    double nr = ((double) random() / RAND_MAX) - 0.5; 
+    double ni = ((double) random() / RAND_MAX) - 0.5; 
+    v[i] = std::complex<float>(0.01 * cos(ph) + 0.002 * nr, 0.01 * sin(ph) + 0.002 * ni); 
+  }
+  // and a stretch of dead air
+  for(unsigned int i = 1000; i < 1100; i++) v[i] = 0.0; 
+}
+
+int main(int argc, char * argv[])
+{
+  std::vector<std::complex<float> > ifbuf;
+  if(argc > 1) {
+    std::ifstream inf(argv[1], std::ios::binary);
+    if(!inf) {
+      std::cerr << "Can't open " << argv[1] << "\n";
+      return -1; 
+    }
+    std::complex<float> v;
+    while(inf.read((char*) &v, sizeof(v))) ifbuf.push_back(v);
+  }
+  else {
+    makeFM(ifbuf, 100 * blen); 
+  }
+  unsigned int count = (ifbuf.size() / blen) * blen;
+  if(count == 0) {
+    std::cerr << "Need at least " << blen << " samples\n";
+    return -1; 
+  }
+  std::cout << count << " IF samples\n";
+
+  std::vector<float> ref(count), res(count), ref2(count), res2(count); 
+  bool pass = true; 
+
+  // reference answers and times
+  double t0 = curTime();
+  float last_phase = 0.0; 
+  for(unsigned int i = 0; i < count; i += blen) refFM(&ref[i], &ifbuf[i], last_phase, blen);
+  double ref_fm_time = curTime() - t0;
+  t0 = curTime();
+  float ref_mag_sum = 0.0;
+  for(unsigned int i = 0; i < count; i += blen) ref_mag_sum += refMag(&ref2[i], &ifbuf[i], blen);
+  double ref_mag_time = curTime() - t0;
+  std::vector<float> ref_ssb(count);
+  refSSB(&ref_ssb[0], &ifbuf[0], -1.0, count);
+  // powers from 1e-20 to 1e15 (and a few zeros) for the dB kernel
+  std::vector<float> pwr(count), ref_db(count);
+  for(unsigned int i = 0; i < count; i++) {
+    pwr[i] = std::norm(ifbuf[i]) * powf(10.0, ((float) (i % 701)) * 0.05 - 20.0);
+  }
+  t0 = curTime();
+  for(unsigned int i = 0; i < count; i++) {
+    ref_db[i] = 10.0 * log10(((pwr[i] * 0.05f) > 1e-30f) ? (pwr[i] * 0.05f) : 1e-30f);
+  }
+  double ref_db_time = curTime() - t0;
+
+  SoDa::VecOps::ISA isas[] = { SoDa::VecOps::SCALAR, SoDa::VecOps::SSE2, 
+			       SoDa::VecOps::AVX2, SoDa::VecOps::NEON };
+  for(auto isa : isas) {
+    if(!SoDa::VecOps::forceISA(isa)) continue; 
+
+    // first sample: phase 0 to start, same as last_phase_samp = 0
+    std::complex<float> prev(1.0, 0.0);
+    t0 = curTime();
+    for(unsigned int i = 0; i < count; i += blen) SoDa::VecOps::fmDisc(&res[i], &ifbuf[i], prev, 1.0, blen);
+    double fm_time = curTime() - t0;
+    t0 = curTime();
+    float mag_sum = 0.0;
+    for(unsigned int i = 0; i < count; i += blen) mag_sum += SoDa::VecOps::mag(&res2[i], &ifbuf[i], 1.0, blen);
+    double mag_time = curTime() - t0;
+    std::vector<float> ssb(count);
+    SoDa::VecOps::ssbCombine(&ssb[0], &ifbuf[0], -1.0, count);
+    std::vector<float> db(count);
+    t0 = curTime();
+    SoDa::VecOps::dB(&db[0], &pwr[0], 0.05, count);
+    double db_time = curTime() - t0;
+    float db_err = 0.0;
+    for(unsigned int i = 0; i < count; i++) {
+      float d = fabs(db[i] - ref_db[i]);
+      db_err = (d > db_err) ? d : db_err; 
+    }
+    // the level meter sees one audio buffer at a time
+    const unsigned int alen = 2304; 
+    float al_err = 0.0, peak_err = 0.0; 
+    for(unsigned int i = 0; i + alen <= count; i += alen) {
+      float peak, ref_peak = 0.0; 
+      float al = SoDa::VecOps::sumSqPeak(&ssb[i], alen, peak);
+      double ref_al = refSumSq(&ref_ssb[i], alen);
+      for(unsigned int j = i; j < i + alen; j++) {
+	ref_peak = (fabs(ref_ssb[j]) > ref_peak) ? fabs(ref_ssb[j]) : ref_peak; 
+      }
+      float d = fabs(al - ref_al) / ref_al;
+      al_err = (d > al_err) ? d : al_err; 
+      d = fabs(peak - ref_peak);
+      peak_err = (d > peak_err) ? d : peak_err; 
+    }
+
+    float fm_err = 0.0, mag_err = 0.0, ssb_err = 0.0; 
+    for(unsigned int i = 0; i < count; i++) {
+      // the reference wraps at +/- pi, so compare the angle.  arg(0)
+      // is 0, so the old discriminator saw a phase step going into
+      // and out of a dead (all zero) stretch.  The new one says 0 --
+      // don't count those.
+      float d = fabs(remainder(res[i] - ref[i], 2.0 * M_PI));
+      bool dead = (ifbuf[i] == 0.0f) || ((i > 0) && (ifbuf[i-1] == 0.0f)); 
+      if(!dead) fm_err = (d > fm_err) ? d : fm_err;
+      d = fabs(res2[i] - ref2[i]) / (ref2[i] + 1e-20);
+      mag_err = (d > mag_err) ? d : mag_err;
+      d = fabs(ssb[i] - ref_ssb[i]);
+      ssb_err = (d > ssb_err) ? d : ssb_err;
+    }
+    float mag_sum_err = fabs(mag_sum - ref_mag_sum) / ref_mag_sum;
+
+    bool ok = (fm_err < 1e-5) && (mag_err < 1e-5) && (ssb_err == 0.0) && 
+      (mag_sum_err < 1e-4) && (al_err < 1e-5) && (peak_err == 0.0) && (db_err < 1e-3); 
+    pass = pass && ok; 
+
+    std::cout << SoDa::VecOps::isaName(isa) << (ok ? "" : "  *** FAILED ***") << "\n"
+	      << "  fmDisc     max error " << fm_err << " rad  " 
+	      << (1e9 * fm_time / count) << " nS/sample (was " << (1e9 * ref_fm_time / count) << ")\n"
+	      << "  mag        max rel error " << mag_err << " sum " << mag_sum_err << "  "
+	      << (1e9 * mag_time / count) << " nS/sample (was " << (1e9 * ref_mag_time / count) << ")\n"
+	      << "  ssbCombine max error " << ssb_err << "\n"
+	      << "  sumSqPeak  max rel error " << al_err << " peak error " << peak_err << "\n"
+	      << "  dB         max error " << db_err << " dB  "
+	      << (1e9 * db_time / count) << " nS/sample (log10 " << (1e9 * ref_db_time / count) << ")\n";
+  }
+
+  std::cout << (pass ? "PASS" : "FAIL") << "\n";
+  return pass ? 0 : -1; 
+}
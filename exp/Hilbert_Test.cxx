@@ -434,6 +434,95 @@ int doPMTest(int argc, char * argv[])
   return 1; 
 }
 
+/**
+ * doSidebandTest -- check that applySSB matches applyIQ followed by
+ * the sideband sum/difference, and measure the unwanted sideband
+ * rejection of the fused audio/sideband filter from makeSSBFilter
+ * against the old audio filter -> applyIQ -> sum/diff chain. 
+ */
+int doSidebandTest(int argc, char * argv[])
+{
+  (void) argc; (void) argv; 
+  unsigned int buflen = 2304;
+  unsigned int i, j, k;
+  
+  // part 1: applySSB vs applyIQ
+  SoDa::HilbertTransformer HT_iq(buflen, 256);
+  SoDa::HilbertTransformer HT_l(buflen, 256);
+  SoDa::HilbertTransformer HT_u(buflen, 256);
+  std::complex<float> inbuf[buflen], iqbuf[buflen];
+  float lbuf[buflen], ubuf[buflen]; 
+  srandom(0x13255);
+  float maxerr = 0.0, maxval = 0.0; 
+  for(k = 0; k < 10; k++) {
+    for(j = 0; j < buflen; j++) {
+      inbuf[j] = std::complex<float>(((float) (random() & 0xffff)) / 65536.0 - 0.5,
+				     ((float) (random() & 0xffff)) / 65536.0 - 0.5);
+    }
+    HT_iq.applyIQ(inbuf, iqbuf, 1.0);
+    HT_l.applySSB(inbuf, lbuf, true, 1.0);
+    HT_u.applySSB(inbuf, ubuf, false, 1.0);
+    for(j = 0; j < buflen; j++) {
+      float l = iqbuf[j].real() + iqbuf[j].imag();
+      float u = iqbuf[j].real() - iqbuf[j].imag();
+      maxerr = std::max(maxerr, std::max(fabsf(l - lbuf[j]), fabsf(u - ubuf[j])));
+      maxval = std::max(maxval, std::max(fabsf(l), fabsf(u)));
+    }
+  }
+  std::cout << boost::format("applySSB vs applyIQ: max error %g (max output %g)\n") % maxerr % maxval; 
+
+  // part 2: sideband rejection. 
+  float fs = 48000.0; 
+  float test_freqs[] = { 300.0, 500.0, 1000.0, 2000.0 }; 
+  for(i = 0; i < 4; i++) {
+    float pwr[2][2][2]; // [fused/old][lsb/usb filter][negative/positive tone]
+    for(int tone = 0; tone < 2; tone++) {
+      float freq = (tone == 0) ? -test_freqs[i] : test_freqs[i]; 
+      SoDa::OSFilter audio(200.0, 300.0, 2300.0, 2400.0, 512, 1.0, fs, buflen);
+      SoDa::OSFilter * fused[2];
+      fused[0] = SoDa::HilbertTransformer::makeSSBFilter(true, &audio, buflen);
+      fused[1] = SoDa::HilbertTransformer::makeSSBFilter(false, &audio, buflen);
+      SoDa::HilbertTransformer HT_old(buflen, 256);
+      double acc[2][2] = {{0.0, 0.0}, {0.0, 0.0}};
+      double ang = 0.0, ang_inc = 2.0 * M_PI * freq / fs; 
+      std::complex<float> obuf[buflen], abuf[buflen];
+      for(k = 0; k < 8; k++) {
+	for(j = 0; j < buflen; j++) {
+	  inbuf[j] = std::complex<float>(cos(ang), sin(ang));
+	  ang += ang_inc; 
+	}
+	for(int sb = 0; sb < 2; sb++) {
+	  fused[sb]->apply(inbuf, obuf, 1.0);
+	  if(k < 2) continue; 
+	  for(j = 0; j < buflen; j++) acc[0][sb] += obuf[j].real() * obuf[j].real();
+	}
+	audio.apply(inbuf, abuf, 1.0);
+	HT_old.applyIQ(abuf, obuf, 1.0);
+	if(k < 2) continue; 
+	for(j = 0; j < buflen; j++) {
+	  float l = obuf[j].real() + obuf[j].imag();
+	  float u = obuf[j].real() - obuf[j].imag();
+	  acc[1][0] += l * l; 
+	  acc[1][1] += u * u; 
+	}
+      }
+      for(int m = 0; m < 2; m++) {
+	for(int sb = 0; sb < 2; sb++) pwr[m][sb][tone] = acc[m][sb]; 
+      }
+      delete fused[0];
+      delete fused[1]; 
+    }
+    for(int m = 0; m < 2; m++) {
+      std::cout << boost::format("%s %6.0f Hz  LSB rejection %6.1f dB  USB rejection %6.1f dB\n")
+	% ((m == 0) ? "fused" : "old  ") % test_freqs[i]
+	% (10.0 * log10(pwr[m][0][0] / pwr[m][0][1]))
+	% (10.0 * log10(pwr[m][1][1] / pwr[m][1][0]));
+    }
+  }
+  
+  return 1; 
+}
+
 int main(int argc, char * argv[])
 {
   // Test out the Hilbert Transformer module
@@ -456,6 +545,8 @@ int main(int argc, char * argv[])
 
   doSSBTest(argc, argv);
 
+  doSidebandTest(argc, argv);
+
   doPMTest(argc, argv);
 }
 
@@ -0,0 +1,138 @@
+/*
+  Copyright (c) 2026, Matthew H. Reilly (kb1vc)
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+  Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in
+  the documentation and/or other materials provided with the
+  distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * Compare the block (fill/mix) QuadratureOscillator against the 
+ * one-sample-at-a-time stepOscCF version, and both against an exact
+ * sincos of a long double phase.
+ *
+ * Usage: QuadOsc_Test [sample_count [freq_hz]]
+ *   sample_count defaults to 1e9, freq to 102.3456 kHz at 625 kS/s
+ */
+
+#include "../src/QuadratureOscillator.hxx"
+#include <iostream>
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <sys/time.h>
+
+double curTime()
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return ((double) tv.tv_sec) + 1.0e-6 * ((double) tv.tv_usec); 
+}
+
+float phaseErr(std::complex<float> a, std::complex<float> b)
+{
+  return fabs(std::arg(a * std::conj(b))); 
+}
+
+int main(int argc, char * argv[])
+{
+  unsigned long testcount = 1000000000UL;
+  double freq = 102.3456e3;
+  double fsamp = 625e3; 
+  if(argc > 1) testcount = strtoul(argv[1], NULL, 0);
+  if(argc > 2) freq = atof(argv[2]); 
+
+  const unsigned int blen = 30000; 
+  std::complex<float> * vblk = new std::complex<float>[blen];
+  std::complex<float> * vscl = new std::complex<float>[blen];
+
+  double pincr = 2.0 * M_PI * freq / fsamp; 
+  SoDa::QuadratureOscillator blk_osc, scl_osc;
+  blk_osc.setPhaseIncr(pincr);
+  scl_osc.setPhaseIncr(pincr);
+
+  float max_err = 0.0, max_blk_exact = 0.0, max_scl_exact = 0.0, max_mag_err = 0.0; 
+  double blk_time = 0.0, scl_time = 0.0; 
+  unsigned long done, i;
+  
+  for(done = 0; done < testcount; done += blen) {
+    unsigned int len = ((testcount - done) < blen) ? (testcount - done) : blen;
+
+    double t0 = curTime();
+    blk_osc.fill(vblk, len); 
+    double t1 = curTime();
+    for(i = 0; i < len; i++) vscl[i] = scl_osc.stepOscCF();
+    double t2 = curTime();
+    blk_time += t1 - t0;
+    scl_time += t2 - t1;
+
+    for(i = 0; i < len; i++) {
+      // check against the exact value every so often -- this is slow. 
+      // (Don't accumulate the exact phase -- the rounding error adds
+      // up to 1e-4 radians over 1e8 samples.)
+      if((i & 0xff) == 0) {
+	long double ph = fmodl(((long double) pincr) * ((long double) (done + i + 1)), 2.0L * M_PI); 
+	std::complex<float> ex((float) cosl(ph), (float) -sinl(ph));
+	float be = phaseErr(vblk[i], ex);
+	float se = phaseErr(vscl[i], ex);
+	if(be > max_blk_exact) max_blk_exact = be;
+	if(se > max_scl_exact) max_scl_exact = se;
+      }
+      float e = phaseErr(vblk[i], vscl[i]);
+      if(e > max_err) max_err = e;
+      float me = fabs(std::abs(vblk[i]) - 1.0);
+      if(me > max_mag_err) max_mag_err = me; 
+    }
+  }
+
+  // now make sure mix agrees with fill
+  SoDa::QuadratureOscillator mix_osc, fill_osc;
+  mix_osc.setPhaseIncr(pincr);
+  fill_osc.setPhaseIncr(pincr);
+  float max_mix_err = 0.0;
+  for(i = 0; i < blen; i++) vscl[i] = std::complex<float>(cos(0.001 * i), 0.5 * sin(0.0007 * i));
+  for(int pass = 0; pass < 10; pass++) {
+    unsigned int len = blen - 7 * pass; // odd lengths too
+    fill_osc.fill(vblk, len);
+    for(i = 0; i < len; i++) vblk[i] = vblk[i] * vscl[i];
+    mix_osc.mix(vscl, vscl, len);
+    for(i = 0; i < len; i++) {
+      float e = std::abs(vblk[i] - vscl[i]);
+      if(e > max_mix_err) max_mix_err = e;
+    }
+    for(i = 0; i < blen; i++) vscl[i] = std::complex<float>(cos(0.001 * i), 0.5 * sin(0.0007 * i));
+  }
+
+  printf("%lu samples at %g Hz / %g S/s\n", testcount, freq, fsamp);
+  printf("max phase error block vs scalar    %g rad\n", max_err);
+  printf("max phase error block vs exact     %g rad\n", max_blk_exact);
+  printf("max phase error scalar vs exact    %g rad\n", max_scl_exact);
+  printf("max magnitude error (block)        %g\n", max_mag_err);
+  printf("max mix vs fill error              %g\n", max_mix_err); 
+  printf("block  %6.2f nS/sample\n", 1e9 * blk_time / ((double) testcount));
+  printf("scalar %6.2f nS/sample\n", 1e9 * scl_time / ((double) testcount));
+
+  bool pass = (max_err < 1.0e-5) && (max_blk_exact < 1.0e-5) && (max_mag_err < 1.0e-5) && (max_mix_err < 1.0e-5); 
+  std::cout << (pass ? "PASS" : "FAIL") << std::endl;
+  return pass ? 0 : -1; 
+}
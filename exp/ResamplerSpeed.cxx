@@ -46,29 +46,86 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <sys/time.h>
 
 
+double curTime()
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return ((double) tv.tv_sec) + 1.0e-6 * ((double) tv.tv_usec); 
+}
+
+/**
+ * run a resampler over itercount 30000 sample buffers and 
+ * report the throughput
+ */
+template<typename RS> double timeResampler(const char * name, RS & rs, 
+					   std::complex<float> * cin, std::complex<float> * cout,
+					   int itercount)
+{
+  int i;
+  double start = curTime();
+  for(i = 0; i < itercount; i++) {
+    rs.apply(cin + ((i & 1) * 30000), cout, 30000, 2304);
+  }
+  double elapsed = curTime() - start;
+  double msps = 30000.0 * ((double) itercount) / (elapsed * 1.0e6);
+  printf("%-28s %8.2f uS/buffer  %8.2f MS/s  (%6.1f x realtime)\n",
+	 name, 1.0e6 * elapsed / ((double) itercount), msps, msps / 0.625);
+  return elapsed; 
+}
+
+// the FFT resampler has a different interface
+struct FFTResampler {
+  FFTResampler() : rs(30000) { }
+  void apply(std::complex<float> * in, std::complex<float> * out, int inlen, int outlen) {
+    rs.apply(in, out); 
+  }
+  SoDa::ReSample625to48 rs;
+};
+
+/**
+ * Usage: ResamplerSpeed [t|s|f] [itercount]
+ *   t -- TDResampler625x48 (four passes over each buffer)
+ *   s -- TDStreamResampler625x48 (tiles through all four stages)
+ *   f -- the FFT based ReSample625to48
+ * With no selector, run them all and compare. 
+ */
 int main(int argc, char * argv[])
 {
   int itercount = 5000;
-  std::complex<float> cin[60000], cout[2304];
+  static std::complex<float> cin[60000], cout[2304], sout[2304];
   int i; 
-  double ang; 
+  double ang = 0.0; 
   for(i = 0; i < 60000; i++) {
     cin[i] = std::complex<float>(sin(ang), cos(ang)); 
     ang += 0.01;
   }
+
+  char sel = 'a'; 
+  if(argc > 1) sel = argv[1][0];
+  if(argc > 2) itercount = atoi(argv[2]); 
  
   SoDa::TDResampler625x48<std::complex<float> >  rs625x48; 
-  SoDa::ReSample625to48 rsc(30000);
+  SoDa::TDStreamResampler625x48<std::complex<float> >  srs625x48; 
 
-  if((argc < 2) || (argv[0][0] == 't')) {
-    for(i = 0; i < itercount; i++) {
-      rs625x48.apply(cin, cout, 30000, 2304);
-    }
+  double t_td = 0.0, t_st = 0.0; 
+  if((sel == 'a') || (sel == 't')) {
+    t_td = timeResampler("TDResampler625x48", rs625x48, cin, cout, itercount); 
+  }
+  if((sel == 'a') || (sel == 's')) {
+    t_st = timeResampler("TDStreamResampler625x48", srs625x48, cin, sout, itercount); 
   }
-  else {
-    for(i = 0; i < itercount; i++) {
-      rsc.apply(cin, cout);
+  if((sel == 'a') || (sel == 'f')) {
+    FFTResampler rsc;
+    timeResampler("ReSample625to48 (FFT)", rsc, cin, cout, itercount); 
+  }
+
+  if(sel == 'a') {
+    // both TD resamplers saw the same input, so the last outputs should match.
+    float maxdiff = 0.0; 
+    for(i = 0; i < 2304; i++) {
+      float d = std::abs(cout[i] - sout[i]);
+      if(d > maxdiff) maxdiff = d; 
     }
+    printf("streaming speedup %6.2f  max output difference %g\n", t_td / t_st, maxdiff); 
   }
 }
-
@@ -0,0 +1,123 @@
+/*
+  Copyright (c) 2026, Matthew H. Reilly (kb1vc)
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+  Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in
+  the documentation and/or other materials provided with the
+  distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * Key the transmitter in CW with nothing queued, let it idle, then
+ * queue some envelope buffers and make sure USRPTX picks it up without any
+ * further commands.  (USRPTX used to go to sleep on its wait set when
+ * it ran out of text, and only woke up for the next command.)
+ *
+ * This transmits -- put a dummy load on the TX port.  The TX gain is
+ * set to zero.
+ *
+ * Usage: USRPTX_CW_Test [--uhdargs <args>]
+ */
+
+#include "../src/USRPTX.hxx"
+#include <uhd/usrp/multi_usrp.hpp>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+
+bool waitForTXState(SoDa::CmdMBox & cmd_stream, int subs, int state)
+{
+  for(int i = 0; i < 2000; i++) {
+    SoDa::Command * cmd;
+    while((cmd = cmd_stream.get(subs)) != NULL) {
+      bool match = (cmd->cmd == SoDa::Command::REP) &&
+	(cmd->target == SoDa::Command::TX_STATE) &&
+	(cmd->iparms[0] == state);
+      cmd_stream.free(cmd);
+      if(match) return true; 
+    }
+    usleep(1000);
+  }
+  return false; 
+}
+
+int main(int argc, char ** argv)
+{
+  SoDa::Params params(argc, argv);
+  SoDa::BufArena::configure(params.getRFBufferSize(), 0, false);
+
+  uhd::usrp::multi_usrp::sptr usrp = uhd::usrp::multi_usrp::make(params.getRadioArgs());
+  usrp->set_tx_rate(params.getTXRate());
+  usrp->set_tx_gain(0.0);
+
+  SoDa::CmdMBox cmd_stream(true);
+  SoDa::DatMBox tx_stream(true), cw_env_stream(true);
+
+  SoDa::USRPTX tx(&params, usrp);
+  tx.subscribeToMailBox("CMD", &cmd_stream);
+  tx.subscribeToMailBox("TX", &tx_stream);
+  tx.subscribeToMailBox("CW_ENV", &cw_env_stream);
+  int rep_subs = cmd_stream.subscribe();
+
+  tx.start();
+
+  // key up in CW, with nothing to send.
+  cmd_stream.put(cmd_stream.make(SoDa::Command::SET, SoDa::Command::TX_MODE, (int) SoDa::Command::CW_U));
+  cmd_stream.put(cmd_stream.make(SoDa::Command::SET, SoDa::Command::TX_STATE, 3));
+  bool ok = waitForTXState(cmd_stream, rep_subs, 1);
+  if(!ok) std::cerr << "USRPTX didn't report TX on\n";
+
+  // let it run dry for a while
+  usleep(500000);
+
+  // now queue a second's worth of key-down envelope -- no commands
+  // from here on. 
+  unsigned int buf_len = params.getRFBufferSize();
+  unsigned int queued = (unsigned int) (params.getTXRate() / ((double) buf_len)); 
+  for(unsigned int i = 0; i < queued; i++) {
+    SoDa::Buf * env = cw_env_stream.allocOrNew(buf_len);
+    float * e = env->getFloatBuf(); 
+    for(unsigned int j = 0; j < buf_len; j++) e[j] = 1.0;
+    cw_env_stream.put(env);
+  }
+
+  int ms; 
+  for(ms = 0; (ms < 4000) && (cw_env_stream.inFlightCount() != 0); ms++) {
+    usleep(1000);
+  }
+  unsigned int left = cw_env_stream.inFlightCount(); 
+  if(left != 0) {
+    std::cerr << "USRPTX sent " << (queued - left) << " of " << queued
+	      << " CW envelope buffers queued after running dry\n";
+    ok = false;
+  }
+  else {
+    std::cerr << "USRPTX sent all " << queued << " CW envelope buffers in " << ms << " mS\n";
+  }
+
+  cmd_stream.put(cmd_stream.make(SoDa::Command::SET, SoDa::Command::TX_STATE, 2));
+  cmd_stream.put(cmd_stream.make(SoDa::Command::SET, SoDa::Command::STOP, 0));
+  tx.join();
+
+  std::cout << (ok ? "PASSED" : "FAILED") << std::endl; 
+  return ok ? 0 : 1; 
+}
@@ -0,0 +1,198 @@
+/*
+  Copyright (c) 2026, Matthew H. Reilly (kb1vc)
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+  Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in
+  the documentation and/or other materials provided with the
+  distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * Check every VecOps kernel, for every kernel set this CPU can run,
+ * against the SCALAR kernels.  The lengths include odd ones, so the
+ * one-at-a-time tail of each vector kernel gets exercised too.
+ *
+ * Usage: VecOps_Test
+ */
+
+#include "../src/VecOps.hxx"
+#include <iostream>
+#include <vector>
+#include <stdlib.h>
+#include <math.h>
+
+typedef std::vector<std::complex<float> > CVec;
+typedef std::vector<float> FVec;
+
+// what each kernel produced for one input length
+struct Results {
+  CVec cmul_scale, cmul_scale_inplace, cmul_real;
+  FVec mag_sq_acc, exp_avg, fm_disc, mag, ssb, db;
+  float dot_real;
+  std::complex<float> dot_cplx_real, dot_cplx, fm_prev;
+  float mag_sum, sum_sq, peak;
+};
+
+void fillC(CVec & v, unsigned int len)
+{
+  v.resize(len);
+  for(auto & x : v) {
+    x = std::complex<float>(((float) random() / RAND_MAX) - 0.5,
+			    ((float) random() / RAND_MAX) - 0.5);
+  }
+}
+
+void fillF(FVec & v, unsigned int len, float lo, float hi)
+{
+  v.resize(len);
+  for(auto & x : v) x = lo + (hi - lo) * ((float) random() / RAND_MAX);
+}
+
+// run every kernel with whatever kernel set is in force
+Results runKernels(const CVec & a, const CVec & b, const FVec & w, const FVec & acc_in, const FVec & pwr)
+{
+  unsigned int len = a.size();
+  Results r;
+  r.cmul_scale.resize(len);
+  SoDa::VecOps::cmulScale(r.cmul_scale.data(), a.data(), b.data(), 0.25, len);
+  r.cmul_scale_inplace = a;
+  SoDa::VecOps::cmulScale(r.cmul_scale_inplace.data(), r.cmul_scale_inplace.data(), b.data(), 2.0, len);
+  r.cmul_real.resize(len);
+  SoDa::VecOps::cmulReal(r.cmul_real.data(), a.data(), w.data(), len);
+  r.mag_sq_acc = acc_in;
+  SoDa::VecOps::magSqAcc(r.mag_sq_acc.data(), a.data(), 0.5, len);
+  r.exp_avg = acc_in;
+  SoDa::VecOps::expAvg(r.exp_avg.data(), w.data(), 0.9, len);
+  r.dot_real = SoDa::VecOps::dot(w.data(), acc_in.data(), len);
+  r.dot_cplx_real = SoDa::VecOps::dot(a.data(), w.data(), len);
+  r.dot_cplx = SoDa::VecOps::dot(a.data(), b.data(), len);
+  r.fm_disc.resize(len);
+  r.fm_prev = std::complex<float>(1.0, 0.0);
+  SoDa::VecOps::fmDisc(r.fm_disc.data(), a.data(), r.fm_prev, 0.5, len);
+  r.mag.resize(len);
+  r.mag_sum = SoDa::VecOps::mag(r.mag.data(), a.data(), 3.0, len);
+  r.ssb.resize(len);
+  SoDa::VecOps::ssbCombine(r.ssb.data(), a.data(), -1.0, len);
+  r.sum_sq = SoDa::VecOps::sumSqPeak(w.data(), len, r.peak);
+  r.db.resize(len);
+  SoDa::VecOps::dB(r.db.data(), pwr.data(), 0.05, len);
+  return r;
+}
+
+// largest |x - y| relative to the largest |y| (or absolute, if y is small)
+template<typename T> float maxErr(const std::vector<T> & x, const std::vector<T> & y)
+{
+  float err = 0.0, mag = 1.0;
+  for(unsigned int i = 0; i < y.size(); i++) {
+    mag = (std::abs(y[i]) > mag) ? std::abs(y[i]) : mag;
+  }
+  for(unsigned int i = 0; i < y.size(); i++) {
+    float d = std::abs(x[i] - y[i]);
+    err = (d > err) ? d : err;
+  }
+  return err / mag;
+}
+
+// largest |x - y|
+float absErr(const FVec & x, const FVec & y)
+{
+  float err = 0.0;
+  for(unsigned int i = 0; i < y.size(); i++) {
+    float d = fabs(x[i] - y[i]);
+    err = (d > err) ? d : err;
+  }
+  return err;
+}
+
+template<typename T> float relErr(T x, T y)
+{
+  float mag = (std::abs(y) > 1.0) ? std::abs(y) : 1.0;
+  return std::abs(x - y) / mag;
+}
+
+bool check(const std::string & name, float err, float tol)
+{
+  if(err <= tol) return true;
+  std::cout << "    " << name << " error " << err << " (limit " << tol << ")  *** FAILED ***\n";
+  return false;
+}
+
+int main(int argc, char * argv[])
+{
+  unsigned int lens[] = { 1, 2, 3, 5, 7, 8, 15, 16, 17, 33, 1001, 2304, 30000 };
+
+  SoDa::VecOps::ISA isas[] = { SoDa::VecOps::SSE2, SoDa::VecOps::AVX2, SoDa::VecOps::NEON };
+
+  srandom(1234);
+  bool pass = true;
+  for(auto len : lens) {
+    CVec a, b;
+    FVec w, acc_in, pwr;
+    fillC(a, len);
+    fillC(b, len);
+    fillF(w, len, -1.0, 1.0);
+    fillF(acc_in, len, 0.0, 2.0);
+    // powers from 1e-20 to 1e15, and a zero, for the dB kernel
+    pwr.resize(len);
+    for(unsigned int i = 0; i < len; i++) {
+      pwr[i] = std::norm(a[i]) * powf(10.0, ((float) (i % 701)) * 0.05 - 20.0);
+    }
+    pwr[len / 2] = 0.0;
+
+    SoDa::VecOps::forceISA(SoDa::VecOps::SCALAR);
+    Results ref = runKernels(a, b, w, acc_in, pwr);
+
+    for(auto isa : isas) {
+      if(!SoDa::VecOps::supported(isa)) continue;
+      SoDa::VecOps::forceISA(isa);
+      Results res = runKernels(a, b, w, acc_in, pwr);
+
+      // the sums are taken in a different order, so allow a little
+      // more for the longer vectors.
+      float sum_tol = 1e-6 * sqrt((float) len) + 1e-6;
+      bool ok = true;
+      ok &= check("cmulScale", maxErr(res.cmul_scale, ref.cmul_scale), 1e-6);
+      ok &= check("cmulScale in place", maxErr(res.cmul_scale_inplace, ref.cmul_scale_inplace), 1e-6);
+      ok &= check("cmulReal", maxErr(res.cmul_real, ref.cmul_real), 1e-6);
+      ok &= check("magSqAcc", maxErr(res.mag_sq_acc, ref.mag_sq_acc), 1e-6);
+      ok &= check("expAvg", maxErr(res.exp_avg, ref.exp_avg), 1e-6);
+      ok &= check("dot real", relErr(res.dot_real, ref.dot_real), sum_tol);
+      ok &= check("dot complex/real", relErr(res.dot_cplx_real, ref.dot_cplx_real), sum_tol);
+      ok &= check("dot complex", relErr(res.dot_cplx, ref.dot_cplx), sum_tol);
+      ok &= check("fmDisc", maxErr(res.fm_disc, ref.fm_disc), 1e-5);
+      ok &= check("fmDisc prev", relErr(res.fm_prev, ref.fm_prev), 0.0);
+      ok &= check("mag", maxErr(res.mag, ref.mag), 1e-6);
+      ok &= check("mag sum", relErr(res.mag_sum, ref.mag_sum), sum_tol);
+      ok &= check("ssbCombine", maxErr(res.ssb, ref.ssb), 0.0);
+      ok &= check("sumSqPeak sum", relErr(res.sum_sq, ref.sum_sq), sum_tol);
+      ok &= check("sumSqPeak peak", relErr(res.peak, ref.peak), 0.0);
+      ok &= check("dB", absErr(res.db, ref.db), 1e-3);
+
+      std::cout << SoDa::VecOps::isaName(isa) << " len " << len
+		<< (ok ? "  ok" : "  *** FAILED ***") << "\n";
+      pass = pass && ok;
+    }
+  }
+
+  std::cout << (pass ? "PASS" : "FAIL") << "\n";
+  return pass ? 0 : -1;
+}
@@ -68,7 +68,7 @@ bool GUISoDa::AudioRXListener::init()
   // but not in a way that will hurt. 
   // slow radio vs. fast audio will trigger an under-run on occasion. 
   // we will recover in the audioOutputError handler. 
-  audio_cbuffer_p = new SoDa::CircularBuffer<char>(sample_rate * sizeof(float) * 10); 
+  audio_cbuffer_p = new SoDa::SPSCCircularBuffer<char>(sample_rate * sizeof(float) * 10); 
 
   // create the rx input buffer
   rx_in_buf_len = 16 * 1024; // bigger than the largest anticipated packet
@@ -105,24 +105,18 @@ bool GUISoDa::AudioRXListener::init()
 
 void GUISoDa::AudioRXListener::processRXAudio() {
   // we've got an incoming buffer. 
-  // copy it to the circular buffer.  (Note that this copy 
-  // is not the most time-efficient choice, but the simplicity
-  // and reduced bug count from this approach is compelling. 
-  // The total transfer load to/from this buffer is about 
-  // 400KB/sec.  The CircularBuffer object has been measured
-  // at way above 300MB/sec on a really old Intel desktop 
-  // (a 2010 edition i7). 
+  // read it straight from the socket into the circular buffer.
+  // The buffer is lock-free (one writer -- us -- and one reader --
+  // readData) so the audio device never waits on the socket. 
 
   qint64 len = audio_rx_socket->bytesAvailable();
 
+  // only move whole samples, so the buffer never splits a float
+  // across the wrap point.
+  len = wholeFloats(len);
   
   while(len > 0) {
-    // get the data from the socket
-    qint64 tlen = (len > rx_in_buf_len) ? rx_in_buf_len : len;
-    qint64 rlen = audio_rx_socket->read(rx_in_buf, tlen);
-
     if((status_update_count & 0x1f) == 0) {
-      float * fp = (float*) rx_in_buf;
       float delay;
       size_t num_elts = audio_cbuffer_p->numElements();
       delay = ((float) (num_elts / sizeof(float))) / ((float) sample_rate); 
@@ -136,15 +130,37 @@ void GUISoDa::AudioRXListener::processRXAudio() {
     }
     status_update_count++; 
 
-    if(rlen > 0) {
-      audio_cbuffer_p->put(rx_in_buf, rlen);
-      // send the buffer to anyone else who is listening. 
+    SoDa::SPSCCircularBuffer<char>::Span spans[2];
+    qint64 tlen = audio_cbuffer_p->acquireWrite(spans, len);
+    qint64 rlen = 0; 
+    if(tlen == 0) {
+      // the player is hopelessly behind -- drop this batch on
+      // the floor, but keep the recorder fed.
+      tlen = (len > rx_in_buf_len) ? rx_in_buf_len : len;
+      tlen = wholeFloats(tlen); 
+      rlen = audio_rx_socket->read(rx_in_buf, tlen);
+      if(rlen <= 0) return; 
       emit(pendAudioBuffer((float*) rx_in_buf, rlen / sizeof(float)));
-      len = len - rlen; 
     }
     else {
-      return; 
+      for(int i = 0; i < 2; i++) {
+	if(spans[i].len == 0) continue; 
+	qint64 got = audio_rx_socket->read(spans[i].ptr, spans[i].len);
+	if(got <= 0) break;
+	// send the samples to anyone else who is listening before
+	// the reader can see (and consume) them.
+	emit(pendAudioBuffer((float*) spans[i].ptr, got / sizeof(float)));
+	rlen += got;
+	if(got < (qint64) spans[i].len) break;
+      }
+      // we never ask for more than bytesAvailable, so a short read
+      // means the socket failed.  Even then, only whole floats go in
+      // the ring, or every sample after this one would be misaligned.
+      rlen = wholeFloats(rlen); 
+      if(rlen <= 0) return; 
+      audio_cbuffer_p->commitWrite(rlen);
     }
+    len = len - rlen; 
   }
 }
 
@@ -221,6 +237,9 @@ qint64 GUISoDa::AudioRXListener::readData(char * data, qint64 max_len)
   // a little bit. 
   size_t avail = audio_cbuffer_p->numElements();
 
+  // the ring holds whole floats -- keep it that way.
+  max_len = wholeFloats(max_len); 
+
   // Qt Audio under Mac doesn't go through ALSA, so is much better
   // behaved. It won't call readData if we have nothing to offer.
   // and will buffer what it gets. 
@@ -230,7 +249,7 @@ qint64 GUISoDa::AudioRXListener::readData(char * data, qint64 max_len)
     qInfo() << QString("[%3] Audio device attempts to read [%1] bytes, only [%2] available.")
       .arg(max_len).arg(avail).arg(QDateTime::currentDateTime().toString("HH:mm:ss.zzz t"));
     // stuff some silence in here.. 
-    qint64 fill_len = max_len >> 2; 
+    qint64 fill_len = wholeFloats(max_len >> 2); 
     memset(data, 0, fill_len); 
     return fill_len;
   }
@@ -141,6 +141,9 @@ namespace GUISoDa {
   
   private:
     void cleanBuffer();
+
+    /// round a byte count down to a whole number of samples
+    static qint64 wholeFloats(qint64 len) { return len - (len % sizeof(float)); }
     
     QString socket_basename; 
     QLocalSocket * audio_rx_socket;     
@@ -149,8 +152,9 @@ namespace GUISoDa {
     QScopedPointer<QAudioOutput> audioRX; 
     
     // the audio samples arrive as floats, but
-    // the packets move back and forth as bytes
-    SoDa::CircularBuffer<char> * audio_cbuffer_p;
+    // the packets move back and forth as bytes.
+    // processRXAudio is the only writer, readData the only reader.
+    SoDa::SPSCCircularBuffer<char> * audio_cbuffer_p;
 
     // we need a reasonably large input buffer for the 
     // rx socket interface. 
@@ -28,6 +28,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "soda_listener.hpp"
 #include <QDebug>
+#include <string.h>
 
 GUISoDa::Listener::Listener(QObject * parent, const QString & _socket_basename) : QObject(parent) {
   quit = false;
@@ -88,6 +89,12 @@ void GUISoDa::Listener::start()
 {
   put(SoDa::Command(SoDa::Command::GET, SoDa::Command::HWMB_REP));
   put(SoDa::Command(SoDa::Command::GET, SoDa::Command::TX_GAIN_RANGE));  
+  // 8 bit delta coded spectrum rows are about a twentieth the size of
+  // the float rows.  0.7 dB steps are finer than anybody can see
+  // on the waterfall.
+  put(SoDa::Command(SoDa::Command::SET, SoDa::Command::SPEC_ENCODING, 
+		    SoDa::SpectrumEncoding::UINT8, SoDa::SpectrumEncoding::DELTA_ROWS,
+		    -140, 180)); 
   return; 
 }
 
@@ -159,20 +166,27 @@ void GUISoDa::Listener::setupSpectrumBuffer(double cfreq, double span, long bufl
 
 void GUISoDa::Listener::processSpectrum() {
   unsigned int rlen = spect_buffer_len * sizeof(float);
-  while(((unsigned int) spect_socket->bytesAvailable()) > (sizeof(int) + rlen)) {
+  // rows are plain floats or encoded rows of varying length, 
+  // so wait until the whole row is here. 
+  while(((unsigned int) spect_socket->bytesAvailable()) >= sizeof(unsigned int)) {
     unsigned int len; 
+    spect_socket->peek((char*) & len, sizeof(unsigned int));
+    if(((unsigned int) spect_socket->bytesAvailable()) < (sizeof(unsigned int) + len)) break; 
     spect_socket->read((char*) & len, sizeof(unsigned int));
 
-    if(rlen != len) {
-      char * nbuf = new char[len];
-      // throw it away. 
-      spect_socket->read(nbuf, len); 
-      delete[] nbuf; 
+    if(spect_row.size() < len) spect_row.resize(len); 
+    spect_socket->read(spect_row.data(), len); 
+
+    if(SoDa::SpectrumDecoder::isEncoded(spect_row.data(), len)) {
+      if(spect_decoder.decode(spect_row.data(), len, spect_buffer, spect_buffer_len)) {
+	emit(updateData(spect_center_freq, spect_buffer)); 
+      }
     }
-    else {
-      spect_socket->read((char*) spect_buffer, rlen); 
+    else if((rlen == len) && (rlen != 0)) {
+      memcpy(spect_buffer, spect_row.data(), rlen); 
       emit(updateData(spect_center_freq, spect_buffer)); 
     }
+    // otherwise throw it away. 
   }
 }
 
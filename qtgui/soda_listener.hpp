@@ -34,6 +34,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <iostream>
 #include <errno.h>
 #include "../src/Command.hxx"
+#include "../src/SpectrumEncoding.hxx"
+#include <vector>
 
 namespace GUISoDa {
   
@@ -154,6 +156,8 @@ namespace GUISoDa {
     long spect_buffer_len;
     float * spect_buffer; 		      
     double spect_center_freq; 				    
+    std::vector<char> spect_row; ///< the row as it came off the socket
+    SoDa::SpectrumDecoder spect_decoder; 
 			  
   protected slots:  
     void processCmd();
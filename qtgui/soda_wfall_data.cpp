@@ -27,6 +27,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "soda_wfall_data.hpp"
+#include <string.h>
 #include <iostream>
 
 GUISoDa::WFallData::WFallData() {
@@ -68,7 +69,7 @@ void GUISoDa::WFallData::setSpectrumDimensions(double cfreq, double span, long b
   }
   if(heatmap == NULL) {
     heatmap_size = buckets * num_rows;     
-    heatmap = new double[heatmap_size];
+    heatmap = new float[heatmap_size];
   }
   
   num_buckets = buckets; 
@@ -166,9 +167,6 @@ void GUISoDa::WFallData::updateData(double cfreq, float * spect) {
     cur_freq_idx = 0; 
   }
   
-  double * vec = heatmap + cur_row_idx; 
-  for(int i = 0; i < num_buckets; i++) {
-    vec[i] = spect[i]; 
-  }
+  memcpy(heatmap + cur_row_idx, spect, num_buckets * sizeof(float)); 
   start_freq[cur_freq_idx] = cfreq - 0.5 * span_in_freq; 
 }
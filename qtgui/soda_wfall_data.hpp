@@ -75,7 +75,8 @@ namespace GUISoDa {
     // such that
     // heatmap[i * num_buckets] is the start of the scan for a sample between
     // start_freq[i] and start_freq[i] + span_in_freq
-    double *heatmap;
+    // (The rows come from the radio with well under float precision.)
+    float *heatmap;
     long heatmap_size; 
     double *start_freq;  ///< for each row in the heat map, this is the centerfreq. 
     long num_buckets, num_rows; 
@@ -28,6 +28,7 @@
 
 #include "BaseBandRX.hxx"
 #include "OSFilter.hxx"
+#include "VecOps.hxx"
 #include <fstream>
 #include <stdio.h>
 #include <fcntl.h>
@@ -60,11 +61,14 @@ SoDa::BaseBandRX::BaseBandRX(Params * params,
   buildFilterMap();
 
   // build the resamplers
-  rf_resampler = new SoDa::TDResampler625x48<std::complex<float> >(150000.0);
-  wbfm_resampler = new SoDa::TDResampler625x48<float>(1.0);  
+  rf_resampler = new SoDa::TDStreamResampler625x48<std::complex<float>, SoDa::TDTranslatingDecimator>(150000.0);
+  mix_buf = new std::complex<float>[rf_buffer_size];
+  wbfm_resampler = new SoDa::TDStreamResampler625x48<float>(1.0);  
 
   af_filter_selection = SoDa::Command::BW_6000;
   cur_audio_filter = filter_map[af_filter_selection];
+  cur_lsb_filter = lsb_filter_map[af_filter_selection];
+  cur_usb_filter = usb_filter_map[af_filter_selection];
 
   
   // initial af gain
@@ -89,11 +93,8 @@ SoDa::BaseBandRX::BaseBandRX(Params * params,
       pendAudioBuffer(sidetone_silence); 
     }
   }
-  // create hilbert transformer
-  hilbert = new SoDa::HilbertTransformer(audio_buffer_size);
-
-  // initialize the sample for the NBFM and WBFM demodulator
-  last_phase_samp = 0.0;
+  // initialize the sample for the NBFM and WBFM demodulator (phase 0)
+  last_fm_samp = std::complex<float>(1.0, 0.0);
 
   // setup the catchup mechanism that adjusts to differences
   // between the radio's clock frequency and the sound system's clock
@@ -140,23 +141,18 @@ SoDa::BaseBandRX::BaseBandRX(Params * params,
   // start with initial hang count of 0 (haven't broken squelch yet)
 }
 
-void SoDa::BaseBandRX::demodulateWBFM(SoDa::Buf * rxbuf, SoDa::Command::ModulationType mod, float af_gain)
+void SoDa::BaseBandRX::demodulateWBFM(std::complex<float> * dbuf, SoDa::Command::ModulationType mod, float af_gain)
 {
   (void) mod;
   // now allocate a new audio buffer from the buffer ring
   float * audio_buffer = bpool->getBuffer();
   float demod_out[rf_buffer_size];
-  unsigned int i;
-
-  std::complex<float> * dbuf = rxbuf->getComplexBuf();
 
   // Interestingly, arctan based demodulation (see Lyons p 486 for instance)
   // performs much better than the approximation that avoids the atan call.
-  // Texts that talk about atan generally don't talk about the problem of
-  // rollover, where the sign changes from atan(samp[n]) and atan(samp[n+1]).
-  // In this case, dphase will be much bigger than M_PI, and it should be
-  // "corrected".  We're really trying to find the angular diference between
-  // samples, so the wraparound is important. 
+  // We take the angle of samp[n] * conj(samp[n-1]) -- the angular
+  // difference between samples -- so there's no rollover to correct.
+  // (VecOps uses a polynomial atan, which is plenty accurate.)
 
   // broadcast FM has a deviation of +/- 75 kHz or so.  At a sampling
   // rate of 625kHz, we'd see a maximum angle advance, assuming zero-beat, of
@@ -166,16 +162,7 @@ void SoDa::BaseBandRX::demodulateWBFM(SoDa::Buf * rxbuf, SoDa::Command::Modulati
   // for a moderately strong signal.  So, we make the angle even larger.
   // much much larger... 
   float recip_max_phase_diff = 32.0 / (M_PI * 75.0e3 / rf_sample_rate); 
-  for(i = 0; i < rf_buffer_size; i++) {
-    // do the atan demod
-    // measure the phase of the incoming signal.
-    float phase = arg(dbuf[i]);
-    float dphase = phase - last_phase_samp;
-    if(dphase < -M_PI) dphase += 2.0 * M_PI;
-    if(dphase > M_PI) dphase -= 2.0 * M_PI;
-    demod_out[i] = recip_max_phase_diff * dphase; 
-    last_phase_samp = phase; 
-  }
+  SoDa::VecOps::fmDisc(demod_out, dbuf, last_fm_samp, recip_max_phase_diff, rf_buffer_size);
   // now downsample it
   wbfm_resampler->apply(demod_out, audio_buffer, rf_buffer_size, audio_buffer_size);
   // do a median filter to eliminate the pops.
@@ -192,39 +179,28 @@ void SoDa::BaseBandRX::demodulateNBFM(std::complex<float> * dbuf, SoDa::Command:
   // now allocate a new audio buffer from the buffer ring
   float * audio_buffer = bpool->getBuffer();
   std::complex<float> demod_out[audio_buffer_size];
+  float dphase[audio_buffer_size]; 
 
   // First we need to band-limit the input RF -- modulation width is about 12.5kHz,
   // so the filter should be a 12.5kHz LPF. 
   
-  // Interestingly, arctan based demodulation (see Lyons p 486 for instance)
-  // performs much better than the approximation that avoids the atan call.
-  // Texts that talk about atan generally don't talk about the problem of
-  // rollover, where the sign changes from atan(samp[n]) and atan(samp[n+1]).
-  // In this case, dphase will be much bigger than M_PI, and it should be
-  // "corrected".  We're really trying to find the angular diference between
-  // samples, so the wraparound is important. 
+  // atan demod, as in demodulateWBFM.
   unsigned int i; 
-  float amp_sum = 0.0;
   // NB FM has a deviation of +/- 6.25 kHz or so.  At a sampling
   // rate of 625kHz, we'd see a maximum angle advance, assuming zero-beat, of
   // pi * 6.25 / 312.5
   // As with WBFM, we goose the gain a bit 
   float recip_max_phase_diff = 4.0 / (M_PI * 6.25e3 / rf_sample_rate); 
-  
+  SoDa::VecOps::fmDisc(dphase, dbuf, last_fm_samp, recip_max_phase_diff, audio_buffer_size);
   for(i = 0; i < audio_buffer_size; i++) {
-    // do the atan demod
-    // measure the phase of the incoming signal.
-    float phase = arg(dbuf[i]);
-    float dphase = phase - last_phase_samp;
-    if(dphase < -M_PI) dphase += 2.0 * M_PI;
-    if(dphase > M_PI) dphase -= 2.0 * M_PI;
-    demod_out[i] = recip_max_phase_diff * dphase;     
-    last_phase_samp = phase; 
-    // measure the amplitude of the incoming signal.
-    // measure it over a period of one buffer's worth. 
-    amp_sum += abs(dbuf[i]);
+    demod_out[i] = dphase[i];
   }
 
+  // measure the amplitude of the incoming signal over a period of
+  // one buffer's worth.  (The magnitudes land in audio_buffer, which
+  // we overwrite below.)
+  float amp_sum = SoDa::VecOps::mag(audio_buffer, dbuf, 1.0, audio_buffer_size);
+
   // now look at the magnitude and compare it to the threshold
 
   if(amp_sum > nbfm_squelch_level) {
@@ -254,15 +230,12 @@ void SoDa::BaseBandRX::demodulateSSB(std::complex<float> * dbuf, SoDa::Command::
   // now allocate a new audio buffer from the buffer ring
   float * audio_buffer = bpool->getBuffer();
 
-  // shift the Q channel by pi/2
-  // note that this hilbert filter transforms the Q channel and delays the I channel
-  hilbert->applyIQ(dbuf, dbuf); 
-
-  // then add/subtract I/Q to a single real channel
-  float sbmul = ((mod == SoDa::Command::LSB) || (mod == SoDa::Command::CW_L)) ? 1.0 : -1.0;
-  unsigned int i; 
+  // the sideband filter (see demodulate) has already shifted the Q
+  // channel by pi/2 and added/subtracted it from the I channel. 
+  (void) mod; 
+  unsigned int i;
   for(i = 0; i < audio_buffer_size; i++) {
-    audio_buffer[i] = (float) (dbuf[i].real() + sbmul * dbuf[i].imag()); 
+    audio_buffer[i] = dbuf[i].real(); 
   }
   // then send it to the audio port.
   pendAudioBuffer(audio_buffer);
@@ -273,16 +246,8 @@ void SoDa::BaseBandRX::demodulateAM(std::complex<float> * dbuf)
   // now allocate a new audio buffer from the buffer ring
   float * audio_buffer = bpool->getBuffer();
 
-  unsigned int i;
-  float maxval = 0.0;
-  float sumsq = 0.0; 
-  for(i = 0; i < audio_buffer_size; i++) {
-    float v = 0.5 * abs(dbuf[i]);
-    if(v > maxval) maxval = v; 
-    sumsq += v * v; 
-    audio_buffer[i] = v; 
-  }
-  sumsq = sqrt(sumsq / ((float) audio_buffer_size));
+  // envelope detector
+  SoDa::VecOps::mag(audio_buffer, dbuf, 0.5, audio_buffer_size);
   // audio is biased above DC... it really really needs to get its DC component removed. 
   am_audio_filter->apply(audio_buffer, audio_buffer); 
 
@@ -297,23 +262,27 @@ void SoDa::BaseBandRX::demodulate(SoDa::Buf * rxbuf)
   std::complex<float> dbufo[audio_buffer_size]; 
   // Note that audio_buffer_size must be (sample_length / decimation rate)
   
-  if((rx_modulation != SoDa::Command::WBFM) && (rx_modulation != SoDa::Command::NBFM)) {
+  if(rx_modulation != SoDa::Command::WBFM) {
     rf_resampler->apply(rxbuf->getComplexBuf(), dbufi, rf_buffer_size, audio_buffer_size);
     
     // now do the low pass filter
     if(rx_modulation == SoDa::Command::AM) {
       am_pre_filter->apply(dbufi, dbufo, *cur_af_gain); 
     }
+    else if(rx_modulation == SoDa::Command::NBFM) {
+      // bandpass the channel down to about 25 kHz wide.  The
+      // resampler passes all of that, so we can do this at the
+      // audio rate instead of the RF rate. 
+      nbfm_pre_filter->apply(dbufi, dbufo, 1.0);
+    }
     else {
-      cur_audio_filter->apply(dbufi, dbufo, *cur_af_gain);
+      // SSB and CW -- the audio filter and the sideband selector
+      // are folded into one filter. 
+      SoDa::OSFilter * sb_filter = ((rx_modulation == SoDa::Command::LSB) || 
+				    (rx_modulation == SoDa::Command::CW_L)) ? cur_lsb_filter : cur_usb_filter;
+      sb_filter->apply(dbufi, dbufo, *cur_af_gain);
     }
   }
-  else if(rx_modulation == SoDa::Command::NBFM) {
-    // first, bandpass the RF down to about 25 kHz wide...
-    std::complex<float> * rfbuf = rxbuf->getComplexBuf();
-    nbfm_pre_filter->apply(rfbuf, rfbuf, 1.0);
-    rf_resampler->apply(rfbuf, dbufo, rf_buffer_size, audio_buffer_size);
-  }
 
  
   switch(rx_modulation) {
@@ -329,7 +298,7 @@ void SoDa::BaseBandRX::demodulate(SoDa::Buf * rxbuf)
     demodulateNBFM(dbufo, SoDa::Command::NBFM, *cur_af_gain);
     break; 
   case SoDa::Command::WBFM:
-    demodulateWBFM(rxbuf, SoDa::Command::NBFM, *cur_af_gain);
+    demodulateWBFM(mixRF(rxbuf), SoDa::Command::NBFM, *cur_af_gain);
     break; 
   case SoDa::Command::AM:
     demodulateAM(dbufo); 
@@ -341,25 +310,42 @@ void SoDa::BaseBandRX::demodulate(SoDa::Buf * rxbuf)
   }
 }
 
+std::complex<float> * SoDa::BaseBandRX::mixRF(SoDa::Buf * rxbuf)
+{
+  IF_osc.mix(rxbuf->getComplexBuf(), mix_buf, rf_buffer_size);
+  return mix_buf; 
+}
+
+void SoDa::BaseBandRX::set3rdLOFreq(double IF_tuning)
+{
+  // calculate the advance of phase for the IF
+  // oscilator in terms of radians per sample
+  double phase_incr = IF_tuning * 2.0 * M_PI / rf_sample_rate; 
+  IF_osc.setPhaseIncr(phase_incr);
+  rf_resampler->setPhaseIncr(phase_incr); 
+  debugMsg(SoDa::Format("Changed 3rdLO to freq = %0\n")
+	   .addF(IF_tuning, 10, 6, 'e'));
+}
+
 void SoDa::BaseBandRX::repAFFilterShape() {
   std::pair<double, double> fshape = cur_audio_filter->getFilterEdges();  
   switch (rx_modulation) {
   case SoDa::Command::USB:
   case SoDa::Command::CW_U:
-      cmd_stream->put(new Command(Command::REP, Command::RX_AF_FILTER_SHAPE, 
+      cmd_stream->put(cmd_stream->make(Command::REP, Command::RX_AF_FILTER_SHAPE, 
 				  fshape.first, fshape.second));
       break; 
   case SoDa::Command::LSB:
   case SoDa::Command::CW_L:
-      cmd_stream->put(new Command(Command::REP, Command::RX_AF_FILTER_SHAPE, 
+      cmd_stream->put(cmd_stream->make(Command::REP, Command::RX_AF_FILTER_SHAPE, 
 				  -fshape.first, -fshape.second));
       break; 
   case SoDa::Command::AM:
-      cmd_stream->put(new Command(Command::REP, Command::RX_AF_FILTER_SHAPE, 
+      cmd_stream->put(cmd_stream->make(Command::REP, Command::RX_AF_FILTER_SHAPE, 
 				  -fshape.second, fshape.second));
       break; 
   default:
-      cmd_stream->put(new Command(Command::REP, Command::RX_AF_FILTER_SHAPE, 
+      cmd_stream->put(cmd_stream->make(Command::REP, Command::RX_AF_FILTER_SHAPE, 
 				  -100, 100));
     
   }
@@ -413,34 +399,38 @@ void SoDa::BaseBandRX::execSetCommand(SoDa::Command * cmd)
   case SoDa::Command::RX_AF_FILTER: // set af filter bw.
     fbw = (SoDa::Command::AudioFilterBW) cmd->iparms[0];
     if(filter_map.find(fbw) != filter_map.end()) {
-      cur_audio_filter = filter_map[fbw];
       af_filter_selection = fbw; 
     }
     else {
       // if unsupported -- use widest. 
-      cur_audio_filter = filter_map[SoDa::Command::BW_6000]; 
       af_filter_selection = SoDa::Command::BW_6000;
     }
+    cur_audio_filter = filter_map[af_filter_selection];
+    cur_lsb_filter = lsb_filter_map[af_filter_selection];
+    cur_usb_filter = usb_filter_map[af_filter_selection];
     {
-      cmd_stream->put(new Command(Command::REP, Command::RX_AF_FILTER, 
+      cmd_stream->put(cmd_stream->make(Command::REP, Command::RX_AF_FILTER, 
 				  af_filter_selection));
       repAFFilterShape();
     }
     break; 
   case SoDa::Command::RX_AF_GAIN: // set audio gain. 
     af_gain = powf(10.0, 0.25 * (cmd->dparms[0] - 50.0));
-    cmd_stream->put(new Command(Command::REP, Command::RX_AF_GAIN, 
+    cmd_stream->put(cmd_stream->make(Command::REP, Command::RX_AF_GAIN, 
 				50. + 4.0 * log10(af_gain)));
     break; 
   case SoDa::Command::RX_AF_SIDETONE_GAIN: // set audio gain. 
     af_sidetone_gain = powf(10.0, 0.25 * (cmd->dparms[0] - 50.0));
     // we send out reports for hamlib and other listeners...
-    cmd_stream->put(new Command(Command::REP, Command::RX_AF_SIDETONE_GAIN, 
+    cmd_stream->put(cmd_stream->make(Command::REP, Command::RX_AF_SIDETONE_GAIN, 
 				50. + 4.0 * log10(af_sidetone_gain)));
     break;
   case SoDa::Command::NBFM_SQUELCH:
     nbfm_squelch_level = powf(10, 0.5 * cmd->dparms[0]) * ((float) audio_buffer_size);
     break; 
+  case SoDa::Command::RX_LO3_FREQ:
+    set3rdLOFreq(cmd->dparms[0]); 
+    break; 
   default:
     break; 
   }
@@ -450,11 +440,11 @@ void SoDa::BaseBandRX::execGetCommand(SoDa::Command * cmd)
 {
   switch (cmd->target) {
   case SoDa::Command::RX_AF_FILTER: // set af filter bw.
-    cmd_stream->put(new Command(Command::REP, Command::RX_AF_FILTER, 
+    cmd_stream->put(cmd_stream->make(Command::REP, Command::RX_AF_FILTER, 
 				af_filter_selection));
     break;
   case SoDa::Command::RX_AF_GAIN: // set af filter bw.
-    cmd_stream->put(new Command(Command::REP, Command::RX_AF_GAIN, 
+    cmd_stream->put(cmd_stream->make(Command::REP, Command::RX_AF_GAIN, 
 				50.0 + 4.0 * log10(af_gain)));
     break;
   case SoDa::Command::DBG_REP: // report status
@@ -482,6 +472,7 @@ void SoDa::BaseBandRX::run()
 {
   bool exitflag = false;
   SoDa::Buf * rxbuf;
+  SoDa::Buf * rxbufs[5];
   Command * cmd; 
 
   int trim_count = 0; 
@@ -498,6 +489,10 @@ void SoDa::BaseBandRX::run()
 			  this);	
   }
   
+  // sleep until there is a command or an rx buffer to look at
+  SoDa::WaitSet wait_set;
+  wait_set.add(cmd_stream, cmd_subs);
+  wait_set.add(rx_stream, rx_subs);
   
   while(!exitflag) {
     bool did_work = false;
@@ -512,9 +507,9 @@ void SoDa::BaseBandRX::run()
     }
 
     // now look for incoming buffers from the rx_stream. 
-    int bcount = 0; 
-    for(bcount = 0; (bcount < 5) && ((rxbuf = rx_stream->get(rx_subs)) != NULL); bcount++) {
-      if(rxbuf == NULL) break; 
+    unsigned int bcount = rx_stream->getBatch(rx_subs, rxbufs, 5);
+    for(unsigned int i = 0; i < bcount; i++) {
+      rxbuf = rxbufs[i];
       did_work = true; 
       // if we're in TX mode, we should just pend silence and ignore the incoming buffer
       // otherwise, demodulate it.
@@ -526,13 +521,13 @@ void SoDa::BaseBandRX::run()
       else {
 	pendNullBuffer();
       }
-      // now free the buffer up.
-      rx_stream->free(rxbuf); 
     }
+    // now free the buffers up.
+    rx_stream->freeBatch(rxbufs, bcount); 
 
 
     if(!did_audio_work && !did_work) {
-      usleep(1000); 
+      wait_set.wait(); 
       sleep_count++; 
     }
   }
@@ -574,9 +569,7 @@ void SoDa::BaseBandRX::pendAudioBuffer(float * b)
   }
 
   float al = 1.0e-19; // really small...
-  for(int i = 0; i < audio_buffer_size; i++) {
-    al += b[i] * b[i]; 
-  }
+  al += SoDa::VecOps::dot(b, b, audio_buffer_size); 
   audio_level = 10.0 * (log10(al / af_gain) - log_audio_buffer_size);
 
   bpool->freeBuffer(b);   
@@ -618,12 +611,22 @@ void SoDa::BaseBandRX::buildFilterMap()
   filter_map[SoDa::Command::BW_6000] = new SoDa::OSFilter(200.0, 300.0, 6300.0, 6400.0, 512, 1.0, audio_sample_rate, audio_buffer_size);
   filter_map[SoDa::Command::BW_PASS] = new SoDa::OSFilter(0.0, 10.0, 15000.0, 18000.0, 512, 1.0, audio_sample_rate, audio_buffer_size);
 
+  // SSB and CW fold the hilbert transform sideband selector into the audio filter
+  std::map<SoDa::Command::AudioFilterBW, SoDa::OSFilter *>::iterator fi;
+  for(fi = filter_map.begin(); fi != filter_map.end(); ++fi) {
+    lsb_filter_map[fi->first] = SoDa::HilbertTransformer::makeSSBFilter(true, fi->second, audio_buffer_size);
+    usb_filter_map[fi->first] = SoDa::HilbertTransformer::makeSSBFilter(false, fi->second, audio_buffer_size);
+    // the plain audio filters run on demodulated (real) audio
+    fi->second->planRealPath();
+  }
+
   fm_audio_filter = new SoDa::OSFilter(50.0, 100.0, 8000.0, 9000.0, 512, 1.0, audio_sample_rate, audio_buffer_size);
+  fm_audio_filter->planRealPath();
   am_audio_filter = filter_map[SoDa::Command::BW_6000]; 
 
   am_pre_filter = new SoDa::OSFilter(0.0, 0.0, 8000.0, 9000.0, 512, 1.0, audio_sample_rate, audio_buffer_size);
 
-  nbfm_pre_filter = new SoDa::OSFilter(0.0, 0.0, 12500.0, 14000.0, 512, 1.0, rf_sample_rate, rf_buffer_size);
+  nbfm_pre_filter = new SoDa::OSFilter(0.0, 0.0, 12500.0, 14000.0, 512, 1.0, audio_sample_rate, audio_buffer_size);
 
 }
 
@@ -631,7 +634,20 @@ void SoDa::BaseBandRX::buildFilterMap()
 void SoDa::BaseBandRX::subscribeToMailBox(const std::string & mbox_name, BaseMBox * mbox_p)
 {
   if(SoDa::connectMailBox<SoDa::CmdMBox>(this, cmd_stream, "CMD", mbox_name, mbox_p)) {
-    cmd_subs = cmd_stream->subscribe();
+    SoDa::MBoxFilter filt = Command::makeFilter({Command::NBFM_SQUELCH,
+	  Command::RX_AF_FILTER,
+	  Command::RX_AF_GAIN,
+	  Command::RX_AF_SIDETONE_GAIN,
+	  Command::RX_LO3_FREQ,
+	  Command::RX_MODE,
+	  Command::TX_MODE,
+	  Command::TX_STATE},
+      {Command::SET});
+    filt.merge(Command::makeFilter({Command::DBG_REP,
+	    Command::RX_AF_FILTER,
+	    Command::RX_AF_GAIN},
+	{Command::GET}));
+    cmd_subs = cmd_stream->subscribe(filt);
   }
   if(SoDa::connectMailBox<SoDa::DatMBox>(this, rx_stream, "RX", mbox_name, mbox_p)) {
     rx_subs = rx_stream->subscribe();
@@ -39,6 +39,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "AudioIfc.hxx"
 #include "MedianFilter.hxx"
 #include "BufferPool.hxx"
+#include "QuadratureOscillator.hxx"
 
 #include <queue>
 #include <mutex>
@@ -56,7 +57,9 @@ namespace SoDa {
    *
    * In most cases (all but Wide Band FM) the rx stream is downselected
    * by a 625 to 48 resampler before being passed through an audio filter
-   * and finally demodulated.
+   * and finally demodulated.  The 3rd LO mix (down to baseband) is folded
+   * into the first stage of that resampler.  The FM modes need the mixed
+   * signal at the full RF rate, so they mix it the old fashioned way.
    *
    * As each buffer/timeslice is demodulated, it
    * is placed on a queue of outbound audio blocks for the host processor's
@@ -111,7 +114,8 @@ namespace SoDa {
      * @brief demodulate the input stream as an SSB signal
      * place the resulting audio buffer on the audio output queue.
      *
-     * @param drxbuf downsampled  RF input buffer
+     * @param drxbuf downsampled RF input buffer, already passed through
+     * the sideband filter (cur_lsb_filter or cur_usb_filter)
      * @param mod modulation type -- LSB, USB, CW_U, or CW_R
      */
     void demodulateSSB(std::complex<float> * drxbuf,
@@ -141,14 +145,14 @@ namespace SoDa {
      * @brief demodulate the input stream as a wideband frequency modulated signal
      * place the resulting audio buffer on the audio output queue.
      *
-     * Note the wideband FM unit takes the raw RX buffer rather than the downsampled
+     * Note the wideband FM unit takes the (mixed) full rate RX buffer rather than the downsampled
      * rx buffer.   
      *
-     * @param rxbuf RF input buffer
+     * @param rfbuf RF input buffer, mixed to baseband
      * @param mod modulation type -- WBFM
      * @param af_gain factor to goose the audio output
      */
-    void demodulateWBFM(SoDa::Buf * rxbuf,
+    void demodulateWBFM(std::complex<float> * rfbuf,
 			SoDa::Command::ModulationType mod,
 			float af_gain);
 
@@ -161,6 +165,21 @@ namespace SoDa {
      */
     void demodulate(SoDa::Buf * rxbuf);
 
+    /**
+     * @brief mix a full rate RX buffer down to baseband with the 3rd LO
+     *
+     * @param rxbuf RF input buffer
+     * @return pointer to the mixed buffer (mix_buf)
+     */
+    std::complex<float> * mixRF(SoDa::Buf * rxbuf);
+
+    /**
+     * @brief tune the 3rd LO
+     *
+     * @param IF_tuning LO frequency in Hz
+     */
+    void set3rdLOFreq(double IF_tuning);
+
     /**
      * @brief send a report of the lower and upper edges of the IF passband
      * based on the current filter and modulation type.
@@ -235,9 +254,10 @@ namespace SoDa {
     float * sidetone_silence;  ///< a sequence of zero samples to stuff silence into the audio
 
     // resampler -- downsample from 625K samples / sec to 48K samples/sec
-    SoDa::TDResampler625x48<std::complex<float> > * rf_resampler; ///< downsample the RF input to 48KS/s
+    /// mix the RF input to baseband and downsample it to 48KS/s
+    SoDa::TDStreamResampler625x48<std::complex<float>, SoDa::TDTranslatingDecimator> * rf_resampler;
     // a second resampler for wideband fm
-    SoDa::TDResampler625x48<float>  * wbfm_resampler; ///< downsample the RF input to 48KS/s for WBFM unit
+    SoDa::TDStreamResampler625x48<float>  * wbfm_resampler; ///< downsample the RF input to 48KS/s for WBFM unit
 
     /**
      * @brief build the audio filter map for selected bandwidths
@@ -246,25 +266,30 @@ namespace SoDa {
     
     SoDa::Command::AudioFilterBW af_filter_selection; ///< currently audio filter selector
     SoDa::OSFilter * cur_audio_filter; ///< currently selected audio filter
+    SoDa::OSFilter * cur_lsb_filter; ///< currently selected audio filter + LSB selector
+    SoDa::OSFilter * cur_usb_filter; ///< currently selected audio filter + USB selector
     SoDa::OSFilter * fm_audio_filter; ///< audio filter for FM (wider passband)
     SoDa::OSFilter * am_pre_filter; ///< Before AM demod, we do some (6KHz) prefilter
-    SoDa::OSFilter * nbfm_pre_filter; ///< Before NBFM demod, we do some (15KHz) prefilter -- rf rate
+    SoDa::OSFilter * nbfm_pre_filter; ///< Before NBFM demod, we do some (15KHz) prefilter
     SoDa::OSFilter * am_audio_filter; ///< After AM demod, we do a second filter
 
     
     
     std::map<SoDa::Command::AudioFilterBW, SoDa::OSFilter *> filter_map; ///< map filter selectors to the filter objects
-
-    // hilbert transformer
-    SoDa::HilbertTransformer * hilbert; ///< hilbert transform object for SSB/CW widgets
+    std::map<SoDa::Command::AudioFilterBW, SoDa::OSFilter *> lsb_filter_map; ///< filter_map folded with the LSB selector
+    std::map<SoDa::Command::AudioFilterBW, SoDa::OSFilter *> usb_filter_map; ///< filter_map folded with the USB selector
     
     // audio gain
     float af_gain;   ///< audio gain setting for RX mode
     float af_sidetone_gain; ///< audio gain setting for TX/CW mode
     float *cur_af_gain; ///< pointer to the gain setting for this mode
 
+    // 3rd LO for the full rate (WBFM) path
+    QuadratureOscillator IF_osc; ///< 3rd LO for the WBFM path
+    std::complex<float> * mix_buf; ///< full rate RF buffer, mixed to baseband
+
     // support for NBFM/WBFM demodulator
-    float last_phase_samp; ///< history value used to calculate dPhase/dt in FM atan based discriminator.
+    std::complex<float> last_fm_samp; ///< previous sample, for the conjugate product FM discriminator.
 
     // median filter for FM demods
     MedianFilter3<float> fmMedianFilter; ///< simple 3 point median filter for FM units
@@ -100,6 +100,7 @@ SoDa::BaseBandTX::BaseBandTX(Params * params,
   tx_audio_filter = new SoDa::OSFilter(80.0, 150.0, 2300.0, 2400.0, 
 				       512, 1.0, 
 				       srate, audio_buffer_size);
+  tx_audio_filter->planRealPath();
 
   // enable the audio filter by default.
   tx_audio_filter_ena = true; 
@@ -227,10 +228,7 @@ SoDa::Buf * SoDa::BaseBandTX::modulateAM(float * audio_buf,
 
   /// Now that the I/Q channels have been populated, get a transmit buffer. 
   /// and upsample the I/Q audio up to the RF rate.
-  SoDa::Buf * txbuf = tx_stream->alloc();
-  if(txbuf == NULL) {
-    txbuf = new SoDa::Buf(tx_buffer_size); 
-  }
+  SoDa::Buf * txbuf = tx_stream->allocOrNew(tx_buffer_size);
   if(txbuf->getComplexLen() < tx_buffer_size) {
     throw SoDa::Radio::Exception("Transmit signal buffer was a bad size.", this);
   }
@@ -269,10 +267,7 @@ SoDa::Buf * SoDa::BaseBandTX::modulateFM(float *audio_buf, unsigned int len, dou
     audio_IQ_buf[i] = std::complex<float>(oi,oq);
   }
  
-  SoDa::Buf * txbuf = tx_stream->alloc();
-  if(txbuf == NULL){
-    txbuf = new SoDa::Buf(tx_buffer_size);
-  }
+  SoDa::Buf * txbuf = tx_stream->allocOrNew(tx_buffer_size);
 
   if(txbuf->getComplexLen() < tx_buffer_size){
     throw  SoDa::Radio::Exception("FM: Transmit signal buffer was a bad size.",this);
@@ -328,7 +323,7 @@ void SoDa::BaseBandTX::execSetCommand(SoDa::Command * cmd)
     // audio gain is passed around as linear (in dB), but
     // gets converted before we set the envelope power.
     af_gain = powf(10.0, 0.1 * (cmd->dparms[0] - 50.0));
-    cmd_stream->put(new Command(Command::REP, Command::TX_AF_GAIN, 
+    cmd_stream->put(cmd_stream->make(Command::REP, Command::TX_AF_GAIN, 
 				50 + 10.0 * log10(af_gain)));
     break; 
   case SoDa::Command::TX_AUDIO_IN:
@@ -371,7 +366,12 @@ void SoDa::BaseBandTX::execRepCommand(SoDa::Command * cmd)
 void SoDa::BaseBandTX::subscribeToMailBox(const std::string & mbox_name, BaseMBox * mbox_p)
 {
   if(SoDa::connectMailBox<SoDa::CmdMBox>(this, cmd_stream, "CMD", mbox_name, mbox_p)) {
-    cmd_subs = cmd_stream->subscribe();
+    cmd_subs = cmd_stream->subscribe(Command::makeFilter({Command::TX_AF_GAIN,
+	    Command::TX_AUDIO_FILT_ENA,
+	    Command::TX_AUDIO_IN,
+	    Command::TX_MODE,
+	    Command::TX_STATE},
+	{Command::SET}));
   }
   if(SoDa::connectMailBox<SoDa::DatMBox>(this, tx_stream, "TX", mbox_name, mbox_p)) {
     // we subscribe
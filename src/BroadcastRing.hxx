@@ -0,0 +1,390 @@
+/*
+  Copyright (c) 2026, Matthew H. Reilly (kb1vc)
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+  Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in
+  the documentation and/or other materials provided with the
+  distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef BROADCAST_RING_HDR
+#define BROADCAST_RING_HDR
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+namespace SoDa
+{
+
+  /**
+   * @brief A single-writer, multi-reader broadcast ring.
+   *
+   * This is the data-stream flavor of the MultiMBox.  It is modeled on
+   * the LMAX "disruptor": the producer owns a single sequence number
+   * that counts the messages published so far, and each subscriber
+   * owns a cursor that counts the messages it has consumed.  A message
+   * lives in slot (seq & ring_mask) until the slowest subscriber has
+   * moved past it.  Neither put nor get takes a lock -- the only
+   * shared state is a handful of atomic sequence numbers.
+   *
+   * Restrictions:
+   *   - exactly one thread may call put (and popFree).
+   *   - all subscriptions should be made before the first put.
+   *     (This is what the ThreadRegistry does anyway.)
+   *   - if a subscriber falls a full ring (or the capacity passed
+   *     to put) behind, the producer will wait for it, unless the
+   *     producer uses skip to throw away the subscriber's oldest
+   *     messages.
+   *
+   * The ring holds pointers only.  Message lifetime is still governed by
+   * the per-message reader count in MBoxMessage.  T must provide a
+   * free_link pointer for the recycled-message stack (MBoxMessage does).
+   */
+  template <typename T>
+  class BroadcastRing
+  {
+  public:
+    /**
+     * @brief constructor
+     *
+     * @param _ring_size number of slots in the ring -- rounded up to a power of two
+     * @param _max_subscribers the largest number of subscribers we will accept
+     */
+    BroadcastRing(unsigned int _ring_size, unsigned int _max_subscribers = 32)
+    {
+      ring_size = 1;
+      while (ring_size < _ring_size)
+        ring_size = ring_size << 1;
+      ring_mask = ring_size - 1;
+
+      max_subscribers = _max_subscribers;
+
+      slots = new T *[ring_size];
+      for (unsigned int i = 0; i < ring_size; i++)
+        slots[i] = NULL;
+
+      cursors = new Cursor[max_subscribers];
+      for (unsigned int i = 0; i < max_subscribers; i++)
+        cursors[i].seq.store(0);
+
+      published.seq.store(0);
+      gate_cache = 0;
+      subscriber_count.store(0);
+      waiter_count.store(0);
+      free_head.store(NULL);
+    }
+
+    ~BroadcastRing()
+    {
+      delete[] slots;
+      delete[] cursors;
+    }
+
+    /**
+     * @brief add a subscriber.
+     *
+     * @return the subscriber id, or -1 if the ring is already full up.
+     */
+    int subscribe()
+    {
+      std::lock_guard<std::mutex> lck(wait_mutex);
+      unsigned int id = subscriber_count.load();
+      if (id >= max_subscribers)
+        return -1;
+      // a new subscriber starts with the next message to be published.
+      cursors[id].seq.store(published.seq.load());
+      subscriber_count.store(id + 1);
+      return id;
+    }
+
+    unsigned int getSubscriberCount() { return subscriber_count.load(std::memory_order_acquire); }
+
+    unsigned int getRingSize() { return ring_size; }
+
+    /**
+     * @brief publish a message to all subscribers.  Producer thread only.
+     *
+     * The caller has already set the message reader count.
+     *
+     * @param m the message
+     * @param capacity wait until every subscriber is less than this
+     * many messages behind (0 or anything larger than the ring means the ring size)
+     */
+    void put(T *m, unsigned int capacity = 0)
+    {
+      publish(m, capacity);
+      wake();
+    }
+
+    /**
+     * @brief publish a message without waking sleeping subscribers.
+     * Producer thread only.
+     *
+     * Use this to put several messages in a row, then call wake once.
+     * The caller must call wake before it does anything that waits on
+     * a subscriber -- publish itself wakes the subscribers before it
+     * waits for room.
+     *
+     * @param m the message
+     * @param capacity as for put
+     */
+    void publish(T *m, unsigned int capacity = 0)
+    {
+      unsigned int sc = subscriber_count.load(std::memory_order_acquire);
+      uint64_t seq = published.seq.load(std::memory_order_relaxed);
+
+      if ((capacity == 0) || (capacity > ring_size))
+        capacity = ring_size;
+
+      // wait for the slowest reader to get out of the way.
+      // gate_cache is only ever touched by the producer.
+      int spins = 0;
+      while ((seq - gate_cache) >= capacity)
+      {
+        gate_cache = minCursor(sc);
+        if ((seq - gate_cache) >= capacity)
+        {
+          // make sure the slow reader knows there is work to do.
+          if (spins == 0)
+            wake();
+          if (spins++ < 100)
+            std::this_thread::yield();
+          else
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+      }
+
+      slots[seq & ring_mask] = m;
+      published.seq.store(seq + 1);
+    }
+
+    /**
+     * @brief wake any subscribers sleeping in getWait
+     */
+    void wake()
+    {
+      // only bother with the lock if someone is sleeping in getWait
+      if (waiter_count.load() > 0)
+      {
+        std::lock_guard<std::mutex> lck(wait_mutex);
+        wait_cond.notify_all();
+      }
+    }
+
+    /**
+     * @brief get the next message for this subscriber, if there is one.
+     *
+     * @param sub the subscriber id
+     * @return the next message, or NULL if we've caught up to the producer.
+     */
+    T *get(unsigned int sub)
+    {
+      if (sub >= subscriber_count.load(std::memory_order_acquire))
+        return NULL;
+      Cursor &c = cursors[sub];
+      uint64_t s = c.seq.load(std::memory_order_acquire);
+      while (s != published.seq.load(std::memory_order_acquire))
+      {
+        T *ret = slots[s & ring_mask];
+        // once the cursor moves, the producer may reuse the slot.
+        // The producer may also have skipped us ahead -- if so, the
+        // compare-exchange fails, s is reloaded, and we try again.
+        if (c.seq.compare_exchange_weak(s, s + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+          return ret;
+      }
+      return NULL;
+    }
+
+    /**
+     * @brief get as many as max messages for this subscriber with a
+     * single update of its cursor.
+     *
+     * @param sub the subscriber id
+     * @param out where to put the messages
+     * @param max the size of out
+     * @return the number of messages copied to out
+     */
+    unsigned int getBatch(unsigned int sub, T **out, unsigned int max)
+    {
+      if ((max == 0) || (sub >= subscriber_count.load(std::memory_order_acquire)))
+        return 0;
+      Cursor &c = cursors[sub];
+      uint64_t s = c.seq.load(std::memory_order_acquire);
+      while (true)
+      {
+        uint64_t avail = published.seq.load(std::memory_order_acquire) - s;
+        if (avail == 0)
+          return 0;
+        unsigned int n = (avail < max) ? (unsigned int)avail : max;
+        for (unsigned int i = 0; i < n; i++)
+          out[i] = slots[(s + i) & ring_mask];
+        // as in get: if the producer skipped us, s is reloaded and we start over.
+        if (c.seq.compare_exchange_weak(s, s + n, std::memory_order_acq_rel, std::memory_order_acquire))
+          return n;
+      }
+    }
+
+    /**
+     * @brief throw away the oldest unread message for a subscriber.
+     * Producer thread only.
+     *
+     * This races fairly with the subscriber's own get: exactly one of
+     * us gets each message.
+     *
+     * @param sub the subscriber id
+     * @return the skipped message (the caller owns this subscriber's
+     * reference to it) or NULL if there was nothing to skip.
+     */
+    T *skip(unsigned int sub)
+    {
+      return get(sub);
+    }
+
+    /**
+     * @brief get the next message for this subscriber, waiting if necessary
+     *
+     * @param sub the subscriber id
+     * @return the next message, or NULL if sub is not a valid subscriber
+     */
+    T *getWait(unsigned int sub)
+    {
+      if (sub >= subscriber_count.load(std::memory_order_acquire))
+        return NULL;
+      T *ret;
+      while ((ret = get(sub)) == NULL)
+      {
+        std::unique_lock<std::mutex> lck(wait_mutex);
+        // the increment and the re-check are both seq_cst, as is the
+        // producer's publish-then-check, so one of us will see the other.
+        waiter_count++;
+        if (cursors[sub].seq.load() == published.seq.load())
+          wait_cond.wait(lck);
+        waiter_count--;
+      }
+      return ret;
+    }
+
+    /**
+     * @brief how far behind the producer is this subscriber?
+     */
+    unsigned int backlog(unsigned int sub)
+    {
+      if (sub >= subscriber_count.load(std::memory_order_acquire))
+        return 0;
+      // seq_cst: a WaitSet arms itself and then asks for the backlog.
+      return (unsigned int)(published.seq.load() - cursors[sub].seq.load());
+    }
+
+    /**
+     * @brief how far behind the producer is the slowest subscriber?
+     */
+    unsigned int maxBacklog()
+    {
+      unsigned int sc = subscriber_count.load(std::memory_order_acquire);
+      return (unsigned int)(published.seq.load(std::memory_order_acquire) - minCursor(sc));
+    }
+
+    /**
+     * @brief return a message to the free stack.  Any thread may push.
+     */
+    void pushFree(T *m)
+    {
+      T *h = free_head.load(std::memory_order_relaxed);
+      do
+      {
+        m->free_link = h;
+      } while (!free_head.compare_exchange_weak(h, m, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief return a chain of messages (linked through free_link,
+     * first to last) to the free stack with a single compare-exchange.
+     */
+    void pushFreeChain(T *first, T *last)
+    {
+      T *h = free_head.load(std::memory_order_relaxed);
+      do
+      {
+        last->free_link = h;
+      } while (!free_head.compare_exchange_weak(h, first, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief take a message from the free stack.  Producer thread only.
+     *
+     * With a single popper there is no ABA hazard: nobody else can
+     * remove the head node between our load and the compare-exchange.
+     */
+    T *popFree()
+    {
+      T *h = free_head.load(std::memory_order_acquire);
+      while ((h != NULL) && !free_head.compare_exchange_weak(h, (T *)h->free_link, std::memory_order_acquire, std::memory_order_acquire))
+        ;
+      return h;
+    }
+
+  private:
+    uint64_t minCursor(unsigned int sc)
+    {
+      uint64_t ret = published.seq.load(std::memory_order_acquire);
+      for (unsigned int i = 0; i < sc; i++)
+      {
+        uint64_t c = cursors[i].seq.load(std::memory_order_acquire);
+        if (c < ret)
+          ret = c;
+      }
+      return ret;
+    }
+
+    /// a sequence number padded out to its own cache line so that
+    /// readers don't fight over each other's cursors.
+    struct Cursor
+    {
+      std::atomic<uint64_t> seq;
+      char pad[64 - sizeof(std::atomic<uint64_t>)];
+    };
+
+    T **slots;                  ///< the ring itself
+    unsigned int ring_size;     ///< always a power of two
+    unsigned int ring_mask;     ///< ring_size - 1
+    unsigned int max_subscribers;
+
+    Cursor published;           ///< number of messages published so far
+    uint64_t gate_cache;        ///< producer's last look at the slowest cursor
+    Cursor *cursors;            ///< one per subscriber: number of messages consumed
+
+    std::atomic<unsigned int> subscriber_count;
+
+    std::atomic<int> waiter_count; ///< number of subscribers asleep in getWait
+    std::mutex wait_mutex;
+    std::condition_variable wait_cond;
+
+    std::atomic<T *> free_head; ///< intrusive stack of recycled messages
+  };
+} // namespace SoDa
+
+#endif
@@ -100,14 +100,10 @@ namespace SoDa {
      * @return a pointer to a floating point envelope buffer
      */
     SoDa::Buf * getFreeSoDaBuf() {
-      SoDa::Buf * sb = NULL;
       if(env_stream != NULL) {
-	sb = env_stream->alloc();
+	return env_stream->allocOrNew(env_buf_len);
       }
-      if(sb == NULL) {
-	sb = new SoDa::Buf(env_buf_len); 
-      }
-      return sb; 
+      return new SoDa::Buf(env_buf_len); 
     }
 
     /**
@@ -48,6 +48,8 @@ void SoDa::CWTX::run()
 {
   bool exitflag = false;
   Command * cmd, *txtcmd; 
+  const unsigned int cmd_batch_size = 16;
+  Command * cmds[cmd_batch_size]; 
 
   if((cmd_stream == NULL) || (cw_env_stream == NULL) || (cwtxt_stream == NULL)) {
     throw SoDa::Radio::Exception(std::string("Missing a stream connection.\n"), 
@@ -56,22 +58,34 @@ void SoDa::CWTX::run()
 
   // setup the CW generator unit
   cwgen = new SoDa::CWGenerator(cw_env_stream, rf_sample_rate, rf_buffer_size);
+
+  SoDa::WaitSet wait_set;
+  wait_set.add(cmd_stream, cmd_subs);
+  wait_set.add(cwtxt_stream, cwtxt_subs);
   
   while(!exitflag) {
     bool workdone = false; 
-    while((cmd = cmd_stream->get(cmd_subs)) != NULL) {
-      // process the command.
-      execCommand(cmd);
-      exitflag |= (cmd->target == Command::STOP); 
-      cmd_stream->free(cmd);
+    unsigned int i, ncmds;
+    while((ncmds = cmd_stream->getBatch(cmd_subs, cmds, cmd_batch_size)) != 0) {
+      for(i = 0; i < ncmds; i++) {
+	// process the command.
+	cmd = cmds[i]; 
+	execCommand(cmd);
+	exitflag |= (cmd->target == Command::STOP); 
+      }
+      cmd_stream->freeBatch(cmds, ncmds);
       workdone = true; 
     }
 
-    while((txtcmd = cwtxt_stream->get(cwtxt_subs)) != NULL) {
-      // pend the text to the text queue
-      execCommand(txtcmd);
-      exitflag |= (txtcmd->target == Command::STOP); 
-      cwtxt_stream->free(txtcmd);
+    // a burst of text arrives as many short commands
+    while((ncmds = cwtxt_stream->getBatch(cwtxt_subs, cmds, cmd_batch_size)) != 0) {
+      for(i = 0; i < ncmds; i++) {
+	// pend the text to the text queue
+	txtcmd = cmds[i];
+	execCommand(txtcmd);
+	exitflag |= (txtcmd->target == Command::STOP); 
+      }
+      cwtxt_stream->freeBatch(cmds, ncmds);
       workdone = true; 
     }
 
@@ -84,7 +98,11 @@ void SoDa::CWTX::run()
     }
 
     if(!workdone) {
-      usleep(1000); 
+      // when we're keyed, the envelope stream drains without telling
+      // us, so check back every 10ms to see if the generator wants
+      // more.  Otherwise, only a command or more text can wake us.
+      if(tx_on && txmode_is_cw) wait_set.wait(10000);
+      else wait_set.wait(); 
     }
   }
 }
@@ -114,12 +132,12 @@ bool SoDa::CWTX::sendAvailChar()
       cwgen->sendChar(outchar);
       sent_char = true;
       tbuf[0] = outchar; 
-      cmd_stream->put(new SoDa::Command(SoDa::Command::REP,
+      cmd_stream->put(cmd_stream->make(SoDa::Command::REP,
 					SoDa::Command::CW_CHAR_SENT,
 					tbuf, sent_char_count++));
     }
     else {
-      cmd_stream->put(new SoDa::Command(SoDa::Command::SET,
+      cmd_stream->put(cmd_stream->make(SoDa::Command::SET,
 					SoDa::Command::TX_CW_EMPTY,
 					0));
     }
@@ -225,7 +243,7 @@ void SoDa::CWTX::clearTextQueue()
     text_queue = std::queue<char>(); 
     sent_char_count += deleted_count; 
   }
-  SoDa::Command * ncmd = new SoDa::Command(SoDa::Command::REP,
+  SoDa::Command * ncmd = cmd_stream->make(SoDa::Command::REP,
 					   SoDa::Command::TX_CW_FLUSHTEXT,
 					   sent_char_count);
   cmd_stream->put(ncmd); 
@@ -243,7 +261,7 @@ void SoDa::CWTX::execRepCommand(Command * cmd)
       // the break queue and send it back in a REPORT
       if(!break_notification_id_queue.empty()) {
 	int bkid = break_notification_id_queue.front(); break_notification_id_queue.pop();
-	SoDa::Command * ncmd = new SoDa::Command(SoDa::Command::REP,
+	SoDa::Command * ncmd = cmd_stream->make(SoDa::Command::REP,
 						 SoDa::Command::TX_CW_MARKER,
 						 bkid);
 	cmd_stream->put(ncmd); 	  
@@ -260,7 +278,16 @@ void SoDa::CWTX::execRepCommand(Command * cmd)
 void SoDa::CWTX::subscribeToMailBox(const std::string & mbox_name, BaseMBox * mbox_p)
 {
   if(SoDa::connectMailBox<SoDa::CmdMBox>(this, cmd_stream, "CMD", mbox_name, mbox_p)) {
-    cmd_subs = cmd_stream->subscribe();
+    SoDa::MBoxFilter filt = Command::makeFilter({Command::TX_BEACON,
+	  Command::TX_CW_FLUSHTEXT,
+	  Command::TX_CW_MARKER,
+	  Command::TX_CW_SPEED,
+	  Command::TX_CW_TEXT,
+	  Command::TX_MODE,
+	  Command::TX_STATE},
+      {Command::SET, Command::GET});
+    filt.merge(Command::makeFilter({Command::TX_CW_EMPTY}, {Command::REP}));
+    cmd_subs = cmd_stream->subscribe(filt);
   }
   if(SoDa::connectMailBox<SoDa::CmdMBox>(this, cwtxt_stream, "CW_TXT", mbox_name, mbox_p)) {
     cwtxt_subs = cwtxt_stream->subscribe();
@@ -111,6 +111,7 @@ void SoDa::Command::initTables()
   initTableEntry(std::string("RF_RECORD_START"), RF_RECORD_START);
   initTableEntry(std::string("RF_RECORD_STOP"), RF_RECORD_STOP);
   initTableEntry(std::string("NBFM_SQUELCH"), NBFM_SQUELCH);
+  initTableEntry(std::string("SPEC_ENCODING"), SPEC_ENCODING);
 
   initTableEntry(std::string("RX_CENTER_FREQ"), RX_CENTER_FREQ);
 }
@@ -216,3 +217,26 @@ std::string SoDa::Command::toString() const
   
   return sp; 
 }
+
+SoDa::MBoxFilter SoDa::Command::makeFilter(std::initializer_list<CmdTarget> targets,
+					   std::initializer_list<CmdType> types)
+{
+  SoDa::MBoxFilter ret;
+  for(auto ct : types) {
+    for(auto tgt : targets) {
+      ret.add(makeTopic(ct, tgt));
+    }
+    ret.add(makeTopic(ct, STOP));
+  }
+  // STOP is usually a SET, but don't count on it.
+  ret.add(makeTopic(SET, STOP));
+  
+  return ret; 
+}
+
+void SoDa::Command::addTypeToFilter(SoDa::MBoxFilter & filter, CmdType ct)
+{
+  for(unsigned int t = 0; t <= (unsigned int) NULL_CMD; t++) {
+    filter.add(makeTopic(ct, (CmdTarget) t));
+  }
+}
@@ -30,6 +30,7 @@
 #define COMMAND_HDR
 
 #include <string>
+#include <initializer_list>
 #include "MultiMBox.hxx"
 #include <string.h>
 
@@ -97,7 +98,10 @@ public:
     RX_RETUNE_FREQ,
 
     /**
-       * Tune the 3rd LO (in SoDa::USRPRX).
+       * Tune the 3rd LO (in SoDa::BaseBandRX and SoDa::IFRecorder).
+       * The RX stream is not mixed by the 3rd LO, so any other
+       * subscriber to the RX stream that wants the tuned signal at
+       * DC must follow this command and do the mix itself. 
        *
        * param is frequency as a double
        */
@@ -498,6 +502,16 @@ public:
        */
     NBFM_SQUELCH,
 
+    /**
+     * Choose the format of the rows on the waterfall socket.
+     * iparms[0] is the SpectrumEncoding::Format (0 float, 1 8-bit, 2 16-bit),
+     * iparms[1] is 1 for delta rows,
+     * iparms[2] is the lowest level in dB and
+     * iparms[3] is the range in dB.  The server replies with
+     * a REP of what it will actually send.
+     */
+    SPEC_ENCODING,
+
     /**
        * No comment
        */
@@ -542,7 +556,8 @@ public:
     RFRX,
     RFTX,
     CWTX,
-    CTRL
+    CTRL,
+    MBOXES ///< mailbox occupancy, drops, and buffer pool counts
   };
 
   /**
@@ -731,6 +746,45 @@ public:
      */
   static int getMaxStringLen() { return 64; }
 
+  /**
+     * @brief the mailbox topic for this command, used by filtered
+     * subscriptions to the command stream.
+     * @return a topic number built from the type and target
+     */
+  unsigned int getMBoxTopic() const { return makeTopic(cmd, target); }
+
+  /**
+     * @brief map a command type and target to a mailbox topic
+     * @param ct SET, GET, REP...
+     * @param tgt the target
+     * @return the topic number
+     */
+  static unsigned int makeTopic(CmdType ct, CmdTarget tgt)
+  {
+    return (((unsigned int)tgt) << 2) | (((unsigned int)ct) & 3);
+  }
+
+  /**
+     * @brief build a subscription filter for the command stream
+     *
+     * The filter selects every combination of the listed targets and
+     * types.  STOP is always included -- every thread needs to see it.
+     *
+     * @param targets the command targets of interest
+     * @param types the command types of interest (SET, GET, REP by default)
+     * @return a filter to pass to CmdMBox::subscribe
+     */
+  static MBoxFilter makeFilter(std::initializer_list<CmdTarget> targets,
+                               std::initializer_list<CmdType> types = {SET, GET, REP});
+
+  /**
+     * @brief add all targets of a given command type to a filter
+     *
+     * @param filter the filter to extend
+     * @param ct the command type (for instance, REP for a thread that forwards all reports)
+     */
+  static void addTypeToFilter(MBoxFilter &filter, CmdType ct);
+
   unsigned int tag; ///< used to pair an int with a string or other param.
   union {
     int iparms[4];    ///< integer parameters
@@ -0,0 +1,172 @@
+/*
+  Copyright (c) 2026, Matthew H. Reilly (kb1vc)
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+  Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in
+  the documentation and/or other materials provided with the
+  distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "FFTPlanner.hxx"
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+std::mutex SoDa::FFTPlanner::planner_mutex;
+std::string SoDa::FFTPlanner::wisdom_filename;
+SoDa::FFTPlanner::Effort SoDa::FFTPlanner::effort = SoDa::FFTPlanner::ESTIMATE;
+double SoDa::FFTPlanner::time_limit = -1.0;
+bool SoDa::FFTPlanner::wisdom_loaded = false;
+unsigned int SoDa::FFTPlanner::plan_count = 0;
+bool SoDa::FFTPlanner::threads_initialized = false;
+
+static std::string expandHome(const std::string & fname)
+{
+  if((fname.size() >= 2) && (fname[0] == '~') && (fname[1] == '/')) {
+    const char * home = getenv("HOME");
+    if(home != NULL) return std::string(home) + fname.substr(1);
+  }
+  return fname; 
+}
+
+void SoDa::FFTPlanner::configure(const std::string & wisdom_file, Effort _effort, double _time_limit)
+{
+  std::lock_guard<std::mutex> lock(planner_mutex);
+  effort = _effort;
+  time_limit = _time_limit; 
+  wisdom_filename = expandHome(wisdom_file);
+
+  if(!wisdom_filename.empty()) {
+    wisdom_loaded = (fftwf_import_wisdom_from_filename(wisdom_filename.c_str()) != 0);
+  }
+  // a negative limit is FFTW's "no limit"
+  fftwf_set_timelimit((time_limit > 0.0) ? time_limit : -1.0);
+}
+
+bool SoDa::FFTPlanner::effortFromName(const std::string & name, Effort & eff)
+{
+  if(name == "estimate") eff = ESTIMATE;
+  else if(name == "measure") eff = MEASURE;
+  else if(name == "patient") eff = PATIENT;
+  else return false;
+  return true; 
+}
+
+fftwf_plan SoDa::FFTPlanner::planDFT(int n, std::complex<float> * in, std::complex<float> * out, int sign,
+				     bool one_shot)
+{
+  std::lock_guard<std::mutex> lock(planner_mutex);
+  plan_count++;
+  return fftwf_plan_dft_1d(n, (fftwf_complex *) in, (fftwf_complex *) out, sign,
+			   one_shot ? FFTW_ESTIMATE : planFlags());
+}
+
+void SoDa::FFTPlanner::destroyPlan(fftwf_plan plan)
+{
+  if(plan == NULL) return; 
+  std::lock_guard<std::mutex> lock(planner_mutex);
+  fftwf_destroy_plan(plan);
+}
+
+fftwf_plan SoDa::FFTPlanner::planR2C(int n, float * in, std::complex<float> * out)
+{
+  std::lock_guard<std::mutex> lock(planner_mutex);
+  plan_count++;
+  return fftwf_plan_dft_r2c_1d(n, in, (fftwf_complex *) out, planFlags());
+}
+
+fftwf_plan SoDa::FFTPlanner::planC2R(int n, std::complex<float> * in, float * out)
+{
+  std::lock_guard<std::mutex> lock(planner_mutex);
+  plan_count++;
+  return fftwf_plan_dft_c2r_1d(n, (fftwf_complex *) in, out, planFlags());
+}
+
+fftwf_plan SoDa::FFTPlanner::planManyDFT(int n, int howmany,
+					 std::complex<float> * in, int istride, int idist,
+					 std::complex<float> * out, int ostride, int odist,
+					 int sign, int nthreads)
+{
+  std::lock_guard<std::mutex> lock(planner_mutex);
+  plan_count++;
+  int nn[1];
+  nn[0] = n; 
+#if HAVE_FFTW3F_THREADS
+  // the thread count is planner state, so set it for this plan
+  // and put it back for everybody else. 
+  if(nthreads > 1) {
+    if(!threads_initialized) {
+      threads_initialized = (fftwf_init_threads() != 0);
+    }
+    if(threads_initialized) fftwf_plan_with_nthreads(nthreads);
+  }
+#else
+  (void) nthreads; 
+#endif
+  fftwf_plan ret = fftwf_plan_many_dft(1, nn, howmany,
+				       (fftwf_complex *) in, NULL, istride, idist,
+				       (fftwf_complex *) out, NULL, ostride, odist,
+				       sign, planFlags());
+#if HAVE_FFTW3F_THREADS
+  if(threads_initialized) fftwf_plan_with_nthreads(1);
+#endif
+  return ret; 
+}
+
+bool SoDa::FFTPlanner::saveWisdom()
+{
+  std::lock_guard<std::mutex> lock(planner_mutex);
+  // estimated plans don't teach FFTW anything worth keeping.
+  if(wisdom_filename.empty() || (effort == ESTIMATE)) return true;
+
+  // make sure the directory is there.
+  size_t slash = wisdom_filename.rfind('/');
+  if((slash != std::string::npos) && (slash > 0)) {
+    mkdir(wisdom_filename.substr(0, slash).c_str(), 0755);
+  }
+  
+  if(fftwf_export_wisdom_to_filename(wisdom_filename.c_str()) == 0) {
+    std::cerr << "FFTPlanner couldn't write wisdom file [" << wisdom_filename << "]: "
+	      << strerror(errno) << std::endl;
+    return false; 
+  }
+  return true; 
+}
+
+std::string SoDa::FFTPlanner::describe()
+{
+  std::lock_guard<std::mutex> lock(planner_mutex);
+  const char * ename = (effort == PATIENT) ? "patient" : ((effort == MEASURE) ? "measure" : "estimate");
+  std::string ret = std::string("FFTPlanner: effort ") + ename
+    + ", " + std::to_string(plan_count) + " plans";
+  if(threads_initialized) ret += ", threaded";
+  if(wisdom_filename.empty()) {
+    ret += ", no wisdom file";
+  }
+  else {
+    ret += std::string(", wisdom ") + (wisdom_loaded ? "loaded from " : "not found at ") + wisdom_filename;
+  }
+  return ret; 
+}
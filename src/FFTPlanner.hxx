@@ -0,0 +1,131 @@
+/*
+  Copyright (c) 2026, Matthew H. Reilly (kb1vc)
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+  Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in
+  the documentation and/or other materials provided with the
+  distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef FFT_PLANNER_HDR
+#define FFT_PLANNER_HDR
+
+#include <complex>
+#include <string>
+#include <mutex>
+#include <fftw3.h>
+
+namespace SoDa {
+  /**
+   * @brief The process-wide FFTW planning service.
+   *
+   * Every long-lived transform in the radio (OSFilter, HilbertTransformer,
+   * ReSampler, Spectrogram) gets its plan here rather than calling
+   * fftwf_plan_* directly.  The planner
+   *   - serializes planning (the FFTW planner is not thread safe),
+   *   - plans with the configured effort (FFTW_MEASURE or FFTW_PATIENT
+   *     are worth it for plans we execute thousands of times a second),
+   *     but never spends more than the time limit on one plan,
+   *   - loads wisdom saved by earlier runs, so a measured plan is
+   *     only measured once per machine.
+   *
+   * Until configure is called the planner uses FFTW_ESTIMATE and no
+   * wisdom file, which is what the test programs want.
+   *
+   * Note that a measured plan scribbles on its input and output
+   * arrays -- fill them after the plan is made, not before.
+   */
+  class FFTPlanner {
+  public:
+    enum Effort { ESTIMATE, MEASURE, PATIENT };
+
+    /**
+     * @brief set the planning effort and load the wisdom file.  Call
+     * this once, before anybody makes a plan.
+     *
+     * @param wisdom_file where wisdom lives ("~/" is the home directory, empty for none)
+     * @param effort how hard to look for a fast plan
+     * @param time_limit most seconds to spend planning any one transform (< 0 for no limit)
+     */
+    static void configure(const std::string & wisdom_file, Effort effort, double time_limit);
+
+    /**
+     * @brief translate a name (estimate, measure, patient) to an Effort
+     * @param name the effort name
+     * @param eff set to the corresponding effort
+     * @return false if the name isn't one we know
+     */
+    static bool effortFromName(const std::string & name, Effort & eff);
+
+    /// plan a complex-to-complex transform (see fftwf_plan_dft_1d)
+    ///
+    /// A one_shot plan is for a transform that runs once -- building
+    /// a filter image, say.  It is planned with FFTW_ESTIMATE: measuring
+    /// would cost more than it saves, and would scribble on the arrays.
+    static fftwf_plan planDFT(int n, std::complex<float> * in, std::complex<float> * out, int sign,
+			      bool one_shot = false);
+    /// plan a real-to-complex transform (see fftwf_plan_dft_r2c_1d)
+    static fftwf_plan planR2C(int n, float * in, std::complex<float> * out);
+    /// plan a complex-to-real transform (see fftwf_plan_dft_c2r_1d)
+    static fftwf_plan planC2R(int n, std::complex<float> * in, float * out);
+    /// plan a batch of complex transforms (see fftwf_plan_many_dft)
+    /// nthreads > 1 asks for a multithreaded plan -- this is ignored
+    /// unless we were built with the fftw3f_threads library.
+    static fftwf_plan planManyDFT(int n, int howmany,
+				  std::complex<float> * in, int istride, int idist,
+				  std::complex<float> * out, int ostride, int odist,
+				  int sign, int nthreads = 1);
+
+    /// destroy a plan -- this is planner state too, so it takes the planner lock
+    static void destroyPlan(fftwf_plan plan);
+
+    /**
+     * @brief write the accumulated wisdom back to the wisdom file
+     * @return true if the wisdom was written (or there was nothing to write)
+     */
+    static bool saveWisdom();
+
+    /**
+     * @brief describe the planner setup for debug reports.
+     */
+    static std::string describe();
+
+  private:
+    static unsigned int planFlags() {
+      switch(effort) {
+      case MEASURE: return FFTW_MEASURE;
+      case PATIENT: return FFTW_PATIENT;
+      default: return FFTW_ESTIMATE;
+      }
+    }
+    
+    static std::mutex planner_mutex;
+    static std::string wisdom_filename; ///< expanded path of the wisdom file
+    static Effort effort;
+    static double time_limit;
+    static bool wisdom_loaded;          ///< true if we found wisdom at startup
+    static unsigned int plan_count;     ///< number of plans made so far
+    static bool threads_initialized;    ///< true once fftwf_init_threads has run
+  };
+}
+
+#endif
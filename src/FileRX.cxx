@@ -0,0 +1,130 @@
+/*
+  Copyright (c) 2026, Matthew H. Reilly (kb1vc)
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+  Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in
+  the documentation and/or other materials provided with the
+  distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "FileRX.hxx"
+#include "IFRecorder.hxx"
+#include <SoDa/Format.hxx>
+#include <math.h>
+#include <string.h>
+
+SoDa::FileRX::FileRX(Params * params) : SoDa::SoftRX(params, "FileRX")
+{
+  replay_loop = params->replayLoop();
+
+  file_name = params->getReplayFileName(); 
+  if(file_name.empty()) {
+    throw SoDa::Radio::Exception("The FILE radio needs a recording -- use --replay <file>", this);
+  }
+  istr.open(file_name.c_str(), std::ifstream::in | std::ifstream::binary);
+  if(!istr.is_open()) {
+    throw SoDa::Radio::Exception(SoDa::Format("FileRX couldn't open recording [%0]\n").addS(file_name), this);
+  }
+  // IFRecorder starts the file with a magic word and the frequency
+  // of the DC bin.  Older recordings have only the front end
+  // frequency, though they were mixed by the 3rd LO, so the DC bin
+  // is the front end plus a 3rd LO setting we have to be told. 
+  unsigned long long magic; 
+  istr.read((char*) &magic, sizeof(magic));
+  if(istr.gcount() != sizeof(magic)) {
+    throw SoDa::Radio::Exception(SoDa::Format("Recording [%0] is too short to be an IF recording\n").addS(file_name), this);
+  }
+  if(magic == SoDa::IFRecorder::file_magic) {
+    istr.read((char*) &file_freq, sizeof(double));
+    if(istr.gcount() != sizeof(double)) {
+      throw SoDa::Radio::Exception(SoDa::Format("Recording [%0] is too short to be an IF recording\n").addS(file_name), this);
+    }
+  }
+  else {
+    double fe_freq; 
+    memcpy(&fe_freq, &magic, sizeof(double));
+    file_freq = fe_freq + params->getReplayLO3(); 
+    std::cerr << SoDa::Format("FileRX: [%0] has no magic word -- treating it as an old-style recording.\n"
+			      "        Assuming DC is at %1 Hz (front end %2 Hz + 3rd LO %3 Hz -- see --replay-lo3)\n")
+      .addS(file_name)
+      .addF(file_freq, 10, 6, 'e')
+      .addF(fe_freq, 10, 6, 'e')
+      .addF(params->getReplayLO3(), 10, 6, 'e'); 
+  }
+  data_start = istr.tellg(); 
+  istr.seekg(0, std::ifstream::end);
+  std::streamoff num_samples = (istr.tellg() - data_start) / sizeof(std::complex<float>);
+  istr.seekg(data_start);
+  if(!istr.good() || (num_samples <= 0)) {
+    throw SoDa::Radio::Exception(SoDa::Format("Recording [%0] has no samples\n").addS(file_name), this);
+  }
+  std::cerr << SoDa::Format("FileRX: playing [%0] -- %1 seconds centered at %2 Hz\n")
+    .addS(file_name)
+    .addU((unsigned long) (((double) num_samples) / rx_sample_rate))
+    .addF(file_freq, 10, 6, 'e');
+
+  read_buf = new std::complex<float>[rx_buffer_size];
+  remix_osc.setPhaseIncr(0.0);
+}
+
+SoDa::FileRX::~FileRX()
+{
+  delete[] read_buf; 
+}
+
+bool SoDa::FileRX::fillBuffer(std::complex<float> * buf)
+{
+  unsigned int got = 0;
+  bool ret = true; 
+  while(got < rx_buffer_size) {
+    istr.read((char*) (read_buf + got), (rx_buffer_size - got) * sizeof(std::complex<float>));
+    got += istr.gcount() / sizeof(std::complex<float>);
+    if(got == rx_buffer_size) break;
+    
+    // we're at the end of the file.
+    if(!replay_loop) {
+      for(unsigned int i = got; i < rx_buffer_size; i++) read_buf[i] = std::complex<float>(0.0, 0.0);
+      ret = false;
+      break; 
+    }
+    istr.clear();
+    istr.seekg(data_start); 
+  }
+
+  remix_osc.mix(read_buf, buf, rx_buffer_size); 
+  return ret; 
+}
+
+void SoDa::FileRX::execRepCommand(Command * cmd)
+{
+  SoDa::SoftRX::execRepCommand(cmd);
+  
+  if(cmd->target == SoDa::Command::RX_FE_FREQ) {
+    // shift the recording so its DC bin lands where it would
+    // if the front end were tuned to rx_fe_freq.  Only the offset
+    // mod the sample rate matters.
+    double offset = fmod(rx_fe_freq - file_freq, rx_sample_rate);
+    remix_osc.setPhaseIncr(2.0 * M_PI * offset / rx_sample_rate);
+    debugMsg(SoDa::Format("Remixing recording by %0 Hz\n").addF(offset, 10, 6, 'e'));
+  }
+}
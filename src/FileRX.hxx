@@ -0,0 +1,82 @@
+/*
+  Copyright (c) 2026, Matthew H. Reilly (kb1vc)
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+  Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in
+  the documentation and/or other materials provided with the
+  distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef FILERX_HDR
+#define FILERX_HDR
+#include "SoftRX.hxx"
+#include "QuadratureOscillator.hxx"
+#include <fstream>
+
+namespace SoDa {
+  /**
+   * @brief The receive path for the FILE radio -- plays an IF recording.
+   *
+   * FileRX stands in for USRPRX.  It reads a file written by
+   * IFRecorder (see IFRecorder::file_magic for the format) and
+   * publishes it on the RX and IF streams, just as USRPRX would
+   * publish the samples from the radio.
+   *
+   * When the radio is tuned, SoftCtrl reports the new front end
+   * frequency and FileRX remixes the recording so that it looks like
+   * it came from a front end tuned there -- the rest of the radio
+   * (3rd LO, spectrum display) can't tell the difference, as long as
+   * the signal of interest is within the recording's bandwidth.
+   *
+   * At the end of the recording FileRX stops the server, or (with
+   * --replay-loop) starts over.
+   */
+  class FileRX : public SoftRX {
+  public:
+    /**
+     * @brief constructor
+     * @param params command line parameters -- this names the recording.
+     */
+    FileRX(Params * params);
+
+    ~FileRX(); 
+
+  protected:
+    bool fillBuffer(std::complex<float> * buf); 
+
+    void execRepCommand(Command * cmd);
+
+  private:   
+    std::string file_name; 
+    std::ifstream istr;
+    std::streampos data_start; ///< the first sample in the file
+    double file_freq; ///< the frequency of the recording's DC bin
+    bool replay_loop; 
+
+    QuadratureOscillator remix_osc; ///< moves the recording to the front end frequency
+    std::complex<float> * read_buf; 
+  }; 
+}
+
+
+#endif
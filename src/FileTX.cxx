@@ -0,0 +1,258 @@
+/*
+  Copyright (c) 2026, Matthew H. Reilly (kb1vc)
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+  Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in
+  the documentation and/or other materials provided with the
+  distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "FileTX.hxx"
+#include "IFRecorder.hxx"
+#include <SoDa/Format.hxx>
+
+SoDa::FileTX::FileTX(Params * params) : SoDa::Thread("FileTX")
+{
+  cmd_stream = NULL;
+  tx_stream = NULL;
+  cw_env_stream = NULL;
+
+  tx_sample_rate = params->getTXRate();
+  tx_buffer_size = params->getRFBufferSize();
+  sink_file_name = params->getTXSinkFileName();
+  tx_freq = 0.0; 
+
+  // the same CW tone and level as USRPTX
+  CW_tone_freq = 500.0;
+  setCWFreq(true, CW_tone_freq); 
+  cw_env_amplitude = 0.7;
+  
+  beacon_env = new float[tx_buffer_size];
+  for(unsigned int i = 0; i < tx_buffer_size; i++) beacon_env[i] = 1.0;
+  cw_buf = new std::complex<float>[tx_buffer_size];
+
+  tx_modulation = SoDa::Command::USB; 
+  tx_enabled = false;
+  beacon_mode = false; 
+  waiting_to_run_dry = false; 
+}
+
+void SoDa::FileTX::run()
+{
+  if((cmd_stream == NULL) || (tx_stream == NULL) || (cw_env_stream == NULL)) {
+    throw SoDa::Radio::Exception(std::string("Missing a stream connection.\n"), 
+				 this);	
+  }
+
+  SoDa::WaitSet wait_set;
+  wait_set.add(cmd_stream, cmd_subs);
+  wait_set.add(tx_stream, tx_subs);
+  wait_set.add(cw_env_stream, cw_subs);
+
+  bool exitflag = false;
+  SoDa::Buf * txbuf, * cwenv;
+  Command * cmd; 
+  while(!exitflag) {
+    bool didwork = false; 
+    bool cw_mode = (tx_modulation == SoDa::Command::CW_L) || (tx_modulation == SoDa::Command::CW_U);
+    
+    if((cmd = cmd_stream->get(cmd_subs)) != NULL) {
+      execCommand(cmd);
+      didwork = true; 
+      exitflag |= (cmd->target == Command::STOP); 
+      cmd_stream->free(cmd); 
+    }
+    else if(tx_enabled && !cw_mode && ((txbuf = tx_stream->get(tx_subs)) != NULL)) {
+      sink(txbuf->getComplexBuf(), txbuf->getComplexLen());
+      tx_stream->free(txbuf);
+      didwork = true; 
+    }
+    else if(tx_enabled && cw_mode && !beacon_mode) {
+      cwenv = cw_env_stream->get(cw_subs);
+      if(cwenv != NULL) {
+	doCW(cw_buf, cwenv->getFloatBuf(), cwenv->getComplexLen());
+	sink(cw_buf, cwenv->getComplexLen());
+	cw_env_stream->free(cwenv);
+	didwork = true; 
+      }
+      else if(waiting_to_run_dry) {
+	// we've run out of text. 
+	cmd_stream->put(cmd_stream->make(Command::REP, Command::TX_CW_EMPTY, 0));
+	waiting_to_run_dry = false; 
+      }
+    }
+    else if(tx_enabled && cw_mode && beacon_mode) {
+      // a key-down carrier -- pace it with the sink at real time, more or less,
+      // so we don't fill the disk. 
+      doCW(cw_buf, beacon_env, tx_buffer_size);
+      sink(cw_buf, tx_buffer_size);
+      sleep_us((unsigned int) (1e6 * ((double) tx_buffer_size) / tx_sample_rate)); 
+      didwork = true; 
+    }
+
+    if(!didwork) {
+      wait_set.wait();
+    }
+  }
+
+  if(sink_stream.is_open()) sink_stream.close();
+}
+
+void SoDa::FileTX::sink(std::complex<float> * buf, unsigned int len)
+{
+  if(sink_file_name.empty()) return; 
+  if(!sink_stream.is_open()) {
+    sink_stream.open(sink_file_name.c_str(), std::ofstream::out | std::ofstream::binary); 
+    if(!sink_stream.is_open()) {
+      std::cerr << SoDa::Format("FileTX couldn't open TX sink file [%0] -- TX goes nowhere.\n")
+	.addS(sink_file_name);
+      sink_file_name.clear();
+      return; 
+    }
+    unsigned long long magic = SoDa::IFRecorder::file_magic; 
+    sink_stream.write((char*) &magic, sizeof(magic));
+    sink_stream.write((char*) &tx_freq, sizeof(double));
+  }
+  sink_stream.write((char*) buf, len * sizeof(std::complex<float>));
+}
+
+void SoDa::FileTX::doCW(std::complex<float> * out, float * envelope, unsigned int env_len)
+{
+  CW_osc.fill(out, env_len);
+  for(unsigned int i = 0; i < env_len; i++) {
+    out[i] *= envelope[i] * cw_env_amplitude;
+  }
+}
+
+void SoDa::FileTX::setCWFreq(bool usb, double freq)
+{
+  // set to - for USB and + for LSB.
+  CW_osc.setPhaseIncr((usb ? -1.0 : 1.0) * freq * 2.0 * M_PI / tx_sample_rate);
+}
+
+void SoDa::FileTX::transmitSwitch(bool tx_on)
+{
+  if(tx_on) {
+    if(tx_enabled) return;
+    waiting_to_run_dry = false;
+    tx_enabled = true; 
+  }
+  else {
+    if(!tx_enabled) return; 
+    tx_enabled = false;
+    // flush the input stream for us. 
+    tx_stream->flush(tx_subs);
+    if(sink_stream.is_open()) sink_stream.flush();
+  }
+}
+
+void SoDa::FileTX::execCommand(Command * cmd)
+{
+  switch (cmd->cmd) {
+  case Command::GET:
+    execGetCommand(cmd); 
+    break;
+  case Command::SET:
+    execSetCommand(cmd); 
+    break; 
+  case Command::REP:
+    execRepCommand(cmd); 
+    break;
+  default:
+    break; 
+  }
+}
+
+void SoDa::FileTX::execSetCommand(Command * cmd)
+{
+  switch(cmd->target) {
+  case SoDa::Command::TX_MODE:
+    tx_modulation = SoDa::Command::ModulationType(cmd->iparms[0]);
+    if(tx_modulation == SoDa::Command::CW_L) {
+      setCWFreq(false, CW_tone_freq); 
+    }
+    else if(tx_modulation == SoDa::Command::CW_U) {
+      setCWFreq(true, CW_tone_freq); 
+    }
+    break; 
+  case Command::TX_STATE:
+    // same protocol as USRPTX -- 3 is on, 2 is off, 
+    // after CTRL has done its part. 
+    if((cmd->iparms[0] & 0x2) != 0) {  
+      transmitSwitch(cmd->iparms[0] == 3);
+      cmd_stream->put(cmd_stream->make(Command::REP, Command::TX_STATE, tx_enabled ? 1 : 0));
+    }
+    break;
+  case Command::TX_BEACON:
+    beacon_mode = (cmd->iparms[0] != 0);
+    break;
+  case Command::TX_CW_EMPTY:
+    waiting_to_run_dry = true; 
+    break;
+  default:
+    break; 
+  }
+}
+
+void SoDa::FileTX::execGetCommand(Command * cmd)
+{
+  switch(cmd->target) {
+  case Command::TX_STATE:
+    cmd_stream->put(cmd_stream->make(Command::REP, Command::TX_STATE, tx_enabled ? 1 : 0)); 
+    break;
+  default:
+    break; 
+  }
+}
+
+void SoDa::FileTX::execRepCommand(Command * cmd)
+{
+  switch(cmd->target) {
+  case Command::TX_FE_FREQ:
+    tx_freq = cmd->dparms[0]; 
+    break;
+  default:
+    break;
+  }
+}
+
+/// implement the subscription method
+void SoDa::FileTX::subscribeToMailBox(const std::string & mbox_name, 
+				      SoDa::BaseMBox * mbox_p) {
+  if(SoDa::connectMailBox<SoDa::CmdMBox>(this, cmd_stream, "CMD", mbox_name, mbox_p)) {
+    SoDa::MBoxFilter filt = Command::makeFilter({Command::TX_BEACON,
+	  Command::TX_CW_EMPTY,
+	  Command::TX_MODE,
+	  Command::TX_STATE},
+      {Command::SET});
+    filt.merge(Command::makeFilter({Command::TX_STATE}, {Command::GET}));
+    filt.merge(Command::makeFilter({Command::TX_FE_FREQ}, {Command::REP}));
+    cmd_subs = cmd_stream->subscribe(filt);
+  }
+  if(SoDa::connectMailBox<SoDa::DatMBox>(this, tx_stream, "TX", mbox_name, mbox_p)) {
+    tx_subs = tx_stream->subscribe();
+  }
+  if(SoDa::connectMailBox<SoDa::DatMBox>(this, cw_env_stream, "CW_ENV", mbox_name, mbox_p)) {
+    cw_subs = cw_env_stream->subscribe();
+  }
+}
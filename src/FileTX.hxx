@@ -0,0 +1,105 @@
+/*
+  Copyright (c) 2026, Matthew H. Reilly (kb1vc)
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+  Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in
+  the documentation and/or other materials provided with the
+  distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef FILETX_HDR
+#define FILETX_HDR
+#include "SoDaBase.hxx"
+#include "SoDaThread.hxx"
+#include "MultiMBox.hxx"
+#include "Command.hxx"
+#include "Params.hxx"
+#include "QuadratureOscillator.hxx"
+#include <fstream>
+
+namespace SoDa {
+  /**
+   * @brief The transmit path for radios without hardware -- a sink.
+   *
+   * FileTX stands in for USRPTX.  It follows the TX_STATE handshake,
+   * modulates the CW envelope stream just as USRPTX does, and drains
+   * the TX stream.  If there is a sink file (--txsink), each TX
+   * buffer is written there in IFRecorder format (the TX frequency as
+   * a double, then complex float samples), so a transmission can be
+   * played back through the FILE radio.
+   *
+   * There's no D/A converter to set the pace, so FileTX runs as fast
+   * as the TX stream is filled, and idles while the transmitter is
+   * keyed but there is nothing to send.
+   */
+  class FileTX : public SoDa::Thread {
+  public:
+    /**
+     * @brief constructor
+     * @param params command line parameters -- this names the sink file.
+     */
+    FileTX(Params * params);
+
+    /// implement the subscription method
+    void subscribeToMailBox(const std::string & mbox_name, BaseMBox * mbox_p);
+    
+    void run();
+
+  private:
+    void execCommand(Command * cmd); 
+    void execGetCommand(Command * cmd); 
+    void execSetCommand(Command * cmd); 
+    void execRepCommand(Command * cmd);
+
+    /// write a TX buffer to the sink
+    void sink(std::complex<float> * buf, unsigned int len); 
+
+    void doCW(std::complex<float> * out, float * envelope, unsigned int env_len);
+    void setCWFreq(bool usb, double freq); 
+    void transmitSwitch(bool tx_on);
+    
+    DatMBox * tx_stream, * cw_env_stream;
+    CmdMBox * cmd_stream;
+    unsigned int tx_subs, cw_subs, cmd_subs; 
+
+    std::string sink_file_name; 
+    std::ofstream sink_stream; 
+    double tx_freq; ///< the TX frequency, for the sink file header
+
+    double tx_sample_rate;
+    unsigned int tx_buffer_size;
+
+    SoDa::Command::ModulationType tx_modulation;
+    bool tx_enabled; 
+    bool beacon_mode;
+    bool waiting_to_run_dry; 
+
+    QuadratureOscillator CW_osc; 
+    double CW_tone_freq; 
+    float cw_env_amplitude; 
+    float * beacon_env; 
+    std::complex<float> * cw_buf; 
+  };
+}
+
+#endif
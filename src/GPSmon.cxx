@@ -45,6 +45,9 @@ void SoDa::GPSmon::run()
     throw SoDa::Radio::Exception(std::string("Missing a stream connection.\n"),
 			  this);	
   }
+
+  SoDa::WaitSet wait_set;
+  wait_set.add(cmd_stream, cmd_subs);
   
   while(!exitflag) {
     while((cmd = cmd_stream->get(cmd_subs)) != NULL) {
@@ -60,19 +63,19 @@ void SoDa::GPSmon::run()
     // this could block for 0.1 seconds
     if(gps_shim->getFix(100000, utc_time, lat, lon)) {
 	  
-      cmd_stream->put(new SoDa::Command(Command::REP, Command::GPS_UTC, 
+      cmd_stream->put(cmd_stream->make(Command::REP, Command::GPS_UTC, 
 					(int) utc_time.tm_hour,
 					(int) utc_time.tm_min, 
 					(int) utc_time.tm_sec));
 
-      cmd_stream->put(new SoDa::Command(Command::REP, Command::GPS_LATLON, 
+      cmd_stream->put(cmd_stream->make(Command::REP, Command::GPS_LATLON, 
 					lat, lon)); 
     }	
     else if(!gps_shim->isEnabled()) {
       // If we have no gps widget, the getFix call returned
       // immediately.  we don't really have anything to do here, so go
-      // to sleep for a little while.
-      usleep(100000);
+      // to sleep until a command shows up.
+      wait_set.wait();
     }
   }
 }
@@ -27,6 +27,9 @@
 */
 
 #include "HilbertTransformer.hxx"
+#include "OSFilter.hxx"
+#include "FFTPlanner.hxx"
+#include "VecOps.hxx"
 
 #include <iostream>
 #include <string.h>
@@ -139,6 +142,19 @@ SoDa::HilbertTransformer::HilbertTransformer(unsigned int inout_buffer_length,
     Pass_U_filter[i] = uadj * Pass_U_filter[i]; 
   }
 
+  // The sideband selectors.  Both the passthrough and HT impulses are
+  // real, so for a complex input I + jQ, the real part of the
+  // passthrough output is Pass(I) and the imaginary part of the HT output
+  // is HT(Q).  Re(-j * x) = Im(x), so Pass -/+ j HT gives us
+  // Pass(I) +/- HT(Q) in the real part of a single inverse transform.
+  SSB_U_filter = (std::complex<float> *) fftwf_malloc(sizeof(std::complex<float>) * N);
+  SSB_L_filter = (std::complex<float> *) fftwf_malloc(sizeof(std::complex<float>) * N);
+  std::complex<float> jay(0.0, 1.0);
+  for(i = 0; i < N; i++) {
+    SSB_U_filter[i] = Pass_U_filter[i] + jay * HTu_filter[i];
+    SSB_L_filter[i] = Pass_U_filter[i] - jay * HTu_filter[i];
+  }
+
 
   // calculate the magnitudes of the two filters.
   float hmag, pmag;
@@ -162,30 +178,21 @@ SoDa::HilbertTransformer::HilbertTransformer(unsigned int inout_buffer_length,
   ifft_Q_output = (std::complex<float> *) fftwf_malloc(sizeof(std::complex<float>) * (N + 128));
 
   // and create the plans
-  forward_I_plan = fftwf_plan_dft_1d(N,
-				     (fftwf_complex *) fft_I_input, (fftwf_complex *) fft_I_output,
-				     FFTW_FORWARD, FFTW_ESTIMATE);
+  forward_I_plan = SoDa::FFTPlanner::planDFT(N, fft_I_input, fft_I_output, FFTW_FORWARD);
   if(forward_I_plan == NULL) {
     throw SoDa::Radio::Exception("Hilbert had trouble creating forward I plan...\n");
   }
 
-  forward_Q_plan = fftwf_plan_dft_1d(N,
-				     (fftwf_complex *) fft_Q_input,
-				     (fftwf_complex *) fft_Q_output,
-				     FFTW_FORWARD, FFTW_ESTIMATE);
+  forward_Q_plan = SoDa::FFTPlanner::planDFT(N, fft_Q_input, fft_Q_output, FFTW_FORWARD);
   if(forward_Q_plan == NULL) {
     throw SoDa::Radio::Exception("Hilbert had trouble creating forward Q plan...\n");
   }
 
-  backward_I_plan = fftwf_plan_dft_1d(N, (fftwf_complex *) ifft_I_input,
-				      (fftwf_complex *) ifft_I_output,
-				      FFTW_BACKWARD, FFTW_ESTIMATE);
+  backward_I_plan = SoDa::FFTPlanner::planDFT(N, ifft_I_input, ifft_I_output, FFTW_BACKWARD);
   if(backward_I_plan == NULL) {
     throw SoDa::Radio::Exception("Hilbert had trouble creating backward I plan...\n");
   }
-  backward_Q_plan = fftwf_plan_dft_1d(N, (fftwf_complex *) ifft_Q_input,
-				      (fftwf_complex *) ifft_Q_output,
-				      FFTW_BACKWARD, FFTW_ESTIMATE);
+  backward_Q_plan = SoDa::FFTPlanner::planDFT(N, ifft_Q_input, ifft_Q_output, FFTW_BACKWARD);
   if(backward_Q_plan == NULL) {
     throw SoDa::Radio::Exception("Hilbert had trouble creating backward Q plan...\n");
   }
@@ -231,10 +238,8 @@ unsigned int SoDa::HilbertTransformer::apply(std::complex<float> * inbuf,
   memcpy(fft_I_input, &(inbuf[1 + (M - Q)]), sizeof(std::complex<float>) * (Q - 1));
 
   // now apply the delay filter and the hilbert transform
-  for(i = 0; i < N; i++) {
-    ifft_Q_input[i] = fft_I_output[i] * HT_F[i]; 
-    ifft_I_input[i] = fft_I_output[i] * PA_F[i]; 
-  }
+  SoDa::VecOps::cmulScale(ifft_Q_input, fft_I_output, HT_F, 1.0, N);
+  SoDa::VecOps::cmulScale(ifft_I_input, fft_I_output, PA_F, 1.0, N);
   
   // do the inverse fft for the I and Q channels
   fftwf_execute(backward_I_plan);
@@ -310,10 +315,8 @@ unsigned int SoDa::HilbertTransformer::applyIQ(std::complex<float> * inbuf,
   }
 
   // now apply the delay filter (to I) and the hilbert transform (to Q)
-  for(i = 0; i < N; i++) {
-    ifft_Q_input[i] = fft_Q_output[i] * HTu_filter[i]; 
-    ifft_I_input[i] = fft_I_output[i] * Pass_U_filter[i]; 
-  }
+  SoDa::VecOps::cmulScale(ifft_Q_input, fft_Q_output, HTu_filter, 1.0, N);
+  SoDa::VecOps::cmulScale(ifft_I_input, fft_I_output, Pass_U_filter, 1.0, N);
   
   // do the inverse fft for the I and Q channels
   fftwf_execute(backward_I_plan);
@@ -334,6 +337,60 @@ unsigned int SoDa::HilbertTransformer::applyIQ(std::complex<float> * inbuf,
 
 
 
+unsigned int SoDa::HilbertTransformer::applySSB(std::complex<float> * inbuf,
+						float * outbuf,
+						bool lower, 
+						float gain)
+{
+  unsigned int i, j;
+
+  // Note we're using overlap-and-save  see the OSFilter implementation
+  // or Lyons pages 719ff
+  memcpy(&(fft_I_input[Q-1]), inbuf, sizeof(std::complex<float>) * M);
+
+  fftwf_execute(forward_I_plan); 
+
+  // now save the tail of the input to the save buffer
+  memcpy(fft_I_input, &(inbuf[1 + (M - Q)]), sizeof(std::complex<float>) * (Q - 1));
+
+  // passthrough_gain == H_transform_gain, so one scale covers both paths. 
+  SoDa::VecOps::cmulScale(ifft_I_input, fft_I_output, 
+			  lower ? SSB_L_filter : SSB_U_filter, 
+			  H_transform_gain * gain, N);
+  
+  fftwf_execute(backward_I_plan);
+
+  for(i = 0, j = Q-1; i < M; i++, j++) {
+    outbuf[i] = ifft_I_output[j].real(); 
+  }
+
+  return M; 
+}
+
+SoDa::OSFilter * SoDa::HilbertTransformer::makeSSBFilter(bool lower, 
+							 SoDa::OSFilter * audio_filter, 
+							 unsigned int inout_buffer_length,
+							 unsigned int hilbert_length)
+{
+  // This is the time domain version of SSB_L/U_filter: a delay
+  // plus -/+ j times a (Hann windowed) hilbert transform. 
+  unsigned int L = hilbert_length | 1;
+  unsigned int c = L / 2;
+  float s = lower ? 1.0 : -1.0;
+  std::complex<float> imp[L];
+  unsigned int k; 
+  for(k = 0; k < L; k++) imp[k] = std::complex<float>(0.0, 0.0);
+  imp[c] = std::complex<float>(1.0, 0.0);
+  for(k = 1; k <= c; k += 2) {
+    float w = 0.5 + 0.5 * cos(M_PI * ((float) k) / ((float) (c + 1)));
+    float h = w * 2.0 / (M_PI * ((float) k));
+    imp[c + k] = std::complex<float>(0.0, -s * h);
+    imp[c - k] = std::complex<float>(0.0, s * h);
+  }
+
+  return new SoDa::OSFilter(imp, L, 1.0, inout_buffer_length, audio_filter);
+}
+
 std::ostream & SoDa::HilbertTransformer::dump(std::ostream & os)
 {
   unsigned int i, j;
@@ -37,6 +37,7 @@
 #include <fftw3.h>
 #include "SoDaBase.hxx"
 namespace SoDa {
+  class OSFilter; 
   /**
    * @class HilbertTransformer
    *
@@ -50,6 +51,11 @@ namespace SoDa {
    * into g(t) such that
    *   real(g(t)) = real(x(t + tau)) and
    *   imag(g(t)) = shift_by_90deg(imag(x(t + tau)))
+   *
+   * For SSB demodulation, applySSB does the applyIQ step and the
+   * sideband combination in one forward/inverse transform pair, and
+   * makeSSBFilter builds an OSFilter that does the same job fused
+   * with an audio filter.
    */
   class HilbertTransformer : public SoDa::Base {
   public:
@@ -94,6 +100,38 @@ namespace SoDa {
      */
     unsigned int apply(float * inbuf, std::complex<float> * outbuf, bool pos_sided = true, float gain = 1.0);
 
+    /**
+     * Select one sideband from the QUADRATURE signal in the input buffer.
+     * The result is the same as applyIQ followed by
+     * out = real +/- imag, but it takes one forward and one inverse FFT,
+     * not two of each.
+     *
+     * applySSB shares the overlap/save history with applyIQ and
+     * apply -- don't mix calls on a single transformer.
+     *
+     * @param inbuf complex input buffer of I (real) and Q (imag) samples
+     * @param outbuf real output buffer -- the selected sideband
+     * @param lower if true, select the lower sideband, otherwise the upper
+     * @param gain factor to apply to output buffer.
+     * @return M -- length of input buffer.
+     */
+    unsigned int applySSB(std::complex<float> * inbuf, float * outbuf, bool lower, float gain = 1.0);
+
+    /**
+     * Build an overlap/save filter that selects one sideband and
+     * applies the audio filter in one pass.  The real part of the
+     * filter output is the demodulated audio.
+     *
+     * @param lower if true, select the lower sideband, otherwise the upper
+     * @param audio_filter the audio filter to fold in (may be NULL)
+     * @param inout_buffer_length the length of the input and output buffers
+     * @param hilbert_length number of taps in the hilbert transform (should be odd)
+     * @return a new OSFilter -- the caller owns it.
+     */
+    static OSFilter * makeSSBFilter(bool lower, OSFilter * audio_filter, 
+				    unsigned int inout_buffer_length,
+				    unsigned int hilbert_length = 383);
+
     std::ostream & dump(std::ostream & os); 
   private:
     /**
@@ -118,6 +156,8 @@ namespace SoDa {
     std::complex<float> * HTl_filter; ///< The DFT image of the hilbert transform -- lower sideband
     std::complex<float> * Pass_U_filter; ///< The DFT image of a Q/2 delay transform -- used in USB.
     std::complex<float> * Pass_L_filter; ///< The DFT image of a Q/2 delay transform -- used in LSB.
+    std::complex<float> * SSB_U_filter; ///< Pass_U + j HTu -- selects the upper sideband
+    std::complex<float> * SSB_L_filter; ///< Pass_U - j HTu -- selects the lower sideband
     // we need to correct for "gain" in the fftw forward /backward transform pair.
     float passthrough_gain; ///< the gain of the direct passthrough path. 
     float H_transform_gain; ///< the gain of the Hilbert Transform path
@@ -50,6 +50,14 @@ SoDa::IFRecorder::IFRecorder(Params * params) : SoDa::Thread("IFRecorder")
 
   // we don't know the current center frequency
   current_rx_center_freq = 0.0; 
+  current_lo3_freq = 0.0; 
+
+  mix_buf = new std::complex<float>[rf_buffer_size];
+}
+
+SoDa::IFRecorder::~IFRecorder()
+{
+  delete[] mix_buf; 
 }
 
 
@@ -65,6 +73,10 @@ void SoDa::IFRecorder::execSetCommand(SoDa::Command * cmd)
   case SoDa::Command::RF_RECORD_STOP:
     closeOutStream();
     break; 
+  case SoDa::Command::RX_LO3_FREQ:
+    IF_osc.setPhaseIncr(cmd->dparms[0] * 2.0 * M_PI / rf_sample_rate);
+    current_lo3_freq = cmd->dparms[0]; 
+    break; 
   default:
     break; 
   }
@@ -98,6 +110,9 @@ void SoDa::IFRecorder::run()
 			  this);	
   }
   
+  SoDa::WaitSet wait_set;
+  wait_set.add(cmd_stream, cmd_subs);
+  wait_set.add(rx_stream, rx_subs);
   
   while(!exitflag) {
     bool did_work = false;
@@ -118,14 +133,14 @@ void SoDa::IFRecorder::run()
       did_work = true; 
       
       if(write_stream_on) {
-	ostr.write((char*) rxbuf->getComplexBuf(), rxbuf->getComplexLen() * sizeof(std::complex<float>));
+	writeBuffer(rxbuf); 
       }
       // now free the buffer up.
       rx_stream->free(rxbuf); 
     }
 
     if(!did_work) {
-      usleep(1000); 
+      wait_set.wait(); 
     }
   }
 
@@ -135,6 +150,15 @@ void SoDa::IFRecorder::run()
   }
 }
 
+void SoDa::IFRecorder::writeBuffer(SoDa::Buf * rxbuf)
+{
+  std::complex<float> * rfbuf = rxbuf->getComplexBuf();
+  unsigned int len = rxbuf->getComplexLen();
+  if(len > rf_buffer_size) len = rf_buffer_size; 
+  IF_osc.mix(rfbuf, mix_buf, len);
+  ostr.write((char*) mix_buf, len * sizeof(std::complex<float>));
+}
+
 void SoDa::IFRecorder::openOutStream(char * ofile_name)
 {
   std::cerr << SoDa::Format("IFRecorder: about to open file [%0] for writing\n")
@@ -144,8 +168,12 @@ void SoDa::IFRecorder::openOutStream(char * ofile_name)
   }
   ostr.open(ofile_name, std::ofstream::out | std::ofstream::binary); 
 
-  // write the RX front end frequency
-  ostr.write((char*) &current_rx_center_freq, sizeof(double));
+  // write the magic word and the frequency that the 3rd LO mix
+  // puts at DC -- the front end frequency plus the 3rd LO. 
+  unsigned long long magic = file_magic; 
+  ostr.write((char*) &magic, sizeof(magic));
+  double dc_freq = current_rx_center_freq + current_lo3_freq; 
+  ostr.write((char*) &dc_freq, sizeof(double));
   write_stream_on = true; 
 }
 
@@ -162,7 +190,12 @@ void SoDa::IFRecorder::closeOutStream()
 void SoDa::IFRecorder::subscribeToMailBox(const std::string & mbox_name, SoDa::BaseMBox * mbox_p)
 {
   if(SoDa::connectMailBox<SoDa::CmdMBox>(this, cmd_stream, "CMD", mbox_name, mbox_p)) {
-    cmd_subs = cmd_stream->subscribe();
+    SoDa::MBoxFilter filt = Command::makeFilter({Command::RF_RECORD_START,
+	  Command::RF_RECORD_STOP,
+	  Command::RX_LO3_FREQ},
+      {Command::SET});
+    filt.merge(Command::makeFilter({Command::RX_FE_FREQ}, {Command::REP}));
+    cmd_subs = cmd_stream->subscribe(filt);
   }
   if(SoDa::connectMailBox<SoDa::DatMBox>(this, rx_stream, "RX", mbox_name, mbox_p)) {
     rx_subs = rx_stream->subscribe();
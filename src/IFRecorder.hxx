@@ -33,6 +33,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Params.hxx"
 #include "MultiMBox.hxx"
 #include "Command.hxx"
+#include "QuadratureOscillator.hxx"
 
 #include <queue>
 #include <mutex>
@@ -76,6 +77,21 @@ namespace SoDa {
      **/
     IFRecorder(Params * params);
 
+    ~IFRecorder(); 
+
+    /**
+     * @brief the first word of an IF recording.
+     *
+     * A recording is this word ("SoDaIF01" on a little-endian
+     * host), a double holding the frequency of the DC bin (the front
+     * end frequency plus the 3rd LO), and then complex float samples
+     * at the RX rate.  Recordings from before the magic word was
+     * added are mixed by the 3rd LO too, but start with only the front
+     * end frequency -- the 3rd LO setting wasn't recorded.  (See
+     * --replay-lo3.)
+     */
+    static const unsigned long long file_magic = 0x3130464961446f53ULL; 
+
     /// implement the subscription method
     void subscribeToMailBox(const std::string & mbox_name, BaseMBox * mbox_p);
     
@@ -112,11 +128,23 @@ namespace SoDa {
      */
     void closeOutStream();
 
+    /**
+     * @brief write an RX buffer to the output stream, mixed down 
+     * to baseband by the 3rd LO.  (The RX stream carries the 3rd IF.)
+     *
+     * @param rxbuf the buffer to write
+     */
+    void writeBuffer(SoDa::Buf * rxbuf); 
+
     // parameters
     unsigned int rf_buffer_size; ///< size of input RF buffer chunk
     double rf_sample_rate; ///< sample rate of RF input from USRP -- assumed 625KHz
 
     double current_rx_center_freq; 
+    double current_lo3_freq; 
+
+    QuadratureOscillator IF_osc; ///< the 3rd LO
+    std::complex<float> * mix_buf; ///< mixed buffer, on its way to the output stream
 
     DatMBox * rx_stream; ///< mailbox producing rx sample stream from USRP
     CmdMBox * cmd_stream; ///< mailbox producing command stream from user
@@ -32,9 +32,19 @@
 #include <queue>
 #include <vector>
 #include <map>
+#include <bitset>
+#include <new>
+#include <utility>
+#include <list>
+#include <string>
+#include <sstream>
 #include <mutex>
+#include <atomic>
 #include <condition_variable>
 
+#include "BroadcastRing.hxx"
+#include "WaitSet.hxx"
+
 namespace SoDa
 {
 
@@ -45,29 +55,33 @@ public:
   MBoxMessage()
   {
     reader_count = 0;
+    free_link = NULL;
   }
 
   void setReaderCount(unsigned int rc)
   {
-    std::lock_guard<std::mutex> lck(rc_mutex);
-    reader_count = rc;
+    reader_count.store(rc, std::memory_order_release);
   }
 
-  bool readyToDie() { return reader_count == 1; }
-  bool decReaderCount() { return reader_count--; }
+  bool readyToDie() { return reader_count.load() == 1; }
+  bool decReaderCount() { return reader_count-- != 0; }
+
+  /**
+   * @brief drop one reader from this message
+   *
+   * @return true if the caller was the last reader.
+   */
+  bool releaseReader()
+  {
+    return reader_count.fetch_sub(1, std::memory_order_acq_rel) == 1;
+  }
 
   bool free(std::queue<MBoxMessage *> &free_list)
   {
-    std::lock_guard<std::mutex> lck(rc_mutex);
-    if (reader_count == 1)
+    if (releaseReader())
     {
-      reader_count = 0;
       free_list.push(this);
     }
-    else
-    {
-      reader_count--;
-    }
     return true;
   }
 
@@ -75,30 +89,193 @@ public:
   void setMBoxTag(void *tag) { mbox_tag = tag; }
   bool checkMBoxTag(void *tag) { return mbox_tag == tag; }
 
+  /**
+   * @brief the topic that subscription filters select on.
+   *
+   * Message classes that support filtered subscriptions (Command)
+   * hide this with their own version -- MultiMBox<T> calls
+   * T::getMBoxTopic, so no virtual call is needed.
+   */
+  unsigned int getMBoxTopic() const { return 0; }
+
+  MBoxMessage *free_link; ///< link for the BroadcastRing free stack
+
 private:
-  unsigned int reader_count;
-  std::mutex rc_mutex;
+  std::atomic<unsigned int> reader_count;
   void *mbox_tag;
 };
 
+/**
+ * A subscription filter: the set of message topics a subscriber
+ * wants to see.  Topics outside the filter's range are always
+ * accepted, so a malformed message is never silently dropped.
+ */
+class MBoxFilter
+{
+public:
+  static const unsigned int max_topics = 512;
+
+  /**
+   * @brief constructor
+   *
+   * @param accept_all if true, start with every topic selected.
+   */
+  MBoxFilter(bool accept_all = false)
+  {
+    if (accept_all)
+      topics.set();
+  }
+
+  MBoxFilter &add(unsigned int topic)
+  {
+    if (topic < max_topics)
+      topics.set(topic);
+    return *this;
+  }
+
+  MBoxFilter &merge(const MBoxFilter &other)
+  {
+    topics |= other.topics;
+    return *this;
+  }
+
+  bool accepts(unsigned int topic) const
+  {
+    return (topic >= max_topics) || topics.test(topic);
+  }
+
+private:
+  std::bitset<max_topics> topics;
+};
+
 /**
    * A base mailbox class.  
    */
 class BaseMBox
 {
 public:
-  BaseMBox() {}
+  /**
+   * @brief what should put do when a subscriber is "capacity" messages behind?
+   */
+  enum OverflowPolicy
+  {
+    BLOCK,       ///< wait for the subscriber to catch up
+    DROP_OLDEST, ///< throw away the subscriber's oldest unread message
+    DROP_NEWEST, ///< throw away the message being put
+    CONFLATE     ///< the subscriber only ever sees the latest message
+  };
 
-  virtual ~BaseMBox() {}
+  BaseMBox()
+  {
+    std::lock_guard<std::mutex> lck(registryMutex());
+    registry().push_back(this);
+  }
+
+  virtual ~BaseMBox()
+  {
+    std::lock_guard<std::mutex> lck(registryMutex());
+    registry().remove(this);
+  }
+
+  /**
+   * @brief name the mailbox, for statistics reports
+   */
+  void setName(const std::string &nm) { name = nm; }
+  const std::string &getName() const { return name; }
+
+  /**
+   * @brief describe occupancy, drops, and pool usage for this mailbox
+   */
+  virtual std::string getStats() = 0;
+
+  /**
+   * @brief describe every mailbox in the process
+   */
+  static std::string getAllStats()
+  {
+    std::lock_guard<std::mutex> lck(registryMutex());
+    std::string ret;
+    for (auto mb : registry())
+    {
+      ret += mb->getStats() + "\n";
+    }
+    return ret;
+  }
+
+  /**
+   * @brief is there a message waiting for this subscriber?
+   */
+  virtual bool isReady(unsigned int subscriber_id) = 0;
+
+  /**
+   * @brief poke this wait set whenever a message is posted to the subscriber.
+   *
+   * @param subscriber_id the subscription
+   * @param ws the wait set (NULL to detach)
+   */
+  virtual void attachWaitSet(unsigned int subscriber_id, WaitSet *ws) = 0;
+
+protected:
+  static const char *policyName(OverflowPolicy p)
+  {
+    switch (p)
+    {
+    case BLOCK:
+      return "block";
+    case DROP_OLDEST:
+      return "drop-oldest";
+    case DROP_NEWEST:
+      return "drop-newest";
+    case CONFLATE:
+      return "conflate";
+    }
+    return "?";
+  }
+
+  std::string name;
+
+private:
+  static std::list<BaseMBox *> &registry()
+  {
+    static std::list<BaseMBox *> reg;
+    return reg;
+  }
+  static std::mutex &registryMutex()
+  {
+    static std::mutex mtx;
+    return mtx;
+  }
 };
 
 class BaseSubscriber
 {
 public:
-  BaseSubscriber(int pc) : post_count(pc) {}
+  BaseSubscriber(int pc) : post_count(pc)
+  {
+    waitset = NULL;
+    filter = NULL;
+    latest_only = false;
+    active = true;
+  }
+  ~BaseSubscriber()
+  {
+    if (filter != NULL)
+      delete filter;
+  }
+
+  bool accepts(unsigned int topic) const
+  {
+    return (filter == NULL) || filter->accepts(topic);
+  }
+
   int post_count;
   std::mutex post_mutex;
   std::condition_variable post_cond;
+  std::condition_variable space_cond; ///< signaled when a blocked put might proceed
+  std::atomic<WaitSet *> waitset; ///< poke this when something is posted
+  MBoxFilter *filter;             ///< if not NULL, only these topics are posted
+  bool latest_only;               ///< if true, a new message replaces any unread ones
+  std::atomic<bool> active;       ///< false if the subscriber would ignore new messages
 };
 
 template <typename T>
@@ -109,80 +286,314 @@ public:
   std::queue<T *> posted_list;
 };
 
+/**
+ * A mailbox with one or more subscribers.  Every message put into
+ * the mailbox is delivered to every subscriber.
+ *
+ * There are two flavors.  The default keeps a locked queue per
+ * subscriber and is fine for low-rate traffic like the command
+ * stream, where there may be many producers.  If a ring size is
+ * supplied, the mailbox is built on a lock-free BroadcastRing --
+ * this is the right choice for the high-rate data streams (RX, TX, IF,
+ * CW_ENV) where a single thread is the only producer. In ring mode,
+ * put and alloc must only be called from that producer thread.
+ *
+ * Either flavor can be bounded (see setCapacity).  Queue mailboxes
+ * are unbounded by default, ring mailboxes block when the slowest
+ * subscriber is a full ring behind.
+ */
 template <typename T>
 class MultiMBox : public BaseMBox
 {
 public:
-  MultiMBox(bool _keep_freelist = true)
+  /**
+   * @brief constructor
+   *
+   * @param _keep_freelist if true, freed messages are recycled through alloc
+   * @param ring_size if non-zero, use a lock-free broadcast ring with
+   * this many slots (rounded up to a power of two).
+   */
+  MultiMBox(bool _keep_freelist = true, unsigned int ring_size = 0)
   {
     subscriber_count = 0;
     keep_freelist = _keep_freelist;
+    pool_limit = 0;
+    capacity = 0;
+    policy = BLOCK;
+    drop_count = 0;
+    high_water = 0;
+    created_count = 0;
+    if (ring_size != 0)
+      ring = new BroadcastRing<T>(ring_size);
+    else
+      ring = NULL;
+  }
+
+  /**
+   * @brief bound the number of unread messages per subscriber
+   *
+   * For ring mailboxes, DROP_NEWEST drops the new message for
+   * everyone when the slowest subscriber is full -- all ring
+   * subscribers see the same sequence.  The capacity of a ring mailbox
+   * can't exceed the ring size.  Call this before the threads start.
+   *
+   * @param cap the most unread messages a subscriber may have (0 means
+   * no limit for queue mailboxes, the ring size for ring mailboxes)
+   * @param pol what to do when a subscriber is full
+   */
+  void setCapacity(unsigned int cap, OverflowPolicy pol)
+  {
+    capacity = cap;
+    policy = pol;
+    if (policy == CONFLATE)
+      capacity = 1;
+    if ((ring != NULL) && ((capacity == 0) || (capacity > ring->getRingSize())))
+      capacity = ring->getRingSize();
+  }
+
+  /// @return the number of messages dropped by the overflow policy
+  unsigned long getDropCount() { return drop_count.load(); }
+  /// @return the deepest backlog any subscriber has had
+  unsigned int getHighWater() { return high_water.load(); }
+  /// @return the number of messages make or allocOrNew had to build from scratch
+  unsigned long getCreatedCount() { return created_count.load(); }
+
+  std::string getStats()
+  {
+    std::ostringstream oss;
+    oss << (name.empty() ? std::string("(unnamed)") : name)
+        << (ring != NULL ? " ring" : " queue")
+        << " subscribers = " << subscriber_count.load()
+        << " capacity = " << capacity
+        << " policy = " << policyName(policy)
+        << " in flight = " << inFlightCount()
+        << " high water = " << high_water.load()
+        << " drops = " << drop_count.load()
+        << " created = " << created_count.load();
+    return oss.str();
+  }
+
+  ~MultiMBox()
+  {
+    if (ring != NULL)
+      delete ring;
   }
 
   int subscribe()
   {
+    if (ring != NULL)
+    {
+      int subscriber_id = ring->subscribe();
+      if (subscriber_id >= 0)
+      {
+        subscribers.push_back(new Subscriber<T>);
+        subscriber_count++;
+      }
+      return subscriber_id;
+    }
+
     int subscriber_id = subscriber_count;
+    subscribers.push_back(new Subscriber<T>);
     subscriber_count++;
-    subscribers[subscriber_id] = new Subscriber<T>;
+    return subscriber_id;
+  }
+
+  /**
+   * @brief subscribe to a subset of the messages
+   *
+   * put will only post messages whose topic (T::getMBoxTopic) is
+   * accepted by the filter.  Filters are ignored by ring-mode
+   * mailboxes: every ring subscriber sees every message.
+   *
+   * @param filter the topics of interest
+   * @return the subscriber id
+   */
+  int subscribe(const MBoxFilter &filter)
+  {
+    int subscriber_id = subscribe();
+    if ((ring == NULL) && (subscriber_id >= 0))
+    {
+      subscribers[subscriber_id]->filter = new MBoxFilter(filter);
+    }
+    return subscriber_id;
+  }
+
+  /**
+   * @brief subscribe to the most recent message only
+   *
+   * When a new message is put, any messages this subscriber hasn't
+   * read yet are released, so get always returns the newest one.
+   * This suits displays that only care about the current state of
+   * a stream (the spectrum display on the IF stream, for instance).
+   *
+   * @return the subscriber id
+   */
+  int subscribeLatest()
+  {
+    int subscriber_id = subscribe();
+    if (subscriber_id >= 0)
+      subscribers[subscriber_id]->latest_only = true;
     return subscriber_id;
   }
 
   int getSubscriberCount() { return subscriber_count; }
 
-  void put(T *m)
+  /**
+   * @brief tell producers whether this subscriber is doing anything
+   * with the messages it gets.
+   *
+   * An inactive subscriber still receives (and must free) every
+   * message, but producers that check hasActiveSubscriber can avoid
+   * building messages that nobody will look at.
+   *
+   * @param subscriber_id the subscription
+   * @param act true if the subscriber wants messages
+   */
+  void setActive(unsigned int subscriber_id, bool act)
   {
-    unsigned int i;
-    m->setReaderCount(subscriber_count);
-    m->setMBoxTag(this);
-    for (i = 0; i < subscriber_count; i++)
+    if (subscriber_id < subscriber_count)
+      subscribers[subscriber_id]->active.store(act, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief will anybody use the next message?
+   *
+   * @return true if there is at least one active subscriber
+   */
+  bool hasActiveSubscriber()
+  {
+    unsigned int sc = subscriber_count;
+    for (unsigned int i = 0; i < sc; i++)
     {
-      Subscriber<T> *s = subscribers[i];
-      std::lock_guard<std::mutex> lck(s->post_mutex);
-      s->posted_list.push(m);
-      s->post_count++;
-      s->post_cond.notify_all();
+      if (subscribers[i]->active.load(std::memory_order_relaxed))
+        return true;
     }
+    return false;
+  }
+
+  void put(T *m)
+  {
+    m->setMBoxTag(this);
+    if (ring != NULL)
+      putRing(&m, 1);
+    else
+      putQueue(m);
+  }
+
+  bool isReady(unsigned int subscriber_id)
+  {
+    if (subscriber_id >= subscriber_count)
+      return false;
+    if (ring != NULL)
+      return ring->backlog(subscriber_id) != 0;
+
+    Subscriber<T> *s = subscribers[subscriber_id];
+    std::lock_guard<std::mutex> lck(s->post_mutex);
+    return !s->posted_list.empty();
+  }
+
+  void attachWaitSet(unsigned int subscriber_id, WaitSet *ws)
+  {
+    if (subscriber_id < subscriber_count)
+      subscribers[subscriber_id]->waitset.store(ws);
   }
 
   T *get(unsigned int subscriber_id)
   {
+    if (ring != NULL)
+      return ring->get(subscriber_id);
     return getCommon(subscriber_id, false);
   }
 
   T *getWait(unsigned int subscriber_id)
   {
+    if (ring != NULL)
+      return ring->getWait(subscriber_id);
     return getCommon(subscriber_id, true);
   }
 
+  /**
+   * @brief get up to max waiting messages at once.  Doesn't wait.
+   *
+   * @param subscriber_id the subscription
+   * @param out where to put the messages, oldest first
+   * @param max the size of out
+   * @return the number of messages placed in out
+   */
+  unsigned int getBatch(unsigned int subscriber_id, T **out, unsigned int max)
+  {
+    if (ring != NULL)
+      return ring->getBatch(subscriber_id, out, max);
+
+    if (subscriber_id >= subscriber_count)
+      return 0;
+
+    Subscriber<T> *s = subscribers[subscriber_id];
+    unsigned int n = 0;
+    std::lock_guard<std::mutex> lck(s->post_mutex);
+    while ((n < max) && !s->posted_list.empty())
+    {
+      out[n++] = s->posted_list.front();
+      s->posted_list.pop();
+      s->post_count--;
+    }
+    if ((n != 0) && (policy == BLOCK))
+      s->space_cond.notify_all();
+    return n;
+  }
+
   void free(T *m)
   {
-    if (m != NULL)
+    if (m == NULL)
+      return;
+
+    // the last reader out gets to recycle the message.
+    if (m->releaseReader())
+      recycle(m);
+  }
+
+  /**
+   * @brief free several messages, returning them to the pool in one step.
+   *
+   * @param in the messages (NULL entries are ignored)
+   * @param n the number of entries in "in"
+   */
+  void freeBatch(T **in, unsigned int n)
+  {
+    T *first = NULL, *last = NULL;
+    for (unsigned int i = 0; i < n; i++)
     {
-      if (keep_freelist && m->checkMBoxTag(this))
+      T *m = in[i];
+      if ((m == NULL) || !m->releaseReader())
+        continue;
+      if (!keep_freelist || !m->checkMBoxTag(this))
       {
-        if (m->readyToDie())
-        {
-          std::lock_guard<std::mutex> lck(free_mutex);
-          m->free(free_list);
-        }
-        else
-          m->decReaderCount();
+        delete m;
+        continue;
       }
+      // chain the survivors together through free_link
+      m->free_link = NULL;
+      if (last == NULL)
+        first = m;
       else
-      {
-        if (m->readyToDie())
-          delete m;
-        else
-          m->decReaderCount();
-      }
+        last->free_link = m;
+      last = m;
     }
+    if (first != NULL)
+      recycleChain(first, last);
   }
 
   T *alloc()
   {
+    if (!keep_freelist)
+      return NULL;
+
+    if (ring != NULL)
+      return ring->popFree();
+
     T *ret = NULL;
     std::lock_guard<std::mutex> lck(free_mutex);
-    if (!free_list.empty() && keep_freelist)
+    if (!free_list.empty())
     {
       ret = (T *)free_list.front();
       free_list.pop();
@@ -191,10 +602,75 @@ public:
     return ret;
   }
 
+  /**
+   * @brief get a message from the pool (or the heap, if the pool is
+   * empty) and construct it in place.
+   *
+   * This is the allocation-free replacement for put(new T(...)):
+   * \code
+   *   cmd_stream->put(cmd_stream->make(Command::REP, Command::TX_STATE, 1));
+   * \endcode
+   *
+   * @param args the arguments for the T constructor
+   * @return a freshly constructed message owned by this mailbox
+   */
+  template <typename... Args>
+  T *make(Args &&... args)
+  {
+    T *ret = alloc();
+    if (ret == NULL)
+    {
+      created_count++;
+      return new T(std::forward<Args>(args)...);
+    }
+
+    ret->~T();
+    return new (ret) T(std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief get a message from the pool, or build a new one if the
+   * pool is empty.
+   *
+   * Unlike make, a recycled message is returned as-is -- this is
+   * the right call for buffers (SoDa::Buf) whose storage we want to
+   * keep rather than rebuild.
+   *
+   * @param args the arguments for the T constructor, used only if the pool is empty
+   * @return a message owned by this mailbox
+   */
+  template <typename... Args>
+  T *allocOrNew(Args &&... args)
+  {
+    T *ret = alloc();
+    if (ret == NULL)
+    {
+      created_count++;
+      ret = new T(std::forward<Args>(args)...);
+    }
+    return ret;
+  }
+
+  /**
+   * @brief limit the number of recycled messages we keep around.
+   *
+   * Only meaningful for queue-mode mailboxes.  Messages freed past
+   * the limit are deleted -- this keeps the pool from growing without
+   * bound when some producers still use "new" rather than make.
+   *
+   * @param lim the largest pool we'll keep (0 means no limit)
+   */
+  void setPoolLimit(unsigned int lim) { pool_limit = lim; }
+
   void addToPool(T *v)
   {
     if (keep_freelist)
     {
+      if (ring != NULL)
+      {
+        ring->pushFree(v);
+        return;
+      }
       std::lock_guard<std::mutex> lck(free_mutex);
       free_list.push(v);
     }
@@ -202,14 +678,16 @@ public:
 
   unsigned int inFlightCount()
   {
+    if (ring != NULL)
+      return ring->maxBacklog();
+
     // go through the subscribers and find the
     // longest inflight list.
     int max_len = 0;
     int itercount = 0;
 
-    for (auto &sl : subscribers)
+    for (auto s : subscribers)
     {
-      Subscriber<T> *s = sl.second;
       {
         std::lock_guard<std::mutex> lck(s->post_mutex);
         int le = s->posted_list.size();
@@ -233,7 +711,7 @@ public:
   bool flush(unsigned int subscriber_id)
   {
     T *dummy;
-    while ((dummy = getCommon(subscriber_id, false)) != NULL)
+    while ((dummy = get(subscriber_id)) != NULL)
     {
       free(dummy);
     }
@@ -241,6 +719,273 @@ public:
   }
 
 private:
+  void putRing(T **in, unsigned int n)
+  {
+    unsigned int sc = ring->getSubscriberCount();
+    if (sc == 0)
+    {
+      // nobody is listening -- recycle the messages now.
+      for (unsigned int k = 0; k < n; k++)
+        recycle(in[k]);
+      return;
+    }
+
+    unsigned int i;
+    bool pending = false; // published, but nobody has been told
+    for (unsigned int k = 0; k < n; k++)
+    {
+      T *m = in[k];
+      if ((policy == DROP_NEWEST) && (ring->maxBacklog() >= capacity))
+      {
+        drop_count++;
+        recycle(m);
+        continue;
+      }
+
+      // latest-only subscribers give up everything they haven't read.
+      for (i = 0; i < sc; i++)
+      {
+        if (!subscribers[i]->latest_only)
+          continue;
+        T *old;
+        while ((old = ring->skip(i)) != NULL)
+          free(old);
+      }
+
+      if ((policy == DROP_OLDEST) || (policy == CONFLATE))
+      {
+        // make room: release the skipped messages on behalf of
+        // the subscribers that fell behind.
+        for (i = 0; i < sc; i++)
+        {
+          T *old;
+          while ((ring->backlog(i) >= capacity) && ((old = ring->skip(i)) != NULL))
+          {
+            drop_count++;
+            free(old);
+          }
+        }
+      }
+      else if (pending && (ring->maxBacklog() >= capacity))
+      {
+        // we're about to wait for a slow subscriber -- it may be
+        // asleep in a WaitSet, so tell it about what we've got so far.
+        notifyRing(sc);
+        pending = false;
+      }
+
+      m->setReaderCount(sc);
+      ring->publish(m, capacity);
+      pending = true;
+    }
+
+    if (pending)
+    {
+      noteBacklog(ring->maxBacklog());
+      notifyRing(sc);
+    }
+  }
+
+  void notifyRing(unsigned int sc)
+  {
+    ring->wake();
+    for (unsigned int i = 0; i < sc; i++)
+    {
+      WaitSet *ws = subscribers[i]->waitset.load();
+      if (ws != NULL)
+        ws->notify();
+    }
+  }
+
+  void putQueue(T *m)
+  {
+    unsigned int i;
+    unsigned int sc = subscriber_count;
+
+    // count the interested readers before anyone can see the message.
+    unsigned int topic = m->getMBoxTopic();
+    unsigned int rc = 0;
+    for (i = 0; i < sc; i++)
+    {
+      if (subscribers[i]->accepts(topic))
+        rc++;
+    }
+    if (rc == 0)
+    {
+      recycle(m);
+      return;
+    }
+    // hold an extra reference while we post, so that a subscriber
+    // that drops the message can't recycle it out from under us.
+    m->setReaderCount(rc + 1);
+
+    DropList dropped;
+    for (i = 0; i < sc; i++)
+    {
+      Subscriber<T> *s = subscribers[i];
+      if (!s->accepts(topic))
+        continue;
+      bool posted;
+      {
+        std::unique_lock<std::mutex> lck(s->post_mutex);
+        posted = postLocked(s, m, lck, dropped);
+        if (posted)
+          s->post_cond.notify_all();
+      }
+      if (posted)
+      {
+        WaitSet *ws = s->waitset.load();
+        if (ws != NULL)
+          ws->notify();
+      }
+    }
+
+    // free outside the subscriber locks
+    freeBatch(dropped.msgs, dropped.count);
+    // and drop our own reference
+    free(m);
+  }
+
+  /**
+   * @brief the messages a put pushes out of subscriber queues.  It
+   * lives on the producer's stack, so a put never touches the heap.
+   */
+  struct DropList
+  {
+    static const unsigned int max_drops = 16;
+    T *msgs[max_drops];
+    unsigned int count = 0;
+  };
+
+  void addDrop(DropList &dl, T *m)
+  {
+    // a full list is freed on the spot.  That's rare, and safe under
+    // a subscriber's lock -- recycle never takes a post_mutex.
+    if (dl.count == DropList::max_drops)
+    {
+      freeBatch(dl.msgs, dl.count);
+      dl.count = 0;
+    }
+    dl.msgs[dl.count++] = m;
+  }
+
+  /**
+   * @brief post one message to a subscriber, applying the overflow
+   * policy.  The caller holds the subscriber's post_mutex.
+   *
+   * @return true if the message was posted
+   */
+  bool postLocked(Subscriber<T> *s, T *m, std::unique_lock<std::mutex> &lck, DropList &dropped)
+  {
+    if (s->latest_only)
+    {
+      while (!s->posted_list.empty())
+      {
+        addDrop(dropped, s->posted_list.front());
+        s->posted_list.pop();
+        s->post_count--;
+      }
+    }
+    else if ((capacity != 0) && (s->posted_list.size() >= capacity))
+    {
+      if (policy == BLOCK)
+      {
+        // the subscriber may be asleep -- it must hear about
+        // what has been posted to it so far.
+        s->post_cond.notify_all();
+        WaitSet *ws = s->waitset.load();
+        if (ws != NULL)
+          ws->notify();
+        while (s->posted_list.size() >= capacity)
+          s->space_cond.wait(lck);
+      }
+      else if (policy == DROP_NEWEST)
+      {
+        drop_count++;
+        addDrop(dropped, m);
+        return false;
+      }
+      else
+      {
+        while (s->posted_list.size() >= capacity)
+        {
+          drop_count++;
+          addDrop(dropped, s->posted_list.front());
+          s->posted_list.pop();
+          s->post_count--;
+        }
+      }
+    }
+    s->posted_list.push(m);
+    s->post_count++;
+    noteBacklog(s->posted_list.size());
+    return true;
+  }
+
+  void noteBacklog(unsigned int depth)
+  {
+    unsigned int hw = high_water.load(std::memory_order_relaxed);
+    while ((depth > hw) && !high_water.compare_exchange_weak(hw, depth))
+      ;
+  }
+
+  /**
+   * @brief put a message that nobody is reading back in the pool, or
+   * delete it if it isn't ours or we don't keep a pool.
+   */
+  void recycle(T *m)
+  {
+    if (keep_freelist && m->checkMBoxTag(this))
+    {
+      if (ring != NULL)
+      {
+        ring->pushFree(m);
+      }
+      else
+      {
+        std::unique_lock<std::mutex> lck(free_mutex);
+        if ((pool_limit == 0) || (free_list.size() < pool_limit))
+        {
+          free_list.push(m);
+        }
+        else
+        {
+          lck.unlock();
+          delete m;
+        }
+      }
+    }
+    else
+    {
+      delete m;
+    }
+  }
+
+  /**
+   * @brief put a chain of messages that nobody is reading back in
+   * the pool.  They are all ours, and we keep a pool.
+   */
+  void recycleChain(T *first, T *last)
+  {
+    if (ring != NULL)
+    {
+      ring->pushFreeChain(first, last);
+      return;
+    }
+
+    std::unique_lock<std::mutex> lck(free_mutex);
+    T *m = first;
+    while (m != NULL)
+    {
+      T *nxt = (T *)m->free_link;
+      if ((pool_limit == 0) || (free_list.size() < pool_limit))
+        free_list.push(m);
+      else
+        delete m;
+      m = nxt;
+    }
+  }
+
   T *getCommon(unsigned int subscriber_id, bool wait)
   {
     if (subscriber_id >= subscriber_count)
@@ -274,13 +1019,24 @@ private:
     ret = s->posted_list.front();
     s->posted_list.pop();
     s->post_count--;
+    if (policy == BLOCK)
+      s->space_cond.notify_all();
     return ret;
   }
 
-  unsigned int subscriber_count;
+  std::atomic<unsigned int> subscriber_count;
   bool keep_freelist;
+  unsigned int pool_limit; ///< in queue mode, keep no more than this many free messages
+
+  unsigned int capacity;                 ///< most unread messages per subscriber (0 == no limit)
+  OverflowPolicy policy;                 ///< what to do when a subscriber is at capacity
+  std::atomic<unsigned long> drop_count; ///< messages discarded by the policy
+  std::atomic<unsigned int> high_water;  ///< deepest backlog seen by put
+  std::atomic<unsigned long> created_count; ///< messages built by make/allocOrNew
+
+  BroadcastRing<T> *ring; ///< if not NULL, we're a lock-free broadcast ring
 
-  std::map<int, Subscriber<T> *> subscribers;
+  std::vector<Subscriber<T> *> subscribers;
 
   std::queue<MBoxMessage *> free_list;
   std::mutex free_mutex;
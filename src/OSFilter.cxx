@@ -27,11 +27,14 @@
 */
 
 #include "OSFilter.hxx"
+#include "FFTPlanner.hxx"
+#include "VecOps.hxx"
 
 #include <iostream>
 #include <string.h>
 #include <fftw3.h>
 #include <math.h>
+#include <vector>
 
 static unsigned int ipow(unsigned int x, unsigned int y)
 {
@@ -53,14 +56,73 @@ SoDa::OSFilter::OSFilter(float * filter_impulse_response,
 			 OSFilter * cascade, 
 			 unsigned int suggested_transform_length)
 {
+  std::vector<std::complex<float> > h(filter_impulse_response, 
+				     filter_impulse_response + filter_length);
+  buildFromImpulse(h.data(), filter_length, filter_gain, inout_buffer_length, 
+		   cascade, suggested_transform_length);
+}
+
+SoDa::OSFilter::OSFilter(std::complex<float> * filter_impulse_response,
+			 unsigned int filter_length,
+			 float filter_gain, 
+			 unsigned int inout_buffer_length,
+			 OSFilter * cascade, 
+			 unsigned int suggested_transform_length)
+{
+  buildFromImpulse(filter_impulse_response, filter_length, filter_gain, inout_buffer_length, 
+		   cascade, suggested_transform_length);
+}
+
+void SoDa::OSFilter::buildFromImpulse(const std::complex<float> * filter_impulse_response,
+				      unsigned int filter_length,
+				      float filter_gain, 
+				      unsigned int inout_buffer_length,
+				      OSFilter * cascade, 
+				      unsigned int suggested_transform_length)
+{
+  unsigned int i, j; 
   // these are the salient dimensions for this Overlap/Save
   // widget (for terminology, see Lyons pages 719ff
-  Q = filter_length; // to start with. 
   M = inout_buffer_length;
 
   if((cascade != NULL) && (cascade->M != M)) cascade = NULL;
 
-  if(M < 4 * Q) {
+  // The cascade's image is already scaled by 1/N, so the (unscaled)
+  // inverse transform gives us back its impulse response.  Its taps
+  // are all in the first Q slots.  Convolve that with our response
+  // -- multiplying the two images at the cascade's N would wrap the
+  // tail of the result around onto the front.
+  std::vector<std::complex<double> > h; 
+  if(cascade != NULL) {
+    std::complex<float> * cimp = (std::complex<float> *) fftwf_malloc(sizeof(std::complex<float>) * cascade->N);
+    fftwf_plan cplan = SoDa::FFTPlanner::planDFT(cascade->N, cascade->filter_fft, cimp,
+						 FFTW_BACKWARD, true);
+    fftwf_execute(cplan);
+    SoDa::FFTPlanner::destroyPlan(cplan);
+
+    h.assign(filter_length + cascade->Q - 1, std::complex<double>(0.0, 0.0));
+    for(i = 0; i < filter_length; i++) {
+      std::complex<double> a = filter_impulse_response[i];
+      for(j = 0; j < cascade->Q; j++) {
+	h[i + j] += a * std::complex<double>(cimp[j]);
+      }
+    }
+    fftwf_free(cimp);
+
+    low_edge = cascade->low_edge;
+    high_edge = cascade->high_edge; 
+  }
+  else {
+    h.assign(filter_impulse_response, filter_impulse_response + filter_length);
+    low_edge = high_edge = 0.0; 
+  }
+
+  Q = h.size(); // to start with. 
+
+  // A cascade is long on purpose -- the fused SSB filters are about
+  // 960 taps against a 2304 sample audio buffer.  Only complain when
+  // most of each transform would be overlap.
+  if(M < Q) {
     std::cerr << "Warning -- OSFilter asked to implement a long filter against a short buffer." << std::endl;
   }
   
@@ -82,36 +144,21 @@ SoDa::OSFilter::OSFilter(float * filter_impulse_response,
   filter_fft = (std::complex<float> *) fftwf_malloc(sizeof(std::complex<float>) * N);
   
   // create a temporary plan
-  fftwf_plan tplan = fftwf_plan_dft_1d(N, (fftwf_complex*) filter_in, (fftwf_complex*) filter_fft,
-				       FFTW_FORWARD, FFTW_ESTIMATE);
+  fftwf_plan tplan = SoDa::FFTPlanner::planDFT(N, filter_in, filter_fft, FFTW_FORWARD, true);
   
   // now build the filter
   // fill with zeros
-  unsigned int i; 
   for(i = 0; i < N; i++) filter_in[i] = std::complex<float>(0.0,0.0);
   // fill in the impulse response
-  float gain_corr = 1.0 / ((float) N) * filter_gain;
-  for(i = 0; i < filter_length; i++) filter_in[i] = std::complex<float>(filter_impulse_response[i] * gain_corr, 0.0);
+  double gain_corr = 1.0 / ((double) N) * filter_gain;
+  for(i = 0; i < h.size(); i++) filter_in[i] = std::complex<float>(h[i] * gain_corr);
   
   // transform the filter. 
   fftwf_execute(tplan);
 
   // and forget the plan. 
-  fftwf_destroy_plan(tplan);
-
-  // filter lengths must be equal too
-  if((cascade != NULL) && (cascade->N != N)) cascade = NULL;
-
-  // if there is a cascaded filter, multiply our filter coeffs by the cascaded filter coeffs
-  if(cascade != NULL) {
-    for(i = 0; i < N; i++) {
-      std::complex<double> a = filter_fft[i];
-      std::complex<double> b = cascade->filter_fft[i];
-      std::complex<double> ff = a * b * ((double) N); 
-      filter_fft[i] = std::complex<float>(ff.real(), ff.imag()); 
-    }
-  }
-  
+  SoDa::FFTPlanner::destroyPlan(tplan);
+  fftwf_free(filter_in);
   
   // setup the fft buffers
   setupFFT();
@@ -163,10 +210,8 @@ SoDa::OSFilter::OSFilter(float low_cutoff,
   filter_in[Q/2] = std::complex<float>(1.0, 0.0);
   // we'll use the image of this filter for the phase part of our filter.
   
-  fftwf_plan fplan = fftwf_plan_dft_1d(N, (fftwf_complex *) filter_in, (fftwf_complex *) filter_fft,
-				       FFTW_FORWARD, FFTW_ESTIMATE);
-  fftwf_plan ifplan = fftwf_plan_dft_1d(N, (fftwf_complex *) filter_fft, (fftwf_complex *) filter_in,
-				       FFTW_BACKWARD, FFTW_ESTIMATE);					
+  fftwf_plan fplan = SoDa::FFTPlanner::planDFT(N, filter_in, filter_fft, FFTW_FORWARD, true);
+  fftwf_plan ifplan = SoDa::FFTPlanner::planDFT(N, filter_fft, filter_in, FFTW_BACKWARD, true);
 
   // create an image that we can fill in.
   fftwf_execute(fplan);
@@ -230,8 +275,8 @@ SoDa::OSFilter::OSFilter(float low_cutoff,
   }
 
   // and destroy the plans
-  fftwf_destroy_plan(fplan); 
-  fftwf_destroy_plan(ifplan); 
+  SoDa::FFTPlanner::destroyPlan(fplan); 
+  SoDa::FFTPlanner::destroyPlan(ifplan); 
 
   // and free the impulse response
   fftwf_free(filter_in);
@@ -277,52 +322,87 @@ void SoDa::OSFilter::setupFFT()
   fft_output = (std::complex<float> *) fftwf_malloc(sizeof(std::complex<float>) * N);
   ifft_output = (std::complex<float> *) fftwf_malloc(sizeof(std::complex<float>) * N);
   
-  // and create the plans
-  forward_plan = fftwf_plan_dft_1d(N,
-				   (fftwf_complex *) fft_input,
-				   (fftwf_complex *) fft_output,
-				   FFTW_FORWARD, FFTW_ESTIMATE);
-  backward_plan = fftwf_plan_dft_1d(N,
-				    (fftwf_complex *) fft_output,
-				    (fftwf_complex *) ifft_output,
-				    FFTW_BACKWARD, FFTW_ESTIMATE);
-
-  // zero out the start of the fft_input buffer for the first iteration.
-  for(i = 0; i < Q-1; i++) fft_input[i] = std::complex<float>(0.0,0.0);
+  // and create the plans -- these run on every buffer, so
+  // they come from the (measuring) planner.
+  forward_plan = SoDa::FFTPlanner::planDFT(N, fft_input, fft_output, FFTW_FORWARD);
+  backward_plan = SoDa::FFTPlanner::planDFT(N, fft_output, ifft_output, FFTW_BACKWARD);
+
+  // zero out the fft_input buffer for the first iteration.
+  // (M + Q - 1 can be one short of N -- the last element is never
+  // written, so it had better start out as zero.)
+  for(i = 0; i < N; i++) fft_input[i] = std::complex<float>(0.0,0.0);
+
+  // the real path is planned when somebody asks for it.
+  r_forward_plan = r_backward_plan = NULL; 
+}
 
+void SoDa::OSFilter::setupRealFFT()
+{
+  unsigned int i;
+  unsigned int NH = N / 2 + 1; 
+  r_fft_input = (float *) fftwf_malloc(sizeof(float) * N);
+  r_fft_output = (std::complex<float> *) fftwf_malloc(sizeof(std::complex<float>) * NH);
+  r_ifft_output = (float *) fftwf_malloc(sizeof(float) * N);
+  filter_fft_half = (std::complex<float> *) fftwf_malloc(sizeof(std::complex<float>) * NH);
+
+  // The complex path keeps only the real part of its output.  For a
+  // real input X[k] = conj(X[N-k]), so that real part is the inverse
+  // transform of X times the hermitian part of the filter image:
+  //    H'[k] = (H[k] + conj(H[N-k])) / 2
+  // and the c2r transform needs only bins 0..N/2 of that. 
+  for(i = 0; i < NH; i++) {
+    std::complex<float> hk = filter_fft[i];
+    std::complex<float> hnk = filter_fft[(N - i) % N];
+    filter_fft_half[i] = 0.5f * (hk + std::conj(hnk)); 
+  }
+
+  r_forward_plan = SoDa::FFTPlanner::planR2C(N, r_fft_input, r_fft_output);
+  r_backward_plan = SoDa::FFTPlanner::planC2R(N, r_fft_output, r_ifft_output);
+
+  for(i = 0; i < N; i++) r_fft_input[i] = 0.0;
 }
 
 unsigned int SoDa::OSFilter::apply(float * inbuf, float * outbuf, float outgain, int instride, int outstride)
 {
   unsigned int i, j;
+  planRealPath();
+  
   // copy the input buffer.
-  for(i = 0, j = Q-1; i < (M * instride); i += instride, j++) {
-    fft_input[j] = std::complex<float>(inbuf[i], 0.0); 
+  if(instride == 1) {
+    memcpy(&(r_fft_input[Q-1]), inbuf, sizeof(float) * M);
+  }
+  else {
+    for(i = 0, j = Q-1; i < (M * instride); i += instride, j++) {
+      r_fft_input[j] = inbuf[i]; 
+    }
   }
   
   // now do the forward FFT on the input
-  fftwf_execute(forward_plan);
+  fftwf_execute(r_forward_plan);
 
   // save the last bits of the input buffer to the Q-1 side of the FFT input vector
   // Do this now incase in buf and outbuf are the same buffers.  (we're going to
   // over-write most of outbuf with the memcpy at the bottom.... )
   for(i = (tail_index * instride), j = 0; j < Q-1; i += instride, j++) {
-    fft_input[j] = std::complex<float>(inbuf[i], 0.0);
+    r_fft_input[j] = inbuf[i];
   }
 
-  // apply the filter.
-  for(i = 0; i < N; i++) {
-    fft_output[i] = (fft_output[i] * filter_fft[i]) * outgain; 
-  }
+  // apply the filter -- only the non-negative frequencies
+  unsigned int NH = N / 2 + 1; 
+  SoDa::VecOps::cmulScale(r_fft_output, r_fft_output, filter_fft_half, outgain, NH);
   
   // now do the backward FFT on the result
-  fftwf_execute(backward_plan);
-
+  fftwf_execute(r_backward_plan);
 
   // and copy the result to the output buffer, but discard the
   // first Q-1 chunks
-  for(i = 0, j = Q-1; i < (M * outstride); i += outstride, j++) {
-    outbuf[i] = ifft_output[j].real();
+  if(outstride == 1) {
+    memcpy(outbuf, &(r_ifft_output[Q-1]), sizeof(float) * M);
+  }
+  else {
+    for(i = 0, j = Q-1; i < (M * outstride); i += outstride, j++) {
+      outbuf[i] = r_ifft_output[j];
+    }
   }
 
   return M; 
@@ -344,9 +424,7 @@ unsigned int SoDa::OSFilter::apply(std::complex<float> * inbuf, std::complex<flo
 
   // apply the filter.
   unsigned int i;
-  for(i = 0; i < N; i++) {
-    fft_output[i] = (fft_output[i] * filter_fft[i]) * outgain; 
-  }
+  SoDa::VecOps::cmulScale(fft_output, fft_output, filter_fft, outgain, N);
   
   // now do the backward FFT on the result
   fftwf_execute(backward_plan);
@@ -54,6 +54,10 @@ namespace SoDa {
     /// constructor
     /// Build the filter from the time domain FIR filter sequence CASCADED with the filter
     /// specified by the [cascade] parameter
+    ///
+    /// The two impulse responses are convolved, and the transform
+    /// length is picked to hold the result, so the cascade filter
+    /// may have any transform length. 
     /// @param filter_impulse_response time domain FIR filter coefficient array -- real
     /// @param filter_length number of filter taps
     /// @param filter_gain desired gain in passband
@@ -66,6 +70,25 @@ namespace SoDa {
 	     unsigned int inout_buffer_length,
 	     OSFilter * cascade = NULL,
 	     unsigned int suggested_transform_length = 0);
+
+    /// constructor
+    /// Build the filter from a complex time domain FIR filter sequence,
+    /// CASCADED with the filter specified by the [cascade] parameter.
+    /// A complex impulse response can treat positive and negative
+    /// frequencies differently -- a sideband selector, for instance.
+    /// Only the complex apply makes sense for these.
+    /// @param filter_impulse_response time domain FIR filter coefficient array -- complex
+    /// @param filter_length number of filter taps
+    /// @param filter_gain desired gain in passband
+    /// @param inout_buffer_length used to set aside storage for overlap and save buffer
+    /// @param cascade use this filter as a "prefilter" if the inout_buffer_lengths are equal
+    /// @param suggested_transform_length a hint for optimizing FFT operations
+    OSFilter(std::complex<float> * filter_impulse_response,
+	     unsigned int filter_length,
+	     float filter_gain, 
+	     unsigned int inout_buffer_length,
+	     OSFilter * cascade = NULL,
+	     unsigned int suggested_transform_length = 0);
     
     /// constructor
     /// Build the filter from a filter spec for a bandpass filter
@@ -99,6 +122,12 @@ namespace SoDa {
     unsigned int apply(std::complex<float> * inbuf, std::complex<float> * outbuf, float outgain = 1.0);
 
     /// run the filter on a real input stream
+    ///
+    /// This uses real-to-complex and complex-to-real transforms, so
+    /// it only does half the work of the complex apply.  A filter
+    /// object keeps separate overlap history for the real and
+    /// complex paths -- don't mix the two on one filter.
+    ///
     /// @param inbuf the input buffer samples
     /// @param outbuf the output buffer samples (this can overlap the inbuf vector)
     /// @param outgain normalized output gain
@@ -108,6 +137,14 @@ namespace SoDa {
     unsigned int apply(float * inbuf, float * outbuf, float outgain = 1.0,
 		       int instride = 1, int outstride = 1);
 
+    /// plan the r2c/c2r transforms for the real apply now.
+    ///
+    /// Filters that only see complex data never need them, so they
+    /// aren't made until the first real apply.  Owners of filters
+    /// that will run on real data should call this at setup time, so
+    /// the planner doesn't measure on the first buffer.
+    void planRealPath() { if(r_forward_plan == NULL) setupRealFFT(); }
+
     /// dump the filter FFT to the output stream
     /// @param os an output stream. 
     void dump(std::ostream & os);
@@ -120,9 +157,19 @@ namespace SoDa {
     /// parameters that we keep to support display masks on the spectrogram
     double low_edge, high_edge; 
 
+    /// build the filter image from an impulse response (and a cascade)
+    void buildFromImpulse(const std::complex<float> * filter_impulse_response,
+			  unsigned int filter_length,
+			  float filter_gain, 
+			  unsigned int inout_buffer_length,
+			  OSFilter * cascade,
+			  unsigned int suggested_transform_length);
+    
     /// pick a likely N - FFT length.
     int guessN();
     void setupFFT();
+    /// build the half-spectrum filter image and the r2c/c2r plans
+    void setupRealFFT();
 
     
     
@@ -146,6 +193,13 @@ namespace SoDa {
     // each filter needs two plans, a forward and backward
     // plan for the FFT and IFFT
     fftwf_plan forward_plan, backward_plan; ///< plans for fftw transform ops
+
+    // the real-signal path works on the N/2+1 non-negative frequency bins
+    float * r_fft_input;  ///< a copy of the real input stream.
+    std::complex<float> * r_fft_output; ///< the transformed input (N/2+1 bins)
+    float * r_ifft_output;  ///< the real output stream + overlap discard
+    std::complex<float> * filter_fft_half;  ///< hermitian part of filter_fft, bins 0..N/2
+    fftwf_plan r_forward_plan, r_backward_plan; ///< r2c and c2r plans (NULL until planRealPath)
   };
 }
 
@@ -30,6 +30,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <iostream>
 #include <stdlib.h>
 #include <SoDa/Utils.hxx>
+#include <sched.h>
 
 SoDa::Params::Params(int argc, char * argv[])
 {
@@ -52,19 +53,55 @@ SoDa::Params::Params(int argc, char * argv[])
     .add<unsigned int>(&debug_level, "debug", 'D', 0,
      "Enable debug messages for value > 0.  Higher values may produce more detail.")
     .add<std::string>(&radio_type, "radio", 'r', "USRP", 
-     "the radio type (USRP, Lime)")
+     "the radio type (USRP, Lime, FILE, SIM)")
+    .add<std::string>(&replay_filename, "replay", 'f', "", 
+     "for --radio FILE: an IF recording (from RF_RECORD_START) to play as the RX stream")
+    .addP(&replay_fast, "replay-fast", 'x', 
+     "for --radio FILE or SIM: play as fast as the receiver can keep up, rather than in real time")
+    .addP(&replay_loop, "replay-loop", 'y', 
+     "for --radio FILE: start over at the end of the recording, rather than stopping the server")
+    .add<double>(&replay_lo3, "replay-lo3", 'z', 100.0e3, 
+     "for --radio FILE: the 3rd LO setting when an old recording (one without a magic word) was made")
+    .addV<std::string>(&sim_list, "sim", 's', 
+     "for --radio SIM: a test signal KIND:key=val,... KIND is noise, tone, cw, am, fm, sweep, or loopback")
+    .add<std::string>(&tx_sink_filename, "txsink", 'o', "", 
+     "for radios without hardware: write the TX stream to this file (same format as an IF recording)")
     .add<std::string>(&gps_hostname, "gps_host", 'G', "localhost", 
      "hostname for gpsd server")
     .add<std::string>(&gps_portname, "gps_port", 'g', "2947",
      "port number for gpsd server")
     .add<std::string>(&lock_file_name, "lockfile", 'L', "SoDa.lock", 
      "lock file to signal that a sodaradio server is active")
+    .add<unsigned int>(&buf_arena_slots, "bufarena", 'B', 64, 
+     "number of RF sample buffers to preallocate in one aligned region (0 for none)")
+    .addP(&no_huge_pages, "nohuge", 'H', 
+     "don't ask for huge pages for the RF sample buffer region")
+    .addV<std::string>(&thread_sched_list, "rtsched", 'R', 
+     "thread placement: NAME:cpus=2+3,policy=fifo|rr|other,prio=N  (NAME is a thread name or *)")
+    .addP(&lock_memory, "mlock", 'M', 
+     "lock all server memory (mlockall) so the DSP threads never page fault")
+    .add<std::string>(&fft_wisdom_file, "fftwisdom", 'W', "~/.soda/fftw_wisdom", 
+     "FFTW wisdom file -- loaded at startup, updated at exit")
+    .add<std::string>(&fft_plan_effort, "fftplan", 'E', "measure", 
+     "FFT planning effort: estimate, measure, or patient")
+    .add<double>(&fft_plan_time_limit, "plantime", 'T', 10.0, 
+     "most seconds to spend planning any one FFT")
+    .addP(&plan_only, "plan-only", 'P', 
+     "build the FFT plans for this configuration, save the wisdom, and exit")
     ;
 
 
   // do we need a help message?
   if(!cmd.parse(argc, argv)) exit(-1);
 
+  for(auto & ts : thread_sched_list) {
+    if(!parseThreadSched(ts)) {
+      std::cerr << "Bad --rtsched setting [" << ts << "]\n"
+		<< "  expected NAME:cpus=2+3,policy=fifo|rr|other,prio=N\n";
+      exit(-1);
+    }
+  }
+
   // set the present variables
   if(!force_integer_N_mode && !force_frac_N_mode) {
     force_integer_N_mode = true; 
@@ -91,3 +128,44 @@ const std::vector<std::string> & SoDa::Params::getLibs() {
   load_list_env_appended = true;
   return load_list; 
 }
+
+bool SoDa::Params::parseThreadSched(const std::string & spec_str)
+{
+  size_t colon = spec_str.find(':');
+  if((colon == std::string::npos) || (colon == 0)) return false; 
+  std::string tname = spec_str.substr(0, colon); 
+
+  ThreadSchedSpec spec; 
+  for(auto & field : SoDa::split(spec_str.substr(colon + 1), ",")) {
+    size_t eq = field.find('=');
+    if(eq == std::string::npos) return false; 
+    std::string key = field.substr(0, eq);
+    std::string val = field.substr(eq + 1);
+    std::transform(val.begin(), val.end(), val.begin(), ::tolower);
+    if(key == "cpus") {
+      for(auto & c : SoDa::split(val, "+")) {
+	char * endp; 
+	long cpu = strtol(c.c_str(), &endp, 10);
+	if((*endp != '\0') || (cpu < 0)) return false; 
+	spec.cpus.push_back((int) cpu); 
+      }
+    }
+    else if(key == "policy") {
+      if(val == "fifo") spec.policy = SCHED_FIFO;
+      else if(val == "rr") spec.policy = SCHED_RR;
+      else if(val == "other") spec.policy = SCHED_OTHER;
+      else return false; 
+    }
+    else if(key == "prio") {
+      char * endp; 
+      spec.priority = (int) strtol(val.c_str(), &endp, 10);
+      if(*endp != '\0') return false; 
+    }
+    else {
+      return false; 
+    }
+  }
+
+  thread_sched_map[tname] = spec;
+  return true; 
+}
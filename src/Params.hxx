@@ -34,8 +34,19 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <algorithm>
 #include <iostream>
 #include <vector>
+#include <map>
 
 namespace SoDa {
+  /**
+   * @brief CPU placement and scheduling settings for one thread
+   */
+  struct ThreadSchedSpec {
+    ThreadSchedSpec() : policy(-1), priority(0) { }
+    std::vector<int> cpus; ///< run only on these cores (empty means anywhere)
+    int policy;            ///< SCHED_FIFO, SCHED_RR, SCHED_OTHER or -1 to leave it alone
+    int priority;          ///< sched priority for FIFO and RR
+  };
+
   /**
    * This class handles command line parameters and built-ins. 
    */
@@ -115,6 +126,98 @@ namespace SoDa {
 
     std::string getLockFileName() const { return lock_file_name; }
 
+    /**
+     * @brief how many RF buffers should we preallocate in the sample arena?
+     * @return number of getRFBufferSize() slots (0 means don't build an arena)
+     */
+    unsigned int getBufArenaSlots() const { return buf_arena_slots; }
+
+    /**
+     * @brief should the sample arena ask for huge pages?
+     */
+    bool useHugePages() const { return !no_huge_pages; }
+
+    /**
+     * @brief find the affinity/scheduling settings for a thread
+     *
+     * Settings come from --rtsched options of the form
+     * NAME:cpus=2+3,policy=fifo,prio=40 where NAME is the thread's
+     * object name (BaseBandRX, USRPRX, UI...) or "*" for every
+     * thread that isn't named explicitly.
+     *
+     * @param thread_name the object name of the thread
+     * @param spec filled in with the settings
+     * @return true if there are settings for this thread
+     */
+    bool getThreadSched(const std::string & thread_name, ThreadSchedSpec & spec) const {
+      auto it = thread_sched_map.find(thread_name);
+      if(it == thread_sched_map.end()) it = thread_sched_map.find("*");
+      if(it == thread_sched_map.end()) return false; 
+      spec = it->second; 
+      return true; 
+    }
+
+    /**
+     * @brief should the server lock its pages in memory?
+     */
+    bool lockMemory() const { return lock_memory; }
+
+    /**
+     * @brief where do we keep FFTW wisdom between runs?
+     */
+    std::string getFFTWisdomFile() const { return fft_wisdom_file; }
+
+    /**
+     * @brief how hard should FFTW look for a fast plan?
+     * @return estimate, measure, or patient
+     */
+    std::string getFFTPlanEffort() const { return fft_plan_effort; }
+
+    /**
+     * @brief the most seconds FFTW may spend planning one transform
+     */
+    double getFFTPlanTimeLimit() const { return fft_plan_time_limit; }
+
+    /**
+     * @brief if true, build the FFT plans, save the wisdom, and exit
+     */
+    bool planOnly() const { return plan_only; }
+
+    /**
+     * @brief the IF recording that the FILE radio plays as its RX stream
+     */
+    std::string getReplayFileName() const { return replay_filename; }
+
+    /**
+     * @brief if true the FILE radio plays its recording as fast as the
+     * receive chain will take it, otherwise at the RX sample rate.
+     */
+    bool replayFast() const { return replay_fast; }
+
+    /**
+     * @brief if true the FILE radio starts over at the end of the
+     * recording, otherwise it stops the server.
+     */
+    bool replayLoop() const { return replay_loop; }
+
+    /**
+     * @brief the 3rd LO offset for a recording made before
+     * IFRecorder wrote a magic word.  Those recordings are mixed by
+     * the 3rd LO, but their header holds only the front end frequency.
+     */
+    double getReplayLO3() const { return replay_lo3; }
+
+    /**
+     * @brief the test signals for the SIM radio (see SoDa::SimRX)
+     */
+    const std::vector<std::string> & getSimSpecs() const { return sim_list; }
+
+    /**
+     * @brief where a radio without hardware writes its TX stream
+     * @return the file name, empty to throw the TX stream away
+     */
+    std::string getTXSinkFileName() const { return tx_sink_filename; }
+
 
     bool isRadioType(const std::string & rtype) {
       std::string rt = rtype;
@@ -155,6 +258,31 @@ namespace SoDa {
     bool force_integer_N_mode;
 
     unsigned int debug_level; 
+
+    // sample buffer arena
+    unsigned int buf_arena_slots; 
+    bool no_huge_pages; 
+
+    // thread placement and scheduling
+    std::vector<std::string> thread_sched_list; 
+    std::map<std::string, ThreadSchedSpec> thread_sched_map; 
+    bool lock_memory; 
+
+    bool parseThreadSched(const std::string & spec_str); 
+
+    // FFT planning
+    std::string fft_wisdom_file; 
+    std::string fft_plan_effort; 
+    double fft_plan_time_limit; 
+    bool plan_only; 
+
+    // radios without hardware
+    std::string replay_filename;
+    bool replay_fast;
+    bool replay_loop; 
+    double replay_lo3; 
+    std::vector<std::string> sim_list; 
+    std::string tx_sink_filename; 
   };
 }
 #endif
@@ -29,6 +29,7 @@
 #ifndef QUADOSC_HDR
 #define QUADOSC_HDR
 #include <complex>
+#include <cstddef>
 #include <math.h>
 
 
@@ -134,6 +135,43 @@ namespace SoDa {
       return dv.real(); 
     }
 
+    /**
+     * @brief fill a buffer with the next n oscillator outputs
+     *
+     * This produces the same sequence as n calls to stepOscCF, but
+     * several times faster.  The outputs are generated a block of
+     * block_len samples at a time: the phasor for the start of the
+     * block comes from an exact sincos of the (double precision)
+     * phase, and each output is that times a precomputed
+     * exp(-j w k).  So each block is block_len independent lanes
+     * (no recurrence for the vectorizer to trip over) and the
+     * error never accumulates past one single precision multiply.
+     *
+     * fill, mix, and the stepOsc calls can be mixed freely on one
+     * oscillator.  (Only the complex-multiply NCO though -- not
+     * USE_SINCOS_NCO.)
+     *
+     * @param out where to put the n oscillator samples
+     * @param n number of samples
+     */
+    void fill(std::complex<float> * out, size_t n) {
+      generate(out, (const std::complex<float> *) NULL, n);
+    }
+
+    /**
+     * @brief mix a buffer with the next n oscillator outputs
+     *
+     * out[i] = in[i] * stepOscCF() for n samples, see fill.
+     * in and out may be the same buffer.
+     *
+     * @param in the input samples
+     * @param out the mixed samples
+     * @param n number of samples
+     */
+    void mix(const std::complex<float> * in, std::complex<float> * out, size_t n) {
+      generate(out, in, n); 
+    }
+    
     /**
      * @brief set the phase increment per step for the oscillator (1/freq)
      * @param _pi the phase increment
@@ -141,11 +179,71 @@ namespace SoDa {
     void setPhaseIncr(double _pi) {
       phase_incr = _pi;
       ejw = exp(std::complex<double>(0.0, -phase_incr));
+      for(int k = 0; k < block_len; k++) {
+	std::complex<double> v = exp(std::complex<double>(0.0, -phase_incr * ((double) (k + 1))));
+	lane_re[k] = (float) v.real();
+	lane_im[k] = (float) v.imag();
+      }
     }
     
   private:
+    /// generate this many samples from each sincos
+    enum { block_len = 256 }; 
+
+    /**
+     * @brief the guts of fill and mix
+     *
+     * @param out where the results go
+     * @param in if not NULL, multiply the oscillator output by this
+     * @param n number of samples to generate
+     */
+    void generate(std::complex<float> * out, const std::complex<float> * in, size_t n) {
+      // last = exp(-j phi) is the most recent output.
+      double phi = -std::arg(last);
+      float * fout = (float *) out;
+      const float * fin = (const float *) in; 
+      size_t i = 0;
+
+      while(i < n) {
+	size_t blen = ((n - i) < (size_t) block_len) ? (n - i) : (size_t) block_len; 
+
+	double s, c;
+#  if __linux__
+	sincos(phi, &s, &c);
+#  else
+	s = sin(phi); c = cos(phi); 
+#  endif	
+	float br = (float) c;
+	float bi = (float) -s; 
+
+	float * o = fout + 2 * i; 
+	if(fin == NULL) {
+	  for(size_t k = 0; k < blen; k++) {
+	    o[2*k] = br * lane_re[k] - bi * lane_im[k];
+	    o[2*k+1] = br * lane_im[k] + bi * lane_re[k];
+	  }
+	}
+	else {
+	  const float * x = fin + 2 * i; 
+	  for(size_t k = 0; k < blen; k++) {
+	    float pr = br * lane_re[k] - bi * lane_im[k];
+	    float pi = br * lane_im[k] + bi * lane_re[k];
+	    float xr = x[2*k], xi = x[2*k+1];
+	    o[2*k] = xr * pr - xi * pi;
+	    o[2*k+1] = xr * pi + xi * pr;
+	  }
+	}
+
+	phi = remainder(phi + phase_incr * ((double) blen), 2.0 * M_PI);
+	i += blen; 
+      }
+
+      last = std::complex<double>(cos(phi), -sin(phi));
+    }
+    
     double phase_incr;
     double ang; 
+    float lane_re[block_len], lane_im[block_len]; ///< exp(-j w (k + 1))
     std::complex<double> ejw, last; 
     int idx; 
   };
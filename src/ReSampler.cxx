@@ -27,6 +27,7 @@
 */
 
 #include "ReSampler.hxx"
+#include "FFTPlanner.hxx"
 #include <string.h>
 #include <math.h>
 #include <stdio.h>
@@ -129,9 +130,6 @@ SoDa::ReSampler::ReSampler(unsigned int interpolate_ratio,
   // the transformed input
   in_fft = (std::complex<float> *) fftwf_alloc_complex(N);
 
-  // zero out the whole of the input buffer
-  for(i = 0; i < N; i++) inbuf[i] = std::complex<float>(0.0,0.0);
-  
   // the filter bank is really iM interleaved filters
   // but we can't seem to make that work right now, so we're
   // backing off to a simpler way. 
@@ -146,19 +144,18 @@ SoDa::ReSampler::ReSampler(unsigned int interpolate_ratio,
   interp_res = (std::complex<float> *) fftwf_alloc_complex(iM*N);
 
   // the first plan is pretty simple. 
-  in_fft_plan = fftwf_plan_dft_1d(N,
-				  (fftwf_complex *) inbuf,
-				  (fftwf_complex *) in_fft,
-				  FFTW_FORWARD, FFTW_ESTIMATE);
+  in_fft_plan = SoDa::FFTPlanner::planDFT(N, inbuf, in_fft, FFTW_FORWARD);
 
 
   // now create the inverting plans
-  int n[1];
-  n[0] = N; 
-  mid_ifft_plan = fftwf_plan_many_dft(1, n, iM, 
-				      (fftwf_complex *) filt_fft, NULL, iM, 1,
-				      (fftwf_complex *) interp_res, NULL, iM, 1,
-				      FFTW_BACKWARD, FFTW_ESTIMATE);
+  mid_ifft_plan = SoDa::FFTPlanner::planManyDFT(N, iM, 
+						filt_fft, iM, 1,
+						interp_res, iM, 1,
+						FFTW_BACKWARD);
+
+  // zero out the whole of the input buffer -- after planning, as
+  // a measured plan scribbles on its buffers.
+  for(i = 0; i < N; i++) inbuf[i] = std::complex<float>(0.0,0.0);
   
 
   // now create the polyphase filter banks.
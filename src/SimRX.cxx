@@ -0,0 +1,371 @@
+/*
+  Copyright (c) 2026, Matthew H. Reilly (kb1vc)
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+  Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in
+  the documentation and/or other materials provided with the
+  distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "SimRX.hxx"
+#include <SoDa/Format.hxx>
+#include <SoDa/Utils.hxx>
+#include <stdlib.h>
+#include <map>
+#include <set>
+#include <math.h>
+
+SoDa::SimRX::SimRX(Params * params) : SoDa::SoftRX(params, "SimRX"),
+				      noise_gen(1), gauss(0.0, 1.0)
+{
+  loopback = false;
+  loop_offset = 0.0;
+  loop_delay = 0.0;
+  loop_amp = 1.0e-3; 
+  loop_phase = 0.0; 
+  tx_stream = NULL;
+  cw_env_stream = NULL;
+  tx_on = false;
+  tx_freq = 0.0;
+  tx_modulation = SoDa::Command::USB; 
+
+  std::vector<std::string> specs = params->getSimSpecs();
+  if(specs.empty()) {
+    specs = { "noise:level=-100",
+	      "tone:freq=144.21e6,level=-70",
+	      "cw:freq=144.25e6,level=-80,wpm=18,text=CQ CQ DE SIM" };
+  }
+  for(auto & s : specs) {
+    parseSource(s); 
+  }
+}
+
+SoDa::SimRX::~SimRX()
+{
+  for(auto & src : sources) {
+    delete src.cwgen;
+    delete src.env_stream; 
+  }
+}
+
+void SoDa::SimRX::parseSource(const std::string & spec)
+{
+  size_t colon = spec.find(':');
+  std::string kind = spec.substr(0, colon);
+  std::map<std::string, std::string> fields; 
+  if(colon != std::string::npos) {
+    for(auto & field : SoDa::split(spec.substr(colon + 1), ",")) {
+      size_t eq = field.find('=');
+      if(eq == std::string::npos) {
+	throw SoDa::Radio::Exception(SoDa::Format("Bad --sim setting [%0] -- expected KIND:key=val,...\n").addS(spec), this);
+      }
+      fields[field.substr(0, eq)] = field.substr(eq + 1);
+    }
+  }
+
+  // the settings each kind of signal understands
+  static const std::map<std::string, std::set<std::string>> valid_keys = {
+    { "noise", { "level" } },
+    { "tone", { "freq", "level" } },
+    { "cw", { "freq", "level", "wpm", "text" } },
+    { "am", { "freq", "level", "tone", "depth" } },
+    { "fm", { "freq", "level", "tone", "dev" } },
+    { "sweep", { "from", "to", "rate", "level" } },
+    { "loopback", { "offset", "delay", "level" } }
+  };
+  auto vk = valid_keys.find(kind);
+  if(vk == valid_keys.end()) {
+    throw SoDa::Radio::Exception(SoDa::Format("Unknown signal [%0] in --sim setting [%1]\n")
+				 .addS(kind).addS(spec), this);
+  }
+  for(auto & f : fields) {
+    if(vk->second.count(f.first) == 0) {
+      throw SoDa::Radio::Exception(SoDa::Format("Bad --sim setting [%0] -- %1 has no setting [%2]\n")
+				   .addS(spec).addS(kind).addS(f.first), this);
+    }
+  }
+
+  // look up a numeric field, with a default
+  auto num = [&](const std::string & key, double def) -> double {
+    if(fields.find(key) == fields.end()) return def;
+    char * endp;
+    double v = strtod(fields[key].c_str(), &endp);
+    if(*endp != '\0') {
+      throw SoDa::Radio::Exception(SoDa::Format("Bad value for %0 in --sim setting [%1]\n")
+				   .addS(key).addS(spec), this);
+    }
+    return v; 
+  };
+
+  if(kind == "loopback") {
+    loopback = true; 
+    loop_offset = num("offset", 0.0);
+    loop_delay = num("delay", 0.0);
+    loop_amp = pow(10.0, num("level", -60.0) / 20.0);
+    if(loop_delay < 0.0) {
+      throw SoDa::Radio::Exception(SoDa::Format("Loopback delay can't be negative [%0]\n").addS(spec), this);
+    }
+    return; 
+  }
+  
+  Source src;
+  src.amp = pow(10.0, num("level", -80.0) / 20.0);
+  src.freq = num("freq", 144.2e6);
+  src.mod_freq = num("tone", 1000.0);
+  src.depth = num("depth", 0.5);
+  src.dev = num("dev", 2500.0);
+  src.phase = 0.0;
+  src.mod_phase = 0.0;
+  src.env_stream = NULL;
+  src.cwgen = NULL;
+  src.text_idx = 0; 
+  
+  if(kind == "noise") {
+    src.kind = Source::NOISE;
+    // split the power between I and Q
+    src.amp = src.amp / sqrt(2.0); 
+  }
+  else if(kind == "tone") src.kind = Source::TONE;
+  else if(kind == "am") src.kind = Source::AM;
+  else if(kind == "fm") src.kind = Source::FM;
+  else if(kind == "sweep") {
+    src.kind = Source::SWEEP;
+    src.sweep_from = num("from", 144.1e6);
+    src.sweep_to = num("to", 144.3e6);
+    src.sweep_rate = num("rate", 10.0e3);
+    if(src.sweep_to < src.sweep_from) std::swap(src.sweep_from, src.sweep_to); 
+    src.freq = src.sweep_from; 
+  }
+  else if(kind == "cw") {
+    src.kind = Source::CW;
+    src.text = (fields.find("text") == fields.end()) ? std::string("TEST") : fields["text"];
+    // the gap before the text starts over. 
+    src.text += "   "; 
+    // the keyer's envelope goes to a stream of our own. 
+    src.env_stream = new SoDa::DatMBox(true);
+    src.env_subs = src.env_stream->subscribe();
+    src.cwgen = new SoDa::CWGenerator(src.env_stream, rx_sample_rate, rx_buffer_size);
+    src.cwgen->setCWSpeed((unsigned int) num("wpm", 20.0)); 
+  }
+  else {
+    throw SoDa::Radio::Exception(SoDa::Format("Unknown signal [%0] in --sim setting [%1]\n")
+				 .addS(kind).addS(spec), this);
+  }
+
+  sources.push_back(src); 
+}
+
+bool SoDa::SimRX::fillBuffer(std::complex<float> * buf)
+{
+  for(unsigned int i = 0; i < rx_buffer_size; i++) {
+    buf[i] = std::complex<float>(0.0, 0.0);
+  }
+
+  for(auto & src : sources) {
+    addSource(src, buf); 
+  }
+
+  if(loopback) addLoopback(buf); 
+  
+  // a signal generator never runs dry.
+  return true; 
+}
+
+void SoDa::SimRX::addSource(Source & src, std::complex<float> * buf)
+{
+  double fs = rx_sample_rate; 
+  double incr = 2.0 * M_PI * (src.freq - rx_fe_freq) / fs;
+  double amp = src.amp; 
+  
+  switch(src.kind) {
+  case Source::NOISE:
+    for(unsigned int i = 0; i < rx_buffer_size; i++) {
+      buf[i] += std::complex<float>(amp * gauss(noise_gen), amp * gauss(noise_gen)); 
+    }
+    return; 
+  case Source::TONE:
+    for(unsigned int i = 0; i < rx_buffer_size; i++) {
+      buf[i] += std::polar((float) amp, (float) src.phase);
+      src.phase += incr; 
+    }
+    break;
+  case Source::CW:
+    {
+      // keep the keyer about a second ahead of us. 
+      while(src.cwgen->readyForMore()) {
+	src.cwgen->sendChar(src.text[src.text_idx]);
+	src.text_idx = (src.text_idx + 1) % src.text.size(); 
+      }
+      SoDa::Buf * env = src.env_stream->get(src.env_subs);
+      float * ev = (env == NULL) ? NULL : env->getFloatBuf();
+      unsigned int elen = (env == NULL) ? 0 : env->getComplexLen();
+      for(unsigned int i = 0; i < rx_buffer_size; i++) {
+	if(i < elen) buf[i] += std::polar((float) (amp * ev[i]), (float) src.phase);
+	src.phase += incr; 
+      }
+      if(env != NULL) src.env_stream->free(env);
+    }
+    break; 
+  case Source::AM:
+    {
+      double mincr = 2.0 * M_PI * src.mod_freq / fs;
+      for(unsigned int i = 0; i < rx_buffer_size; i++) {
+	float a = amp * (1.0 + src.depth * cos(src.mod_phase));
+	buf[i] += std::polar(a, (float) src.phase);
+	src.phase += incr; 
+	src.mod_phase += mincr;
+      }
+    }
+    break;
+  case Source::FM:
+    {
+      double mincr = 2.0 * M_PI * src.mod_freq / fs;
+      double dincr = 2.0 * M_PI * src.dev / fs; 
+      for(unsigned int i = 0; i < rx_buffer_size; i++) {
+	buf[i] += std::polar((float) amp, (float) src.phase);
+	src.phase += incr + dincr * cos(src.mod_phase); 
+	src.mod_phase += mincr;
+      }
+    }
+    break;
+  case Source::SWEEP:
+    {
+      double fstep = src.sweep_rate / fs; 
+      for(unsigned int i = 0; i < rx_buffer_size; i++) {
+	buf[i] += std::polar((float) amp, (float) src.phase);
+	src.phase += 2.0 * M_PI * (src.freq - rx_fe_freq) / fs;
+	src.freq += fstep;
+	if(src.freq > src.sweep_to) src.freq = src.sweep_from; 
+      }
+    }
+    break; 
+  }
+
+  // keep the accumulators small, or we lose precision over a long run.
+  src.phase = fmod(src.phase, 2.0 * M_PI);
+  src.mod_phase = fmod(src.mod_phase, 2.0 * M_PI); 
+}
+
+void SoDa::SimRX::addLoopback(std::complex<float> * buf)
+{
+  bool cw_mode = (tx_modulation == SoDa::Command::CW_L) || (tx_modulation == SoDa::Command::CW_U);
+
+  // collect whatever the transmit side has sent since the last buffer. 
+  SoDa::Buf * txb;
+  while((txb = tx_stream->get(tx_subs)) != NULL) {
+    if(tx_on && !cw_mode) {
+      std::complex<float> * v = txb->getComplexBuf(); 
+      loop_fifo.insert(loop_fifo.end(), v, v + txb->getComplexLen());
+    }
+    tx_stream->free(txb); 
+  }
+  while((txb = cw_env_stream->get(cw_subs)) != NULL) {
+    if(tx_on && cw_mode) {
+      // the same amplitude USRPTX puts on the key-down carrier
+      float * ev = txb->getFloatBuf(); 
+      for(unsigned int i = 0; i < txb->getComplexLen(); i++) {
+	loop_fifo.push_back(std::complex<float>(0.7 * ev[i], 0.0)); 
+      }
+    }
+    cw_env_stream->free(txb); 
+  }
+
+  // don't let a stalled receiver hoard transmit samples forever.
+  size_t max_fifo = (size_t) ((2.0 + loop_delay) * rx_sample_rate); 
+  if(loop_fifo.size() > max_fifo) {
+    loop_fifo.erase(loop_fifo.begin(), loop_fifo.begin() + (loop_fifo.size() - max_fifo)); 
+  }
+
+  // move the transmit signal to where it lands in the receiver's IF.
+  double offset = tx_freq - rx_fe_freq + loop_offset;
+  if(tx_modulation == SoDa::Command::CW_U) offset -= 500.0;
+  if(tx_modulation == SoDa::Command::CW_L) offset += 500.0;
+  double incr = 2.0 * M_PI * offset / rx_sample_rate; 
+
+  unsigned int len = std::min((size_t) rx_buffer_size, loop_fifo.size());
+  for(unsigned int i = 0; i < len; i++) {
+    buf[i] += ((float) loop_amp) * loop_fifo[i] * std::polar(1.0f, (float) loop_phase);
+    loop_phase += incr; 
+  }
+  loop_fifo.erase(loop_fifo.begin(), loop_fifo.begin() + len);
+  loop_phase = fmod(loop_phase, 2.0 * M_PI); 
+}
+
+void SoDa::SimRX::execSetCommand(Command * cmd)
+{
+  SoDa::SoftRX::execSetCommand(cmd);
+
+  switch(cmd->target) {
+  case SoDa::Command::TX_STATE:
+    if(cmd->iparms[0] == 3) {
+      if(!tx_on && loopback) {
+	// the first transmit samples come back loop_delay seconds from now.
+	loop_fifo.insert(loop_fifo.end(), (size_t) (loop_delay * rx_sample_rate),
+			 std::complex<float>(0.0, 0.0)); 
+      }
+      tx_on = true; 
+    }
+    if(cmd->iparms[0] == 2) {
+      tx_on = false; 
+    }
+    break;
+  case SoDa::Command::TX_MODE:
+    tx_modulation = SoDa::Command::ModulationType(cmd->iparms[0]);
+    break; 
+  default:
+    break; 
+  }
+}
+
+void SoDa::SimRX::execRepCommand(Command * cmd)
+{
+  SoDa::SoftRX::execRepCommand(cmd);
+
+  if(cmd->target == SoDa::Command::TX_FE_FREQ) {
+    tx_freq = cmd->dparms[0]; 
+  }
+}
+
+SoDa::MBoxFilter SoDa::SimRX::cmdFilter()
+{
+  SoDa::MBoxFilter filt = SoDa::SoftRX::cmdFilter();
+  filt.merge(Command::makeFilter({Command::TX_MODE}, {Command::SET}));
+  filt.merge(Command::makeFilter({Command::TX_FE_FREQ}, {Command::REP}));
+  return filt; 
+}
+
+/// implement the subscription method
+void SoDa::SimRX::subscribeToMailBox(const std::string & mbox_name, 
+				     SoDa::BaseMBox * mbox_p) {
+  SoDa::SoftRX::subscribeToMailBox(mbox_name, mbox_p);
+
+  // we only listen to the transmitter if we're going to send it back. 
+  if(!loopback) return; 
+  
+  if(SoDa::connectMailBox<SoDa::DatMBox>(this, tx_stream, "TX", mbox_name, mbox_p)) {
+    tx_subs = tx_stream->subscribe();
+  }
+  if(SoDa::connectMailBox<SoDa::DatMBox>(this, cw_env_stream, "CW_ENV", mbox_name, mbox_p)) {
+    cw_subs = cw_env_stream->subscribe();
+  }
+}
@@ -0,0 +1,125 @@
+/*
+  Copyright (c) 2026, Matthew H. Reilly (kb1vc)
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+  Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in
+  the documentation and/or other materials provided with the
+  distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef SIMRX_HDR
+#define SIMRX_HDR
+#include "SoftRX.hxx"
+#include "CWGenerator.hxx"
+#include <vector>
+#include <deque>
+#include <random>
+
+namespace SoDa {
+  /**
+   * @brief The receive path for the SIM radio -- a signal generator.
+   *
+   * SimRX stands in for USRPRX.  It synthesizes the IF stream from a
+   * list of test signals, each given with --sim KIND:key=val,...
+   * Frequencies are RF frequencies in Hz, so the signals stay put as
+   * the radio is tuned around them.  Levels are in dB relative to a
+   * full scale (amplitude 1.0) carrier.
+   *
+   * @li noise:level=L -- white noise, L is the total power in the IF band
+   * @li tone:freq=F,level=L -- a carrier
+   * @li cw:freq=F,level=L,wpm=W,text=T -- a keyed carrier sending T over and over
+   * @li am:freq=F,level=L,tone=M,depth=D -- a carrier modulated by an M Hz tone
+   * @li fm:freq=F,level=L,tone=M,dev=V -- an M Hz tone at V Hz deviation
+   * @li sweep:from=F1,to=F2,rate=R,level=L -- a carrier sweeping from F1 to F2 at R Hz/s
+   * @li loopback:offset=F,delay=S,level=L -- while the transmitter is on, the
+   *     TX (or CW) output comes back S seconds later, F Hz from where it was
+   *     sent, with gain L.
+   *
+   * Without --sim SimRX sends a noise floor, a carrier at 144.21 MHz, and a
+   * CW beacon at 144.25 MHz.  The noise is pseudo-random with a fixed seed,
+   * so every run sees exactly the same samples.
+   */
+  class SimRX : public SoftRX {
+  public:
+    /**
+     * @brief constructor
+     * @param params command line parameters -- these describe the signals.
+     */
+    SimRX(Params * params);
+
+    ~SimRX(); 
+
+    /// implement the subscription method
+    void subscribeToMailBox(const std::string & mbox_name, BaseMBox * mbox_p);
+
+  protected:
+    bool fillBuffer(std::complex<float> * buf); 
+
+    SoDa::MBoxFilter cmdFilter(); 
+    void execSetCommand(Command * cmd); 
+    void execRepCommand(Command * cmd);
+
+  private:
+    struct Source {
+      enum Kind { NOISE, TONE, CW, AM, FM, SWEEP } kind; 
+      double freq; ///< RF frequency (the current frequency, for a sweep)
+      double amp; 
+      double mod_freq, depth, dev; ///< AM and FM modulation 
+      double sweep_from, sweep_to, sweep_rate; 
+      double phase, mod_phase; 
+      // CW keying
+      std::string text; 
+      unsigned int text_idx; 
+      SoDa::DatMBox * env_stream; 
+      unsigned int env_subs; 
+      SoDa::CWGenerator * cwgen; 
+    };
+
+    /**
+     * @brief parse a --sim setting, and add the signal to the list
+     * @param spec KIND:key=val,...
+     */
+    void parseSource(const std::string & spec); 
+
+    void addSource(Source & src, std::complex<float> * buf); 
+    void addLoopback(std::complex<float> * buf); 
+
+    std::vector<Source> sources; 
+    std::mt19937 noise_gen; 
+    std::normal_distribution<float> gauss; 
+
+    // loopback
+    bool loopback;
+    double loop_offset, loop_delay, loop_amp;
+    DatMBox * tx_stream, * cw_env_stream;
+    unsigned int tx_subs, cw_subs; 
+    std::deque<std::complex<float>> loop_fifo; ///< TX samples on their way back
+    double loop_phase; 
+    bool tx_on; 
+    double tx_freq; 
+    SoDa::Command::ModulationType tx_modulation;
+  }; 
+}
+
+
+#endif
@@ -29,6 +29,8 @@
 #include "SoDaBase.hxx"
 #include <string>
 #include <map>
+#include <stdlib.h>
+#include <sys/mman.h>
 
 namespace SoDa {
   std::map<std::string, SoDa::Base *> SoDa::Base::ObjectDirectory;
@@ -66,3 +68,102 @@ namespace SoDa {
 
 bool SoDa::Base::first_time = true;
 double SoDa::Base::base_first_time;
+
+std::mutex SoDa::BufArena::arena_mutex; 
+char * SoDa::BufArena::arena_base = NULL;
+size_t SoDa::BufArena::arena_size = 0;
+size_t SoDa::BufArena::slot_bytes = 0;
+std::vector<char *> SoDa::BufArena::free_slots;
+bool SoDa::BufArena::huge_tlb = false;
+std::atomic<unsigned int> SoDa::BufArena::live_count(0);
+
+void SoDa::BufArena::configure(unsigned int slot_len, unsigned int slot_count, bool try_hugepages)
+{
+  std::lock_guard<std::mutex> lock(arena_mutex);
+  if((arena_base != NULL) || (slot_count == 0)) return;
+
+  slot_bytes = slot_len * sizeof(std::complex<float>);
+  slot_bytes = ((slot_bytes + alignment - 1) / alignment) * alignment;
+
+  // round the region up to a 2MB huge page boundary
+  const size_t huge_page = 2 * 1024 * 1024;
+  size_t len = slot_bytes * slot_count;
+  len = ((len + huge_page - 1) / huge_page) * huge_page;
+
+  void * base = MAP_FAILED;
+#ifdef MAP_HUGETLB
+  if(try_hugepages) {
+    base = mmap(NULL, len, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    huge_tlb = (base != MAP_FAILED);
+  }
+#endif
+  if(base == MAP_FAILED) {
+    // no reserved huge pages -- take ordinary pages and
+    // ask for transparent huge pages instead.
+    base = mmap(NULL, len, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(base == MAP_FAILED) return;
+#ifdef MADV_HUGEPAGE
+    if(try_hugepages) madvise(base, len, MADV_HUGEPAGE);
+#endif
+  }
+
+  arena_base = (char *) base;
+  arena_size = len; 
+  unsigned int nslots = len / slot_bytes;
+  free_slots.reserve(nslots);
+  // hand out the low addresses first.
+  for(unsigned int i = nslots; i > 0; i--) {
+    free_slots.push_back(arena_base + (i - 1) * slot_bytes);
+  }
+}
+
+std::complex<float> * SoDa::BufArena::allocStorage(unsigned int len)
+{
+  size_t bytes = len * sizeof(std::complex<float>);
+  live_count++;
+  {
+    std::lock_guard<std::mutex> lock(arena_mutex);
+    if((bytes <= slot_bytes) && !free_slots.empty()) {
+      char * ret = free_slots.back();
+      free_slots.pop_back();
+      return (std::complex<float> *) ret; 
+    }
+  }
+
+  void * ret; 
+  if(posix_memalign(&ret, alignment, bytes) != 0) {
+    live_count--;
+    throw SoDa::Radio::Exception(SoDa::Format("BufArena couldn't allocate %0 bytes.\n").addU(bytes), NULL);
+  }
+  return (std::complex<float> *) ret; 
+}
+
+void SoDa::BufArena::freeStorage(std::complex<float> * p)
+{
+  if(p == NULL) return; 
+  live_count--;
+  if(inArena(p)) {
+    std::lock_guard<std::mutex> lock(arena_mutex);
+    free_slots.push_back((char *) p); 
+  }
+  else {
+    ::free(p); 
+  }
+}
+
+std::string SoDa::BufArena::describe()
+{
+  std::lock_guard<std::mutex> lock(arena_mutex);
+  if(arena_base == NULL) {
+    return SoDa::Format("BufArena: no arena, aligned heap blocks only, %0 live")
+      .addU(live_count.load()).str();
+  }
+  return SoDa::Format("BufArena: %0 slots of %1 bytes, %2 free, %3, %4 live")
+    .addU(arena_size / slot_bytes)
+    .addU(slot_bytes)
+    .addU(free_slots.size())
+    .addS(huge_tlb ? "MAP_HUGETLB" : "normal pages")
+    .addU(live_count.load()).str();
+}
@@ -34,6 +34,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Debug.hxx"
 #include <complex>
 #include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
 #include <sys/types.h>
 #include <unistd.h>
 #include <sys/syscall.h>
@@ -57,6 +60,67 @@ extern "C" {
 
 namespace SoDa {
 
+  /**
+   * @brief storage allocator for SoDa::Buf sample buffers
+   *
+   * Every block is 64-byte aligned so that the FFTW and vector kernels
+   * can use aligned loads.  Once configured, blocks up to the
+   * configured slot size come out of a single preallocated region --
+   * backed by huge pages if the kernel will give them to us -- so the
+   * buffers on the 625 kS/s path share a handful of TLB entries
+   * rather than one heap block each.  Larger requests, or requests
+   * made after the arena runs dry, fall back to posix_memalign.
+   */
+  class BufArena {
+  public:
+    /**
+     * @brief set up the arena.  Call this once, before the threads start.
+     *
+     * @param slot_len the number of complex samples in each slot (the RF buffer size)
+     * @param slot_count number of slots to preallocate (0 means no arena, just aligned heap blocks)
+     * @param try_hugepages if true, ask for MAP_HUGETLB (then transparent huge pages)
+     */
+    static void configure(unsigned int slot_len, unsigned int slot_count, bool try_hugepages = true);
+
+    /**
+     * @brief get 64-byte aligned storage for len complex samples
+     * @param len number of complex float samples
+     * @return pointer to the storage
+     */
+    static std::complex<float> * allocStorage(unsigned int len);
+
+    /**
+     * @brief return storage obtained from allocStorage
+     * @param p the storage pointer
+     */
+    static void freeStorage(std::complex<float> * p);
+
+    /**
+     * @brief describe the arena for debug reports.
+     */
+    static std::string describe();
+
+    /**
+     * @brief how many blocks (arena or heap) are in use right now?
+     */
+    static unsigned int liveCount() { return live_count.load(); }
+
+    static const unsigned int alignment = 64; ///< byte alignment of every block
+    
+  private:
+    static bool inArena(void * p) {
+      return (arena_base != NULL) && ((char*) p >= arena_base) && ((char*) p < (arena_base + arena_size));
+    }
+    
+    static std::mutex arena_mutex; 
+    static char * arena_base;      ///< start of the preallocated region (NULL if none)
+    static size_t arena_size;      ///< length of the region in bytes
+    static size_t slot_bytes;      ///< bytes per slot (a multiple of alignment)
+    static std::vector<char *> free_slots; ///< slots available for allocation
+    static bool huge_tlb;          ///< true if the region is MAP_HUGETLB backed
+    static std::atomic<unsigned int> live_count; ///< blocks handed out and not yet returned
+  };
+  
   /**
    * The Buffer Class
    *
@@ -78,13 +142,21 @@ namespace SoDa {
     Buf(unsigned int _size) {
       maxlen = _size;
       len = maxlen;
-      dat = new std::complex<float>[_size];
+      dat = BufArena::allocStorage(_size);
       // we also overlay a floating point buffer in the same space.
       fdat = (float *) dat; 
       maxflen = maxlen * 2;
       flen = len * 2; 
     }
 
+    ~Buf() {
+      BufArena::freeStorage(dat);
+    }
+
+    // a Buf owns its storage -- copy the samples with copy(), not the Buf.
+    Buf(const Buf &) = delete;
+    Buf & operator=(const Buf &) = delete;
+
     bool copy(Buf * src) {
       if(maxlen >= src->maxlen) {
 	flen = src->flen;
@@ -128,6 +200,7 @@ namespace SoDa {
 
     /**
      * Return a pointer to the storage buffer of complex floats
+     * (always aligned to BufArena::alignment bytes)
      */
     std::complex<float> * getComplexBuf() { return dat; }
     /**
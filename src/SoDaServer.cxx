@@ -124,6 +124,9 @@
 #include <stdio.h>
 #include <sys/time.h>
 #include <sys/resource.h>
+#include <sys/mman.h>
+#include <string.h>
+#include <errno.h>
 
 #include <fstream>
 #include <SoDa/Format.hxx>
@@ -138,12 +141,21 @@
 
 // the radio parts. 
 #include "Params.hxx" 
+#include "FFTPlanner.hxx"
+#include "OSFilter.hxx"
+#include "HilbertTransformer.hxx"
+#include "Spectrogram.hxx"
 // For USRP devices
 #if HAVE_UHD
 #  include "USRPCtrl.hxx"
 #  include "USRPRX.hxx"
 #  include "USRPTX.hxx"
 #endif
+// For radios without hardware
+#include "SoftCtrl.hxx"
+#include "FileRX.hxx"
+#include "FileTX.hxx"
+#include "SimRX.hxx"
 
 #include "BaseBandRX.hxx"
 #include "BaseBandTX.hxx"
@@ -186,6 +198,41 @@ int loadAccessories(const std::vector<std::string> & libs, SoDa::Debug & d) {
   return 1; 
 }
 
+/// build one of each of the transforms the radio will run, so that
+/// the FFT planner learns (and saves) the best plan for each.
+/// @param params command line parameter parser object
+/// @param d debug message object
+void prewarmFFTPlans(SoDa::Params & params, SoDa::Debug & d)
+{
+  unsigned int af_len = params.getAFBufferSize();
+  // the audio filters and the AM and NBFM prefilters are all 512 taps
+  // on an AF buffer, after the resampler.  The audio filters run on
+  // real audio, the prefilters on complex baseband.
+  SoDa::OSFilter af_filter(0.0, 0.0, 8000.0, 9000.0, 512, 1.0,
+			   params.getAudioSampleRate(), af_len);
+  af_filter.planRealPath();
+  SoDa::OSFilter nbfm_pre_filter(0.0, 0.0, 12500.0, 14000.0, 512, 1.0,
+				 params.getAudioSampleRate(), af_len);
+  // SSB and CW run the audio filter fused with a sideband selector --
+  // a longer filter, so a different transform length.
+  SoDa::OSFilter * ssb_filter = SoDa::HilbertTransformer::makeSSBFilter(false, &af_filter, af_len);
+  SoDa::HilbertTransformer hilbert(af_len);
+  // these are the UI's spectrum, zoomed spectrum, and LO check spectrograms
+  SoDa::Spectrogram spectrogram(SoDa::UI::spectrogram_len);
+  SoDa::Spectrogram lo_spectrogram(16384);
+  SoDa::ZoomSpectrogram zoom_spectrogram(SoDa::UI::spectrogram_len, params.getRXRate(),
+					 SoDa::UI::spectrum_span);
+  // their plans depend on how many segments fit in an IF buffer
+  unsigned int rf_len = params.getRFBufferSize();
+  spectrogram.planFor(rf_len);
+  lo_spectrogram.planFor(rf_len);
+  zoom_spectrogram.planFor(rf_len);
+
+  delete ssb_filter; 
+
+  d.debugMsg(SoDa::FFTPlanner::describe() + "\n");
+}
+
 /// do the work of creating the SoDa threads
 /// @param params command line parameter parser object
 int doWork(SoDa::Params & params)
@@ -195,17 +242,66 @@ int doWork(SoDa::Params & params)
   d.setDefaultLevel(params.getDebugLevel());
   
   loadAccessories(params.getLibs(), d);
+
+  // carve out the RF sample buffers before anybody asks for one. 
+  SoDa::BufArena::configure(params.getRFBufferSize(), 
+			    params.getBufArenaSlots(),
+			    params.useHugePages());
+  d.debugMsg(SoDa::BufArena::describe() + "\n");
+
+  // load FFTW wisdom before anybody makes a plan
+  SoDa::FFTPlanner::Effort fft_effort; 
+  if(!SoDa::FFTPlanner::effortFromName(params.getFFTPlanEffort(), fft_effort)) {
+    std::cerr << SoDa::Format("Unknown FFT planning effort [%0], using \"estimate\"\n")
+      .addS(params.getFFTPlanEffort());
+    fft_effort = SoDa::FFTPlanner::ESTIMATE;
+  }
+  SoDa::FFTPlanner::configure(params.getFFTWisdomFile(), fft_effort,
+			      params.getFFTPlanTimeLimit());
+  d.debugMsg(SoDa::FFTPlanner::describe() + "\n");
+
+  if(params.planOnly()) {
+    prewarmFFTPlans(params, d);
+    SoDa::FFTPlanner::saveWisdom();
+    return 0; 
+  }
+
+  // each thread picks up its own affinity and scheduling
+  // settings when it starts.
+  SoDa::Thread::setSchedParams(&params);
+
+  if(params.lockMemory()) {
+    if(mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+      std::cerr << SoDa::Format("SoDaServer couldn't lock memory: %0 (check ulimit -l)\n")
+	.addS(strerror(errno));
+    }
+    else {
+      std::cerr << "SoDaServer locked all current and future pages in memory.\n";
+    }
+  }
   
   // These are the mailboxes that connect
   // the various widgets
   // the rx and tx streams are vectors of complex floats.
   // we don't declare the extent here, as it will be set
-  // by a negotiation.  
-  SoDa::DatMBox rx_stream, tx_stream, if_stream, cw_env_stream;
-  SoDa::CmdMBox cmd_stream(false);
+  // by a negotiation.
+  // The data streams each have exactly one producer, so they
+  // can use the lock-free broadcast ring.  256 buffers is more than
+  // ten seconds of RX stream.
+  const unsigned int dat_ring_size = 256;
+  SoDa::DatMBox rx_stream(true, dat_ring_size), tx_stream(true, dat_ring_size);
+  SoDa::DatMBox if_stream(true, dat_ring_size), cw_env_stream(true, dat_ring_size);
+  // The command streams recycle their commands -- use
+  // stream->make(...) rather than new Command(...).  The pool
+  // limit keeps stray "new" commands from piling up in the pool.
+  const unsigned int cmd_pool_limit = 128; 
+  SoDa::CmdMBox cmd_stream(true);
   // create a separate gps stream to avoid "leaks" and latency problems... 
-  SoDa::CmdMBox gps_stream(false);
-  SoDa::CmdMBox cwtxt_stream(false);
+  SoDa::CmdMBox gps_stream(true);
+  SoDa::CmdMBox cwtxt_stream(true);
+  cmd_stream.setPoolLimit(cmd_pool_limit);
+  gps_stream.setPoolLimit(cmd_pool_limit);
+  cwtxt_stream.setPoolLimit(cmd_pool_limit);
 
   SoDa::Thread * ctrl;
   SoDa::Thread * rx;
@@ -220,7 +316,19 @@ int doWork(SoDa::Params & params)
   mailbox_map["CW_ENV"] = &cw_env_stream;  
   mailbox_map["GPS"] = &gps_stream;
   mailbox_map["IF"] = &if_stream;
+
+  // A slow consumer on the receive side should lose old samples
+  // rather than stall the USRP streamer.  The spectrum display only
+  // cares about the most recent IF buffers.  TX, CW envelope, and
+  // command streams must not lose anything, so they block (or grow).
+  rx_stream.setCapacity(64, SoDa::BaseMBox::DROP_OLDEST);
+  if_stream.setCapacity(8, SoDa::BaseMBox::DROP_OLDEST);
+  gps_stream.setCapacity(32, SoDa::BaseMBox::DROP_OLDEST);
+  for(auto & mbe : mailbox_map) {
+    mbe.second->setName(mbe.first);
+  }
   
+#if HAVE_UHD
   if(params.isRadioType("USRP")) {
     /// create the USRP Control, RX Streamer, and TX Streamer threads
     /// @see SoDa::USRPCtrl @see SoDa::USRPRX @see SoDa::USRPTX
@@ -228,6 +336,22 @@ int doWork(SoDa::Params & params)
     rx = new SoDa::USRPRX(&params, ((SoDa::USRPCtrl *)ctrl)->getUSRP());
     tx = new SoDa::USRPTX(&params, ((SoDa::USRPCtrl *)ctrl)->getUSRP());
   }
+  else
+#endif
+  if(params.isRadioType("FILE")) {
+    /// play an IF recording instead of listening to a radio
+    /// @see SoDa::SoftCtrl @see SoDa::FileRX @see SoDa::FileTX
+    ctrl = new SoDa::SoftCtrl(&params, "FILE");
+    rx = new SoDa::FileRX(&params);
+    tx = new SoDa::FileTX(&params);
+  }
+  else if(params.isRadioType("SIM")) {
+    /// a signal generator in place of a radio, for testing without hardware
+    /// @see SoDa::SoftCtrl @see SoDa::SimRX @see SoDa::FileTX
+    ctrl = new SoDa::SoftCtrl(&params, "SIM");
+    rx = new SoDa::SimRX(&params);
+    tx = new SoDa::FileTX(&params);
+  }
   else {
     std::cerr << SoDa::Format("Radio type [%0] is not yet supported\nHit ^C to exit.\n")
       .addS(params.getRadioType()); 
@@ -291,6 +415,9 @@ int doWork(SoDa::Params & params)
 
   // once everyone has joined, we're due to stop
   registrar->shutDownThreads();  
+
+  // keep anything the planner learned for next time.
+  SoDa::FFTPlanner::saveWisdom();
   
   // when we get here, we are done... (UI should not return until it gets an "exit/quit" command.)
   d.debugMsg("Exit");
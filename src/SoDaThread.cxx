@@ -3,6 +3,7 @@
 #include "Command.hxx"
 #include "MultiMBox.hxx"
 #include "Debug.hxx"
+#include "Params.hxx"
 #include "version.h"
 
 #include <string>
@@ -11,6 +12,9 @@
 #include <sys/types.h>
 #include <unistd.h>
 #include <sys/syscall.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
 
 extern "C" {
 #include <signal.h>
@@ -23,8 +27,11 @@ SoDa::Thread::Thread(const std::string & oname, const std::string & version) : S
   
   SoDa::ThreadRegistry::getRegistrar()->addThread(this, version);
   thread_ptr = nullptr;
+  has_sched_policy = false; 
 }
 
+const SoDa::Params * SoDa::Thread::sched_params = NULL;
+
 void SoDa::Thread::execCommand(Command * cmd) 
 {
   switch (cmd->cmd) {
@@ -46,6 +53,7 @@ void SoDa::Thread::execCommand(Command * cmd)
 void  SoDa::Thread::outerRun() {
   hookSigSeg();
   debugMsg(getObjName() + " starting.\n");
+  applySchedSpec();
   try {
     run(); 
   }
@@ -81,6 +89,58 @@ void  SoDa::Thread::sigsegHandler(int sig)
   kill(getpid(), SIGSEGV);
 }
 
+void SoDa::Thread::applySchedSpec()
+{
+  SoDa::ThreadSchedSpec spec; 
+  if((sched_params == NULL) || !sched_params->getThreadSched(getObjName(), spec)) return; 
+
+  pthread_t self = pthread_self();
+  
+  if(!spec.cpus.empty()) {
+    cpu_set_t cpuset; 
+    CPU_ZERO(&cpuset); 
+    for(auto c : spec.cpus) CPU_SET(c, &cpuset);
+    int stat = pthread_setaffinity_np(self, sizeof(cpuset), &cpuset);
+    if(stat != 0) {
+      std::cerr << SoDa::Format("%0 couldn't set CPU affinity: %1\n")
+	.addS(getObjName()).addS(strerror(stat));
+    }
+  }
+
+  if(spec.policy >= 0) {
+    struct sched_param sp; 
+    memset(&sp, 0, sizeof(sp));
+    sp.sched_priority = (spec.policy == SCHED_OTHER) ? 0 : spec.priority;
+    int stat = pthread_setschedparam(self, spec.policy, &sp);
+    if(stat != 0) {
+      std::cerr << SoDa::Format("%0 couldn't set scheduling policy %1 priority %2: %3\n")
+	.addS(getObjName()).addI(spec.policy).addI(sp.sched_priority).addS(strerror(stat));
+    }
+    else {
+      has_sched_policy = true; 
+    }
+  }
+
+  // now report what we actually got. 
+  cpu_set_t got_cpus; 
+  std::string cpu_list; 
+  if(pthread_getaffinity_np(self, sizeof(got_cpus), &got_cpus) == 0) {
+    for(int i = 0; i < CPU_SETSIZE; i++) {
+      if(CPU_ISSET(i, &got_cpus)) {
+	if(!cpu_list.empty()) cpu_list += "+"; 
+	cpu_list += std::to_string(i); 
+      }
+    }
+  }
+  int got_policy; 
+  struct sched_param got_sp; 
+  pthread_getschedparam(self, &got_policy, &got_sp);
+  std::string pol_name = (got_policy == SCHED_FIFO) ? "fifo" : 
+    ((got_policy == SCHED_RR) ? "rr" : "other"); 
+  std::cerr << SoDa::Format("%0 running on cpus %1 policy %2 priority %3\n")
+    .addS(getObjName()).addS(cpu_list).addS(pol_name).addI(got_sp.sched_priority);
+}
+
 void SoDa::Thread::hookSigSeg() {
   struct sigaction act;
   sigemptyset(&act.sa_mask);
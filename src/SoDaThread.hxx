@@ -57,6 +57,7 @@ namespace SoDa {
   
   class BaseMBox; 
   class Command;
+  class Params;
   
   typedef std::map<std::string, BaseMBox *> MailBoxMap; 
   
@@ -100,6 +101,13 @@ namespace SoDa {
      * of the mailbox, and the thread should be able to infer the the "T" in 
      * the actual MultiMBox<T> type from this identifying string. 
      * @param mbox_p a pointer to a multimbox.  This should be cast to the 
+     *
+     * The "RX" mailbox (a DatMBox) carries the 3rd IF as it comes from
+     * the radio -- the front end frequency is at DC, and the tuned
+     * signal is at the 3rd LO frequency (set by the RX_LO3_FREQ command).  A
+     * thread that wants the tuned signal at DC must mix it down by the
+     * 3rd LO itself.  (See QuadratureOscillator, and the IFServer
+     * example.)
      */
     virtual void subscribeToMailBox(const std::string & mbox_name, BaseMBox * mbox_p) {
     }
@@ -190,8 +198,35 @@ namespace SoDa {
     void sleep_us(unsigned int microseconds) {
       std::this_thread::sleep_for(std::chrono::microseconds(microseconds));
     }
+
+    /**
+     * @brief tell all threads where to find their CPU affinity and
+     * scheduling settings.  Call this before the threads start.
+     *
+     * @param params the command line parameters (see Params::getThreadSched)
+     */
+    static void setSchedParams(const Params * params) { sched_params = params; }
+
+  protected:
+    /**
+     * @brief did the command line set a scheduling policy for this thread?
+     *
+     * Threads that would otherwise pick their own priority (e.g. with
+     * uhd::set_thread_priority_safe) should leave it alone if so.
+     */
+    bool hasSchedPolicy() const { return has_sched_policy; }
     
   private:
+    /**
+     * @brief apply the affinity and scheduling settings for this
+     * thread, and report what the kernel actually gave us.
+     */
+    void applySchedSpec();
+
+    bool has_sched_policy; ///< true if the scheduling policy came from the command line
+
+    static const Params * sched_params; ///< where the per-thread settings live
+    
     /**
      * This is the actual thread object -- 
      */
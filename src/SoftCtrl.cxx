@@ -0,0 +1,270 @@
+/*
+  Copyright (c) 2026, Matthew H. Reilly (kb1vc)
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+  Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in
+  the documentation and/or other materials provided with the
+  distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "SoftCtrl.hxx"
+#include <SoDa/Format.hxx>
+#include <math.h>
+
+const double SoDa::SoftCtrl::rx_gain_max = 60.0;
+const double SoDa::SoftCtrl::tx_gain_max = 80.0; 
+
+SoDa::SoftCtrl::SoftCtrl(Params * _params, const std::string & _radio_name) : SoDa::Thread("SoftCtrl")
+{
+  params = _params;
+  radio_name = _radio_name; 
+  cmd_stream = NULL;
+
+  rx_fe_freq = 0.0;
+  tx_freq = 0.0; 
+  rx_rf_gain = 0.0;
+  tx_rf_gain = 0.0;
+  rx_ant = params->getRXAnt().empty() ? std::string("RX2") : params->getRXAnt();
+  tx_ant = params->getTXAnt().empty() ? std::string("TX/RX") : params->getTXAnt();
+}
+
+void SoDa::SoftCtrl::run()
+{
+  if(cmd_stream == NULL) {
+    throw SoDa::Radio::Exception(std::string("Never got command stream subscription\n"), 
+				 this);	
+  }
+
+  // the same startup sequence as the USRP
+  cmd_stream->put(cmd_stream->make(Command::SET, Command::RX_SAMP_RATE,
+				   params->getRXRate())); 
+  cmd_stream->put(cmd_stream->make(Command::SET, Command::TX_SAMP_RATE,
+				   params->getTXRate()));
+  cmd_stream->put(cmd_stream->make(Command::SET, Command::TX_RF_GAIN, 0.0)); 
+  cmd_stream->put(cmd_stream->make(Command::SET, Command::RX_RF_GAIN, 0.0));
+  cmd_stream->put(cmd_stream->make(Command::SET, Command::RX_AF_GAIN, 0.0));
+  cmd_stream->put(cmd_stream->make(Command::SET, Command::TX_STATE, 0)); 
+
+  bool exitflag = false;
+  while(!exitflag) {
+    Command * cmd = cmd_stream->getWait(cmd_subs);
+    if(cmd == NULL) continue; 
+    execCommand(cmd);
+    exitflag |= (cmd->target == Command::STOP); 
+    cmd_stream->free(cmd); 
+  }
+}
+
+void SoDa::SoftCtrl::execCommand(Command * cmd)
+{
+  switch (cmd->cmd) {
+  case Command::GET:
+    execGetCommand(cmd); 
+    break;
+  case Command::SET:
+    execSetCommand(cmd); 
+    break; 
+  default:
+    break; 
+  }
+}
+
+void SoDa::SoftCtrl::tuneRX(double freq, bool retune)
+{
+  double fdiff = freq - rx_fe_freq; 
+  // like the USRP, a retune that leaves the signal in the IF
+  // passband only moves the 3rd LO.
+  if(!retune || (fdiff >= 200e3) || (fdiff <= 100e3)) {
+    // put the front end on a 100kHz step, 100 to 200 kHz below the
+    // signal of interest.
+    rx_fe_freq = 100e3 * floor(freq / 100e3);
+    while((freq - rx_fe_freq) < 100e3) rx_fe_freq -= 100e3;
+    fdiff = freq - rx_fe_freq; 
+  }
+  cmd_stream->put(cmd_stream->make(Command::SET, Command::RX_LO3_FREQ, fdiff)); 
+  cmd_stream->put(cmd_stream->make(Command::REP, Command::RX_FE_FREQ, rx_fe_freq)); 
+  cmd_stream->put(cmd_stream->make(Command::REP, Command::RX_CENTER_FREQ, rx_fe_freq));
+}
+
+void SoDa::SoftCtrl::execSetCommand(Command * cmd)
+{
+  switch (cmd->target) {
+  case Command::RX_RETUNE_FREQ:
+    tuneRX(cmd->dparms[0], true);
+    break; 
+  case Command::RX_TUNE_FREQ:    
+  case Command::RX_FE_FREQ:
+    tuneRX(cmd->dparms[0], false);
+    break;
+  case Command::LO_CHECK:
+    // there's no LO to look for, but the UI will finish the 
+    // calibration and put the spectrum back. 
+    if(cmd->dparms[0] != 0.0) {
+      cmd_stream->put(cmd_stream->make(Command::GET, Command::LO_OFFSET, 0));
+    }
+    break; 
+  case Command::TX_RETUNE_FREQ:
+  case Command::TX_TUNE_FREQ:
+  case Command::TX_FE_FREQ:
+    tx_freq = cmd->dparms[0]; 
+    cmd_stream->put(cmd_stream->make(Command::REP, Command::TX_FE_FREQ, tx_freq)); 
+    break; 
+  case Command::RX_SAMP_RATE:
+    // the rates are fixed
+    cmd_stream->put(cmd_stream->make(Command::REP, Command::RX_SAMP_RATE, params->getRXRate())); 
+    break; 
+  case Command::TX_SAMP_RATE:
+    cmd_stream->put(cmd_stream->make(Command::REP, Command::TX_SAMP_RATE, params->getTXRate())); 
+    break;
+  case Command::RX_RF_GAIN:
+    // the same 0 to -100 scale that the USRP uses.
+    rx_rf_gain = rx_gain_max + cmd->dparms[0];
+    if(rx_rf_gain > rx_gain_max) rx_rf_gain = rx_gain_max;
+    if(rx_rf_gain < 0.0) rx_rf_gain = 0.0; 
+    cmd_stream->put(cmd_stream->make(Command::REP, Command::RX_RF_GAIN, rx_rf_gain));
+    break; 
+  case Command::TX_RF_GAIN:
+    tx_rf_gain = tx_gain_max + cmd->dparms[0];
+    if(tx_rf_gain > tx_gain_max) tx_rf_gain = tx_gain_max;
+    if(tx_rf_gain < 0.0) tx_rf_gain = 0.0; 
+    cmd_stream->put(cmd_stream->make(Command::REP, Command::TX_RF_GAIN, tx_rf_gain)); 
+    break; 
+  case Command::TX_STATE:
+    // the CTRL half of the handshake -- there's no relay to throw,
+    // so pass it straight on to the TX and RX units.
+    if(cmd->iparms[0] == 1) {
+      cmd_stream->put(cmd_stream->make(Command::SET, Command::TX_STATE, 
+				       3, cmd->iparms[1]));
+    }
+    if(cmd->iparms[0] == 0) {
+      cmd_stream->put(cmd_stream->make(Command::SET, Command::TX_STATE, 2));
+    }
+    break; 
+  case Command::RX_ANT:
+    rx_ant = cmd->sparm; 
+    cmd_stream->put(cmd_stream->make(Command::REP, Command::RX_ANT, rx_ant));
+    break; 
+  case Command::TX_ANT:
+    tx_ant = cmd->sparm; 
+    cmd_stream->put(cmd_stream->make(Command::REP, Command::TX_ANT, tx_ant));
+    break;
+  default:
+    break; 
+  }
+}
+
+void SoDa::SoftCtrl::execGetCommand(Command * cmd)
+{
+  switch (cmd->target) {
+  case Command::RX_FE_FREQ:
+    cmd_stream->put(cmd_stream->make(Command::REP, Command::RX_FE_FREQ, rx_fe_freq, 0.0)); 
+    break; 
+  case Command::TX_FE_FREQ:
+    cmd_stream->put(cmd_stream->make(Command::REP, Command::TX_FE_FREQ, tx_freq, 0.0)); 
+    break; 
+  case Command::RX_SAMP_RATE:
+    cmd_stream->put(cmd_stream->make(Command::REP, Command::RX_SAMP_RATE, params->getRXRate())); 
+    break; 
+  case Command::TX_SAMP_RATE:
+    cmd_stream->put(cmd_stream->make(Command::REP, Command::TX_SAMP_RATE, params->getTXRate())); 
+    break;
+  case Command::TX_GAIN_RANGE:
+    cmd_stream->put(cmd_stream->make(Command::REP, Command::TX_GAIN_RANGE, 0.0, tx_gain_max));
+    break; 
+  case Command::CLOCK_SOURCE:
+    // internal, and locked.
+    cmd_stream->put(cmd_stream->make(Command::REP, Command::CLOCK_SOURCE, 1));
+    break;
+  case Command::HWMB_REP:
+    reportSetup();
+    break; 
+  default:
+    break; 
+  }
+}
+
+void SoDa::SoftCtrl::reportSetup()
+{
+  cmd_stream->put(cmd_stream->make(Command::REP, Command::HWMB_REP,
+				   SoDa::Format("%0\t%1 to %2 MHz")
+				   .addS(radio_name)
+				   .addF(1.0, 10, 6, 'e')
+				   .addF(6000.0, 10, 6, 'e').str()));
+  cmd_stream->put(cmd_stream->make(Command::REP, Command::RX_ANT_NAME, rx_ant)); 
+  cmd_stream->put(cmd_stream->make(Command::REP, Command::TX_ANT_NAME, tx_ant)); 
+
+  cmd_stream->put(cmd_stream->make(Command::REP, Command::MOD_SEL_ENTRY, 
+				   "CW_U", ((int) SoDa::Command::CW_U)));
+  cmd_stream->put(cmd_stream->make(Command::REP, Command::MOD_SEL_ENTRY, 
+				   "USB", ((int) SoDa::Command::USB)));
+  cmd_stream->put(cmd_stream->make(Command::REP, Command::MOD_SEL_ENTRY, 
+				   "CW_L", ((int) SoDa::Command::CW_L)));
+  cmd_stream->put(cmd_stream->make(Command::REP, Command::MOD_SEL_ENTRY, 
+				   "LSB", ((int) SoDa::Command::LSB)));
+  cmd_stream->put(cmd_stream->make(Command::REP, Command::MOD_SEL_ENTRY, 
+				   "AM", ((int) SoDa::Command::AM)));
+  cmd_stream->put(cmd_stream->make(Command::REP, Command::MOD_SEL_ENTRY, 
+				   "WBFM", ((int) SoDa::Command::WBFM)));
+  cmd_stream->put(cmd_stream->make(Command::REP, Command::MOD_SEL_ENTRY, 
+				   "NBFM", ((int) SoDa::Command::NBFM)));
+
+  cmd_stream->put(cmd_stream->make(Command::REP, Command::AF_FILT_ENTRY,
+				   "100", ((int) SoDa::Command::BW_100)));
+  cmd_stream->put(cmd_stream->make(Command::REP, Command::AF_FILT_ENTRY,
+				   "500", ((int) SoDa::Command::BW_500)));
+  cmd_stream->put(cmd_stream->make(Command::REP, Command::AF_FILT_ENTRY,
+				   "2000", ((int) SoDa::Command::BW_2000)));
+  cmd_stream->put(cmd_stream->make(Command::REP, Command::AF_FILT_ENTRY,
+				   "6000", ((int) SoDa::Command::BW_6000)));
+  cmd_stream->put(cmd_stream->make(Command::REP, Command::AF_FILT_ENTRY,
+				   "WSPR", ((int) SoDa::Command::BW_WSPR)));
+  cmd_stream->put(cmd_stream->make(Command::REP, Command::AF_FILT_ENTRY,
+				   "PASS", ((int) SoDa::Command::BW_PASS)));
+  
+  cmd_stream->put(cmd_stream->make(Command::REP, Command::INIT_SETUP_COMPLETE, 0));
+}
+
+/// implement the subscription method
+void SoDa::SoftCtrl::subscribeToMailBox(const std::string & mbox_name, SoDa::BaseMBox * mbox_p)
+{
+  if(SoDa::connectMailBox<SoDa::CmdMBox>(this, cmd_stream, "CMD", mbox_name, mbox_p)) {
+    cmd_subs = cmd_stream->subscribe(Command::makeFilter({Command::CLOCK_SOURCE,
+	    Command::HWMB_REP,
+	    Command::LO_CHECK,
+	    Command::RX_ANT,
+	    Command::RX_FE_FREQ,
+	    Command::RX_RETUNE_FREQ,
+	    Command::RX_RF_GAIN,
+	    Command::RX_SAMP_RATE,
+	    Command::RX_TUNE_FREQ,
+	    Command::TX_ANT,
+	    Command::TX_FE_FREQ,
+	    Command::TX_GAIN_RANGE,
+	    Command::TX_RETUNE_FREQ,
+	    Command::TX_RF_GAIN,
+	    Command::TX_SAMP_RATE,
+	    Command::TX_STATE,
+	    Command::TX_TUNE_FREQ},
+	{Command::SET, Command::GET}));
+  }
+}
@@ -0,0 +1,93 @@
+/*
+  Copyright (c) 2026, Matthew H. Reilly (kb1vc)
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+  Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in
+  the documentation and/or other materials provided with the
+  distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef SOFTCTRL_HDR
+#define SOFTCTRL_HDR
+#include "SoDaBase.hxx"
+#include "SoDaThread.hxx"
+#include "MultiMBox.hxx"
+#include "Command.hxx"
+#include "Params.hxx"
+
+namespace SoDa {
+  /**
+   * @brief The control unit for radios that have no hardware.
+   *
+   * SoftCtrl stands in for USRPCtrl when the RX stream comes from a
+   * file or a signal generator.  It speaks the same protocol: it
+   * picks a front end frequency 100 to 200 kHz below the requested
+   * RX frequency and sets the 3rd LO to the difference, it does the
+   * CTRL half of the TX_STATE handshake, and it answers the GUI's
+   * setup questions (HWMB_REP and friends).  Gain and antenna
+   * settings are remembered and reported, but change nothing.
+   *
+   * The RX unit listens for REP RX_FE_FREQ to find out where the
+   * "front end" is tuned.
+   */
+  class SoftCtrl : public SoDa::Thread {
+  public:
+    /**
+     * @brief constructor
+     * @param params command line parameters
+     * @param radio_name the motherboard name we report to the GUI
+     */
+    SoftCtrl(Params * params, const std::string & radio_name);
+
+    /// implement the subscription method
+    void subscribeToMailBox(const std::string & mbox_name, BaseMBox * mbox_p);
+
+    void run();
+
+  private:
+    void execCommand(Command * cmd); 
+    void execGetCommand(Command * cmd); 
+    void execSetCommand(Command * cmd); 
+
+    /// tune the RX "front end" and report where we landed
+    void tuneRX(double freq, bool retune); 
+    
+    void reportSetup();
+
+    Params * params; 
+    std::string radio_name;
+
+    CmdMBox * cmd_stream;
+    unsigned int cmd_subs; 
+
+    double rx_fe_freq; ///< where the RX front end is tuned
+    double tx_freq; 
+    double rx_rf_gain, tx_rf_gain; 
+    std::string rx_ant, tx_ant;
+
+    /// the nominal gain ranges, so the GUI's sliders behave
+    static const double rx_gain_max, tx_gain_max; 
+  };
+}
+
+#endif
@@ -0,0 +1,177 @@
+/*
+  Copyright (c) 2026, Matthew H. Reilly (kb1vc)
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+  Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in
+  the documentation and/or other materials provided with the
+  distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "SoftRX.hxx"
+#include <SoDa/Format.hxx>
+#include <thread>
+
+SoDa::SoftRX::SoftRX(Params * params, const std::string & name) : SoDa::Thread(name)
+{
+  rx_stream = NULL;
+  if_stream = NULL;
+  cmd_stream = NULL;
+
+  rx_sample_rate = params->getRXRate();
+  rx_buffer_size = params->getRFBufferSize(); 
+  run_fast = params->replayFast();
+  rx_fe_freq = 0.0; 
+
+  // we aren't receiving yet. 
+  rx_stream_enabled = false;
+  enable_spectrum_report = true; 
+  buffers_played = 0; 
+}
+
+void SoDa::SoftRX::run()
+{
+  if((cmd_stream == NULL) || (rx_stream == NULL) || (if_stream == NULL)) {
+    throw SoDa::Radio::Exception(std::string("Missing a stream connection.\n"), 
+				 this);	
+  }
+
+  // When we aren't playing, only a command can change that.
+  SoDa::WaitSet wait_set;
+  wait_set.add(cmd_stream, cmd_subs);
+
+  bool exitflag = false;
+  bool playing = true; 
+  while(!exitflag) {
+    Command * cmd = cmd_stream->get(cmd_subs);
+    if(cmd != NULL) {
+      execCommand(cmd);
+      exitflag |= (cmd->target == Command::STOP); 
+      cmd_stream->free(cmd); 
+    }
+    else if(rx_stream_enabled && playing && run_fast && (rx_stream->inFlightCount() >= 8)) {
+      // the receiver is behind -- give it a chance to catch up,
+      // but keep listening for commands. 
+      wait_set.wait(200);
+    }
+    else if(rx_stream_enabled && playing) {
+      SoDa::Buf * buf = rx_stream->allocOrNew(rx_buffer_size);
+      if(buf == NULL) throw SoDa::Radio::Exception("SoftRX couldn't allocate SoDa::Buf object", this); 
+
+      playing = fillBuffer(buf->getComplexBuf()); 
+
+      if(!run_fast) pace(); 
+
+      // the same IF stream rules as USRPRX
+      if(enable_spectrum_report && if_stream->hasActiveSubscriber()) {
+	SoDa::Buf * if_buf = if_stream->allocOrNew(rx_buffer_size);
+	if(if_buf->copy(buf)) {
+	  if_stream->put(if_buf);
+	}
+	else {
+	  throw SoDa::Radio::Exception("SoDa::Buf Copy for IF stream failed", this);
+	}
+      }
+
+      rx_stream->put(buf);
+
+      if(!playing) {
+	std::cerr << getObjName() << ": end of input, stopping.\n";
+	cmd_stream->put(cmd_stream->make(Command::SET, Command::STOP, 0));
+      }
+    }
+    else {
+      // not started yet, or out of input. 
+      wait_set.wait();
+    }
+  }
+}
+
+void SoDa::SoftRX::pace()
+{
+  // real time -- don't get ahead of the wall clock.
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  if(buffers_played == 0) play_start = now; 
+  buffers_played++;
+  std::chrono::duration<double> due_secs(((double) (buffers_played - 1) * rx_buffer_size) / rx_sample_rate);
+  std::chrono::steady_clock::time_point due = play_start + 
+    std::chrono::duration_cast<std::chrono::steady_clock::duration>(due_secs);
+  if(due > now) {
+    std::this_thread::sleep_until(due);
+  }
+  else if((now - due) > std::chrono::seconds(1)) {
+    // we fell way behind (a debugger, perhaps) -- don't try to make it up.
+    buffers_played = 0; 
+  }
+}
+
+void SoDa::SoftRX::execSetCommand(Command * cmd)
+{
+  switch(cmd->target) {
+  case SoDa::Command::TX_STATE:
+    if(cmd->iparms[0] == 3) {
+      enable_spectrum_report = (cmd->iparms[1] > 0);
+    }
+    if(cmd->iparms[0] == 2) {
+      // the first TX OFF starts the stream.
+      rx_stream_enabled = true; 
+      enable_spectrum_report = true;
+      // tell the baseband unit that it is ready to start. 
+      cmd_stream->put(cmd_stream->make(Command::SET, Command::TX_STATE, 4));
+    }
+    break; 
+  default:
+    break; 
+  }
+}
+
+void SoDa::SoftRX::execRepCommand(Command * cmd)
+{
+  switch(cmd->target) {
+  case SoDa::Command::RX_FE_FREQ:
+    rx_fe_freq = cmd->dparms[0];
+    break; 
+  default:
+    break; 
+  }
+}
+
+SoDa::MBoxFilter SoDa::SoftRX::cmdFilter()
+{
+  SoDa::MBoxFilter filt = Command::makeFilter({Command::TX_STATE}, {Command::SET});
+  filt.merge(Command::makeFilter({Command::RX_FE_FREQ}, {Command::REP}));
+  return filt; 
+}
+
+/// implement the subscription method
+void SoDa::SoftRX::subscribeToMailBox(const std::string & mbox_name, 
+				      SoDa::BaseMBox * mbox_p) {
+  if(SoDa::connectMailBox<SoDa::CmdMBox>(this, cmd_stream, "CMD", mbox_name, mbox_p)) {
+    cmd_subs = cmd_stream->subscribe(cmdFilter());
+  }
+  if(SoDa::connectMailBox<SoDa::DatMBox>(this, rx_stream, "RX", mbox_name, mbox_p)) {
+    // we don't subscribe -- we publish
+  }
+  if(SoDa::connectMailBox<SoDa::DatMBox>(this, if_stream, "IF", mbox_name, mbox_p)) {
+    // we don't subscribe -- we publish
+  }
+}
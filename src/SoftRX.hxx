@@ -0,0 +1,108 @@
+/*
+  Copyright (c) 2026, Matthew H. Reilly (kb1vc)
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+  Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in
+  the documentation and/or other materials provided with the
+  distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef SOFTRX_HDR
+#define SOFTRX_HDR
+#include "SoDaBase.hxx"
+#include "SoDaThread.hxx"
+#include "MultiMBox.hxx"
+#include "Command.hxx"
+#include "Params.hxx"
+#include <chrono>
+
+namespace SoDa {
+  /**
+   * @brief The receive path for radios without hardware.
+   *
+   * SoftRX does the parts of USRPRX's job that don't depend on where
+   * the samples come from: the TX_STATE handshake, publishing each
+   * buffer on the RX and IF streams, and keeping pace.  A subclass
+   * supplies the samples with fillBuffer.
+   *
+   * With no A/D converter to set the pace, buffers go out at the RX
+   * sample rate, or (with --replay-fast) as fast as the receive
+   * chain takes them.
+   *
+   * SoftCtrl reports the "front end" frequency in REP RX_FE_FREQ;
+   * SoftRX keeps it in rx_fe_freq for the subclass.
+   */
+  class SoftRX : public SoDa::Thread {
+  public:
+    /**
+     * @brief constructor
+     * @param params command line parameters
+     * @param name the thread name
+     */
+    SoftRX(Params * params, const std::string & name);
+
+    /// implement the subscription method
+    void subscribeToMailBox(const std::string & mbox_name, BaseMBox * mbox_p);
+    
+    void run();
+    
+  protected:
+    /**
+     * @brief produce the next buffer of IF samples
+     * @param buf rx_buffer_size samples, as they would come from the front end
+     * @return false if there are no more samples -- the server stops. 
+     */
+    virtual bool fillBuffer(std::complex<float> * buf) = 0; 
+
+    /// the commands the subclass wants to see, beyond SoftRX's own
+    virtual SoDa::MBoxFilter cmdFilter(); 
+    
+    void execSetCommand(Command * cmd); 
+    void execRepCommand(Command * cmd);
+
+    CmdMBox * cmd_stream;
+    
+    unsigned int rx_buffer_size;
+    double rx_sample_rate;
+    double rx_fe_freq; ///< where SoftCtrl says the front end is tuned
+
+  private:
+    /// wait until the wall clock catches up with the samples we've sent
+    void pace(); 
+
+    DatMBox * rx_stream;
+    DatMBox * if_stream; 
+    unsigned int cmd_subs; 
+
+    bool run_fast; 
+    bool rx_stream_enabled;
+    bool enable_spectrum_report; 
+
+    // pacing
+    std::chrono::steady_clock::time_point play_start; 
+    unsigned long buffers_played; 
+  }; 
+}
+
+
+#endif
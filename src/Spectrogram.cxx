@@ -26,40 +26,85 @@ THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 #include "Spectrogram.hxx"
+#include "FFTPlanner.hxx"
+#include "VecOps.hxx"
 #include <math.h>
 #include <iostream>
 #include "SoDaBase.hxx"
 #include <SoDa/Format.hxx>
 
-SoDa::Spectrogram::Spectrogram(unsigned int fftlen)
+SoDa::Spectrogram::Spectrogram(unsigned int fftlen, WindowType window_type, 
+				float overlap, int nthreads)
   : SoDa::Base("Spectrogram")
 {
   // remember how long the output will be
   fft_len = fftlen; 
 
-  // allocate the internal buffers
-  win_samp = (std::complex<float>*) fftwf_alloc_complex(fft_len);
-  fft_out = (std::complex<float>*) fftwf_alloc_complex(fft_len);
-  result = new float[fft_len];
+  if(overlap < 0.0) overlap = 0.0;
+  if(overlap > 0.9) overlap = 0.9;
+  hop = (unsigned int) floor(0.5 + ((float) fft_len) * (1.0 - overlap));
+  if(hop < 1) hop = 1; 
 
-  // create the FFT plan
-  fftplan = fftwf_plan_dft_1d(fft_len,
-			      (fftwf_complex *) win_samp,
-			      (fftwf_complex *) fft_out,
-			      FFTW_FORWARD, FFTW_ESTIMATE); 
+  fft_threads = nthreads; 
   
-  // setup the blackman harris window.
-  window = initBlackmanHarris(); 
+  // allocate the internal buffers -- the batch buffers and plan are
+  // built when we see how long the input buffers are.
+  win_samp = NULL;
+  fft_out = NULL;
+  fftplan = NULL; 
+  batch_segs = 0; 
+  result = new float[fft_len];
+
+  // setup the segment window
+  window = initWindow(window_type); 
 }
 
+void SoDa::Spectrogram::planFor(unsigned int inveclen)
+{
+  if(inveclen < fft_len) return;
+  setupBatch(1 + (inveclen - fft_len) / hop);
+}
 
-float * SoDa::Spectrogram::initBlackmanHarris()
+void SoDa::Spectrogram::setupBatch(unsigned int num_segs)
+{
+  if(num_segs == batch_segs) return;
+
+  SoDa::FFTPlanner::destroyPlan(fftplan);
+  if(win_samp != NULL) fftwf_free(win_samp);
+  if(fft_out != NULL) fftwf_free(fft_out);
+
+  batch_segs = num_segs;
+  win_samp = (std::complex<float>*) fftwf_alloc_complex(fft_len * batch_segs);
+  fft_out = (std::complex<float>*) fftwf_alloc_complex(fft_len * batch_segs);
+
+  // one plan for all the segments: segment k starts at k * fft_len
+  fftplan = SoDa::FFTPlanner::planManyDFT(fft_len, batch_segs, 
+					  win_samp, 1, fft_len,
+					  fft_out, 1, fft_len, 
+					  FFTW_FORWARD, fft_threads);
+  if(fftplan == NULL) {
+    throw SoDa::Radio::Exception("Spectrogram had trouble creating the batch FFT plan\n", this);
+  }
+}
+
+float * SoDa::Spectrogram::initWindow(WindowType window_type)
 {
   unsigned int i;
-  float a0 = 0.35875;
-  float a1 = 0.48829;
-  float a2 = 0.14128;
-  float a3 = 0.01168;
+  float a0, a1, a2, a3;
+  switch(window_type) {
+  case HANN:
+    a0 = 0.5; a1 = 0.5; a2 = 0.0; a3 = 0.0; 
+    break; 
+  case RECTANGULAR:
+    a0 = 1.0; a1 = 0.0; a2 = 0.0; a3 = 0.0; 
+    break; 
+  default: // Blackman-Harris
+    a0 = 0.35875;
+    a1 = 0.48829;
+    a2 = 0.14128;
+    a3 = 0.01168;
+    break; 
+  }
 
   float * w = new float[fft_len];
   float anginc = 2.0 * M_PI / ((float) fft_len - 1);
@@ -75,39 +120,37 @@ float * SoDa::Spectrogram::initBlackmanHarris()
 void SoDa::Spectrogram::apply_common(std::complex<float> * invec,
 				     unsigned int inveclen)
 {
-  unsigned int i, j;
-  float repl_count;
-
-  repl_count = floor(((float) inveclen) / ((float) fft_len));
-  float gain_adj = 1.0 / repl_count; 
+  unsigned int i, j, k;
 
-  // zero the result accumulate buffer. 
-  for(j = 0; j < fft_len; j++) result[j] = 0.0;
   if(fft_len > inveclen) {
     throw SoDa::Radio::Exception(SoDa::Format("inveclen %0 less than fftlen %1\n") 
 			  .addI(inveclen)
 			  .addI(fft_len), 
 			  this);
   }
-  // accumulate FFT results over the length of the buffer.
-  for(i = 0; i < (inveclen + 1 - fft_len); i += (fft_len / 2)) {
-    std::complex<float> *v = &(invec[i]);
-
-    // window the input
-    for(j = 0; j < fft_len; j++) {
-      win_samp[j] = v[j] * window[j]; 
-    }  
-
-    // do the fft
-    fftwf_execute(fftplan); 
-
-    // accumulate the magnitude squared result
-    for(j = 0; j < fft_len; j++) {
-      float re, im;
-      re = fft_out[j].real();
-      im = fft_out[j].imag();
-      result[j] += gain_adj * (re * re + im * im); 
-    }
+
+  unsigned int num_segs = 1 + (inveclen - fft_len) / hop;
+  setupBatch(num_segs); 
+
+  // Normalize to the number of non-overlapped segments in the
+  // buffer, so the level doesn't depend on the overlap.  (For 50%
+  // overlap this is the old floor(inveclen / fft_len).)
+  float repl_count = ((float) (num_segs * hop)) / ((float) fft_len);
+  if(repl_count < 1.0) repl_count = 1.0; 
+  float gain_adj = 1.0 / repl_count; 
+
+  // window all the segments into the batch buffer
+  for(i = 0, k = 0; k < num_segs; i += hop, k++) {
+    SoDa::VecOps::cmulReal(win_samp + k * fft_len, invec + i, window, fft_len);
+  }
+
+  // do the ffts
+  fftwf_execute(fftplan); 
+
+  // accumulate the magnitude squared results
+  for(j = 0; j < fft_len; j++) result[j] = 0.0;
+  for(k = 0; k < num_segs; k++) {
+    SoDa::VecOps::magSqAcc(result, fft_out + k * fft_len, gain_adj, fft_len);
   }
 }
 
@@ -130,17 +173,10 @@ void SoDa::Spectrogram::apply_acc(std::complex<float> * invec,
   // now copy to the output buffer
   // this is mag^2 divided by the square of of the
   // number of segments we FFTd.
-  unsigned int j, k;
-
-  for(j = 0, k = (fft_len / 2); j < (fft_len / 2); j++, k++) {
-    outvec[j] = result[k] * (1.0 - accumulation_gain) +
-      outvec[j] * accumulation_gain; 
-  }
-
-  for(j = (fft_len / 2), k = 0; j < fft_len; j++, k++) {
-    outvec[j] = result[k] * (1.0 - accumulation_gain) +
-      outvec[j] * accumulation_gain; 
-  }
+  // (the two halves swap places so that DC lands in the middle)
+  unsigned int hlen = fft_len / 2;
+  SoDa::VecOps::expAvg(outvec, result + hlen, accumulation_gain, hlen);
+  SoDa::VecOps::expAvg(outvec + hlen, result, accumulation_gain, fft_len - hlen);
 }
 
 void SoDa::Spectrogram::apply_max(std::complex<float> * invec,
@@ -170,3 +206,106 @@ void SoDa::Spectrogram::apply_max(std::complex<float> * invec,
     }
   }
 }
+
+SoDa::ZoomSpectrogram::ZoomSpectrogram(unsigned int full_fftlen, double _sample_rate, double _span)
+  : SoDa::Base("ZoomSpectrogram")
+{
+  sample_rate = _sample_rate;
+  span = _span; 
+
+  // A half-band decimator needs the window to fit below a quarter of its input
+  // rate -- everything that folds into the window is then in the stop band. 
+  decimation = 1;
+  double rate = sample_rate;
+  while(((full_fftlen / decimation) % 2) == 0 && (rate > 2.4 * span)) {
+    // transition band (as a fraction of the input rate) runs from the
+    // top of the window to its image.
+    double trans = (0.5 * rate - span) / rate;
+    // blackman windowed sinc -- about 74dB down at the stop band. 
+    // (At 625 kS/s with a 200 kHz span that's one stage, K = 17: 35 taps.)
+    unsigned int K = ((unsigned int) ceil(5.5 / (2.0 * trans))) | 1; 
+    std::vector<float> taps;
+    double sum = 0.5;
+    for(unsigned int k = 1; k <= K; k += 2) {
+      double w = 0.42 + 0.5 * cos(M_PI * k / (K + 1)) + 0.08 * cos(2.0 * M_PI * k / (K + 1));
+      double h = w * sin(0.5 * M_PI * k) / (M_PI * k);
+      taps.push_back(h);
+      sum += 2.0 * h; 
+    }
+    // unity gain at DC
+    for(unsigned int i = 0; i < taps.size(); i++) taps[i] = taps[i] / sum; 
+    hb_taps.push_back(taps);
+    rate = rate * 0.5;
+    decimation = decimation * 2;
+  }
+
+  fft_len = full_fftlen / decimation; 
+  spectrogram = new Spectrogram(fft_len);
+  work_buf = NULL;
+  work_len = 0; 
+}
+
+void SoDa::ZoomSpectrogram::planFor(unsigned int inveclen)
+{
+  unsigned int len = inveclen;
+  for(unsigned int i = 0; i < hb_taps.size(); i++) {
+    len = halfBandLen(len, hb_taps[i]); 
+  }
+  spectrogram->planFor(len); 
+}
+
+unsigned int SoDa::ZoomSpectrogram::halfBandLen(unsigned int len, const std::vector<float> & taps)
+{
+  unsigned int K = 2 * taps.size() - 1;
+  if(len <= 2 * K) return 0; 
+  return (len - 2 * K - 1) / 2 + 1;
+}
+
+unsigned int SoDa::ZoomSpectrogram::halfBand(std::complex<float> * buf, unsigned int len,
+					     const std::vector<float> & taps)
+{
+  unsigned int K = 2 * taps.size() - 1;
+  unsigned int olen = halfBandLen(len, taps);
+  // Only the samples that survive the decimation get computed.
+  // The output index never passes the input index, so this can
+  // work in place. 
+  for(unsigned int i = 0; i < olen; i++) {
+    const std::complex<float> * c = buf + K + 2 * i;
+    std::complex<float> acc = 0.5f * c[0];
+    for(unsigned int j = 0, k = 1; j < taps.size(); j++, k += 2) {
+      acc += taps[j] * (c[k] + c[-((int) k)]);
+    }
+    buf[i] = acc; 
+  }
+  return olen; 
+}
+
+void SoDa::ZoomSpectrogram::apply_acc(std::complex<float> * invec, unsigned int inveclen,
+				      float * outvec, float accumulation_gain, 
+				      double center_freq)
+{
+  if(inveclen > work_len) {
+    if(work_buf != NULL) delete[] work_buf;
+    work_buf = new std::complex<float>[inveclen];
+    work_len = inveclen; 
+  }
+
+  // shift the window down to DC.  We only look at magnitudes, so
+  // the oscillator phase doesn't need to carry over from one buffer to the next. 
+  osc.setPhaseIncr(2.0 * M_PI * center_freq / sample_rate);
+  osc.mix(invec, work_buf, inveclen);
+
+  unsigned int len = inveclen;
+  for(unsigned int i = 0; i < hb_taps.size(); i++) {
+    len = halfBand(work_buf, len, hb_taps[i]); 
+  }
+
+  // The FFT is D times shorter, so the window gain is D times
+  // smaller.  Scaling by D puts tones (and the noise floor, which
+  // the decimation cut by D) back where the full band spectrogram
+  // had them, so the display doesn't jump.
+  float dscale = (float) decimation; 
+  for(unsigned int i = 0; i < len; i++) work_buf[i] = work_buf[i] * dscale; 
+  
+  spectrogram->apply_acc(work_buf, len, outvec, accumulation_gain);
+}
@@ -30,21 +30,36 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define SPECTROGRAM_HDR
 #include <fstream>
 #include <complex>
+#include <vector>
+#include <math.h>
 #include <fftw3.h>
 #include "SoDaBase.hxx"
+#include "QuadratureOscillator.hxx"
 
 namespace SoDa {
   /**
    * Spectrogram generates magnitude buffers from input sample stream. 
+   *
+   * This is a Welch estimate: the buffer is cut into overlapping
+   * segments, and the power spectra of the windowed segments are
+   * averaged.  All the segments of a buffer are windowed into one
+   * block and transformed by a single batched FFTW plan. 
    */
   class Spectrogram : public Base {
   public:
+    /// the window applied to each segment
+    enum WindowType { BLACKMAN_HARRIS, HANN, RECTANGULAR };
+    
     /**
      * @brief Constructor
      *
      * @param fftlen how many frequency points in the spectrogram buffer
+     * @param window_type the window for each segment
+     * @param overlap fraction of each segment shared with the next (0 to 0.9)
+     * @param nthreads number of threads for the batched FFT (if FFTW threads are available)
      */
-    Spectrogram(unsigned int fftlen);
+    Spectrogram(unsigned int fftlen, WindowType window_type = BLACKMAN_HARRIS, 
+		float overlap = 0.5, int nthreads = 1);
 
     /**
      * @brief Calculate the spectrogram from an input vector -- add it to
@@ -71,14 +86,29 @@ namespace SoDa {
     void apply_max(std::complex<float> * invec, unsigned int inveclen,
 		   float * outvec, bool first = true);
 
+    /**
+     * @brief build the batch FFT plan for input buffers of this length now.
+     *
+     * The plan depends on how many segments fit in a buffer.  Without
+     * this it is built by the first apply, which means the planner
+     * measures in the middle of the owner's loop.
+     *
+     * @param inveclen the length of the input buffers we'll see
+     */
+    void planFor(unsigned int inveclen);
     
   private:
 
     /**
-     * @brief all spectrograms are under a blackman harris window
+     * @brief build the window for each segment
      */
-    float * initBlackmanHarris();
+    float * initWindow(WindowType window_type);
 
+    /**
+     * @brief make sure the batch buffers and plan fit this many segments
+     */
+    void setupBatch(unsigned int num_segs);
+    
     /**
      * @brief this is the common spectrogram calculation (window + fft + mag)
      *
@@ -87,12 +117,102 @@ namespace SoDa {
      */
     void apply_common(std::complex<float> * invec, unsigned int inveclen);
     
-    fftwf_plan fftplan;
+    fftwf_plan fftplan; ///< transforms batch_segs segments at once
     float * window;
-    std::complex<float> * win_samp;
-    std::complex<float> * fft_out; 
+    std::complex<float> * win_samp; ///< windowed segments, end to end
+    std::complex<float> * fft_out; ///< their transforms, end to end
+    unsigned int batch_segs; ///< number of segments in the current plan
     float * result; 
     unsigned int fft_len; 
+    unsigned int hop; ///< samples from the start of one segment to the next
+    int fft_threads; 
+  }; 
+
+  /**
+   * ZoomSpectrogram generates magnitude buffers for a window of the
+   * input band.  The window is mixed down to DC and decimated (by
+   * half-band stages) before the FFT, so it gets the resolution of
+   * a full band spectrogram from a fraction of the FFT size.
+   */
+  class ZoomSpectrogram : public Base {
+  public:
+    /**
+     * @brief Constructor
+     *
+     * @param full_fftlen resolution to match -- that of a full band spectrogram of this length
+     * @param sample_rate input sample rate
+     * @param span width of the window we need to see
+     */
+    ZoomSpectrogram(unsigned int full_fftlen, double sample_rate, double span);
+
+    /**
+     * @brief Calculate the spectrogram of the window centered at
+     * center_freq -- add it to an accumulation buffer.
+     *
+     * The output is getFFTLen() buckets with center_freq at
+     * getFFTLen()/2, scaled to match a full band Spectrogram.
+     *
+     * @param invec the input sample buffer
+     * @param inveclen the length of the buffer
+     * @param outvec the result buffer
+     * @param accumulation_gain (out = result + out * acc_gain)
+     * @param center_freq center of the window, relative to the center of the input band (Hz)
+     */
+    void apply_acc(std::complex<float> * invec, unsigned int inveclen,
+		   float * outvec, float accumulation_gain, 
+		   double center_freq);
+
+    /**
+     * @brief can we see the whole window centered here? 
+     *
+     * @param center_freq center of the window, relative to the center of the input band (Hz)
+     * @return true if the window lies inside the input band
+     */
+    bool covers(double center_freq) {
+      return (fabs(center_freq) + 0.5 * span) < (0.5 * sample_rate);
+    }
+
+    /**
+     * @brief how many buckets in the output? 
+     */
+    unsigned int getFFTLen() { return fft_len; }
+
+    /**
+     * @brief the overall decimation rate
+     */
+    unsigned int getDecimation() { return decimation; }
+
+    /**
+     * @brief build the FFT plan for input buffers of this length now
+     * (see Spectrogram::planFor)
+     *
+     * @param inveclen the length of the (undecimated) input buffers
+     */
+    void planFor(unsigned int inveclen);
+    
+  private:
+    /**
+     * @brief decimate by two with the half-band filter
+     *
+     * @param buf input buffer, the result replaces it
+     * @param len number of input samples
+     * @return number of output samples
+     */
+    unsigned int halfBand(std::complex<float> * buf, unsigned int len, 
+			  const std::vector<float> & taps);
+
+    /**
+     * @brief how many samples does halfBand produce from len?
+     */
+    static unsigned int halfBandLen(unsigned int len, const std::vector<float> & taps);
+
+    std::vector<std::vector<float> > hb_taps; ///< odd taps 1, 3, 5... of each stage. (tap 0 is 0.5)
+    QuadratureOscillator osc; 
+    Spectrogram * spectrogram;
+    std::complex<float> * work_buf;
+    unsigned int work_len;
+    double sample_rate, span; 
+    unsigned int fft_len, decimation; 
   }; 
 }
 
@@ -0,0 +1,216 @@
+/*
+  Copyright (c) 2026, Matthew H. Reilly (kb1vc)
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+  Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in
+  the documentation and/or other materials provided with the
+  distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "SpectrumEncoding.hxx"
+#include <math.h>
+#include <string.h>
+
+using namespace SoDa::SpectrumEncoding; 
+
+SoDa::SpectrumEncoder::SpectrumEncoder()
+{
+  configure(FLOAT32, 0, -140.0, 180.0);
+  seq = 0;
+  rows_since_key = 0; 
+}
+
+void SoDa::SpectrumEncoder::configure(int _format, int _flags, float _floor_db, float _range_db)
+{
+  format = ((_format == UINT8) || (_format == UINT16)) ? _format : FLOAT32;
+  flags = _flags & DELTA_ROWS;
+  floor_db = _floor_db;
+  // anything narrower than a 10dB window is surely a mistake. 
+  range_db = (_range_db < 10.0) ? 10.0 : _range_db;
+  unsigned int qmax = (format == UINT8) ? 0xff : 0xffff; 
+  step_db = range_db / ((float) qmax); 
+  // the old rows mean nothing in the new encoding.
+  reset(); 
+}
+
+unsigned int SoDa::SpectrumEncoder::encode(const float * db, unsigned int num_buckets)
+{
+  if(format == FLOAT32) {
+    out_buf.resize(num_buckets * sizeof(float));
+    memcpy(out_buf.data(), db, num_buckets * sizeof(float));
+    return out_buf.size(); 
+  }
+
+  unsigned int qmax = (format == UINT8) ? 0xff : 0xffff;
+  float qscale = 1.0 / step_db; 
+  cur.resize(num_buckets);
+  for(unsigned int i = 0; i < num_buckets; i++) {
+    float q = floorf(0.5 + (db[i] - floor_db) * qscale);
+    // the comparisons are arranged so that a NaN lands on the floor
+    if(!(q > 0.0)) q = 0.0;
+    if(q > (float) qmax) q = (float) qmax;
+    cur[i] = (uint16_t) q; 
+  }
+
+  unsigned int ret = (format == UINT8) ? encodeRow<uint8_t>(num_buckets) : encodeRow<uint16_t>(num_buckets);
+  prev.swap(cur);
+  have_prev = true; 
+  seq++;
+  return ret; 
+}
+
+template<typename T> unsigned int SoDa::SpectrumEncoder::encodeRow(unsigned int num_buckets)
+{
+  const unsigned int max_run = (sizeof(T) == 1) ? 0xff : 0xffff; 
+  RowHeader hdr;
+  hdr.magic = ROW_MAGIC;
+  hdr.format = format; 
+  hdr.seq = seq;
+  hdr.num_buckets = num_buckets;
+  hdr.floor_db = floor_db;
+  hdr.step_db = step_db;
+  
+  // try a delta row.  A zero delta word is followed by the length of the
+  // run of unchanged buckets -- everything else is the change mod 2^bits.
+  // the scratch row keeps its capacity, so this only allocates
+  // when the row length grows.
+  std::vector<T> & words = scratch(T(0));
+  words.clear(); 
+  words.reserve(num_buckets);
+  bool use_delta = (flags & DELTA_ROWS) && have_prev && 
+    (prev.size() == num_buckets) && (rows_since_key < key_interval);
+  if(use_delta) {
+    unsigned int i = 0;
+    while((i < num_buckets) && (words.size() < num_buckets)) {
+      T d = (T) (cur[i] - prev[i]);
+      if(d != 0) {
+	words.push_back(d);
+	i++;
+      }
+      else {
+	unsigned int run = 1;
+	while(((i + run) < num_buckets) && (run < max_run) && (cur[i + run] == prev[i + run])) run++;
+	words.push_back(0);
+	words.push_back((T) run);
+	i += run; 
+      }
+    }
+    // the key row is no bigger, send that. 
+    if(words.size() >= num_buckets) use_delta = false; 
+  }
+
+  if(use_delta) {
+    hdr.coding = DELTA_ROW;
+    rows_since_key++; 
+  }
+  else {
+    words.resize(num_buckets);
+    for(unsigned int i = 0; i < num_buckets; i++) words[i] = (T) cur[i];
+    hdr.coding = KEY_ROW;
+    rows_since_key = 0; 
+  }
+  hdr.num_words = words.size();
+  
+  unsigned int len = sizeof(RowHeader) + words.size() * sizeof(T); 
+  out_buf.resize(len);
+  memcpy(out_buf.data(), &hdr, sizeof(RowHeader));
+  memcpy(out_buf.data() + sizeof(RowHeader), words.data(), words.size() * sizeof(T));
+  return len; 
+}
+
+bool SoDa::SpectrumDecoder::isEncoded(const char * buf, unsigned int len)
+{
+  if(len < sizeof(RowHeader)) return false;
+  uint32_t magic; 
+  memcpy(&magic, buf, sizeof(uint32_t));
+  return magic == ROW_MAGIC; 
+}
+
+bool SoDa::SpectrumDecoder::decode(const char * buf, unsigned int len, float * db, unsigned int num_buckets)
+{
+  if(!isEncoded(buf, len)) return false;
+  RowHeader hdr;
+  memcpy(&hdr, buf, sizeof(RowHeader));
+
+  unsigned int wsize = (hdr.format == UINT8) ? 1 : ((hdr.format == UINT16) ? 2 : 0);
+  if((wsize == 0) || (hdr.num_buckets != num_buckets) || 
+     ((len - sizeof(RowHeader)) != hdr.num_words * wsize)) {
+    return false; 
+  }
+
+  bool is_delta = (hdr.coding == DELTA_ROW);
+  if(is_delta && (!have_prev || (hdr.seq != (uint16_t) (seq + 1)))) {
+    // we missed a row -- wait for the next key row
+    have_prev = false; 
+    return false; 
+  }
+
+  bool ok; 
+  // the payload may not be aligned, so copy it out. 
+  if(wsize == 1) {
+    std::vector<uint8_t> words(hdr.num_words);
+    memcpy(words.data(), buf + sizeof(RowHeader), hdr.num_words);
+    ok = decodeRow<uint8_t>(words.data(), hdr.num_words, is_delta, num_buckets);
+  }
+  else {
+    std::vector<uint16_t> words(hdr.num_words);
+    memcpy(words.data(), buf + sizeof(RowHeader), hdr.num_words * 2);
+    ok = decodeRow<uint16_t>(words.data(), hdr.num_words, is_delta, num_buckets);
+  }
+
+  have_prev = ok;
+  if(!ok) return false;
+  seq = hdr.seq; 
+
+  for(unsigned int i = 0; i < num_buckets; i++) {
+    db[i] = hdr.floor_db + hdr.step_db * ((float) prev[i]);
+  }
+  return true; 
+}
+
+template<typename T> bool SoDa::SpectrumDecoder::decodeRow(const T * words, unsigned int num_words, 
+							   bool is_delta, unsigned int num_buckets)
+{
+  if(!is_delta) {
+    if(num_words != num_buckets) return false; 
+    prev.resize(num_buckets);
+    for(unsigned int i = 0; i < num_buckets; i++) prev[i] = words[i];
+    return true; 
+  }
+
+  if(prev.size() != num_buckets) return false;
+  unsigned int i = 0, w = 0; 
+  while(w < num_words) {
+    if(words[w] != 0) {
+      if(i >= num_buckets) return false; 
+      prev[i] = (T) (prev[i] + words[w]);
+      i++; w++; 
+    }
+    else {
+      if((w + 1) >= num_words) return false; 
+      i += words[w + 1]; 
+      w += 2; 
+    }
+  }
+  return i == num_buckets; 
+}
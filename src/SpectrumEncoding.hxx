@@ -0,0 +1,168 @@
+/*
+  Copyright (c) 2026, Matthew H. Reilly (kb1vc)
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+  Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in
+  the documentation and/or other materials provided with the
+  distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef SPECTRUM_ENCODING_HDR
+#define SPECTRUM_ENCODING_HDR
+
+#include <vector>
+#include <stdint.h>
+
+namespace SoDa {
+  /**
+   * @brief the wire format for spectrum rows on the waterfall socket.
+   *
+   * A spectrum row used to go out as one float (dB) per bucket.
+   * That's still the default, so an old client sees what it always
+   * saw.  A client that sends SET SPEC_ENCODING gets rows quantized to
+   * 8 or 16 bits over a dB window of its choosing, and can also ask
+   * for delta rows -- each bucket's change from the previous row,
+   * with runs of unchanged buckets squeezed down to two words.  A
+   * waterfall with a quiet band is mostly unchanged buckets.
+   *
+   * Every quantized row starts with a SpectrumRowHeader, so the
+   * decoder needs no state beyond the previous row.  The encoder
+   * sends a key row (a full row) every so often, and whenever the
+   * key row would be no bigger than the delta row, so a client that
+   * drops a row or connects late catches up quickly.
+   *
+   * The server and the GUI both compile this file.
+   */
+  namespace SpectrumEncoding {
+    /// the sample format -- these are the SET SPEC_ENCODING iparms[0] values
+    enum Format { FLOAT32 = 0, UINT8 = 1, UINT16 = 2 };
+    /// SET SPEC_ENCODING iparms[1] bits
+    enum Flags { DELTA_ROWS = 1 };
+    /// the header coding field
+    enum Coding { KEY_ROW = 0, DELTA_ROW = 1 };
+
+    /// marks a quantized row. 
+    static const uint32_t ROW_MAGIC = 0x53447746; // "FwDS"
+
+    struct RowHeader {
+      uint32_t magic;       ///< ROW_MAGIC
+      uint8_t format;       ///< UINT8 or UINT16
+      uint8_t coding;       ///< KEY_ROW or DELTA_ROW
+      uint16_t seq;         ///< row number -- a delta row applies to row seq - 1
+      uint32_t num_buckets; ///< buckets in the decoded row
+      uint32_t num_words;   ///< number of 8 or 16 bit words following the header
+      float floor_db;       ///< the dB level for a zero sample
+      float step_db;        ///< dB per quantization step
+    };
+  }
+
+  /**
+   * @brief quantize and (optionally) delta code spectrum rows
+   */
+  class SpectrumEncoder {
+  public:
+    SpectrumEncoder();
+
+    /**
+     * @brief choose the encoding.  Unreasonable values are
+     * adjusted -- the encoder's getters report what it actually chose.
+     *
+     * @param format FLOAT32, UINT8, or UINT16
+     * @param flags DELTA_ROWS or 0
+     * @param floor_db the lowest level we can send
+     * @param range_db the span from the lowest level to the highest
+     */
+    void configure(int format, int flags, float floor_db, float range_db);
+
+    /// start over with a key row -- for a new client
+    void reset() { have_prev = false; }
+
+    /**
+     * @brief encode a row of dB values
+     * @param db the row
+     * @param num_buckets its length
+     * @return the number of bytes in the encoded row -- see getBuffer
+     */
+    unsigned int encode(const float * db, unsigned int num_buckets);
+
+    /// the encoded row
+    const char * getBuffer() const { return out_buf.data(); }
+
+    int getFormat() const { return format; }
+    int getFlags() const { return flags; }
+    float getFloor() const { return floor_db; }
+    float getRange() const { return range_db; }
+
+    /// send a key row at least this often
+    static const unsigned int key_interval = 32; 
+    
+  private:
+    template<typename T> unsigned int encodeRow(unsigned int num_buckets);
+    std::vector<uint8_t> & scratch(uint8_t) { return words8; }
+    std::vector<uint16_t> & scratch(uint16_t) { return words16; }
+    
+    int format, flags;
+    float floor_db, range_db, step_db; 
+    
+    std::vector<uint16_t> cur, prev; ///< quantized rows
+    bool have_prev;
+    uint16_t seq;
+    unsigned int rows_since_key; 
+
+    std::vector<char> out_buf; 
+    std::vector<uint8_t> words8;  ///< encoded row scratch, one per word size
+    std::vector<uint16_t> words16; 
+  };
+
+  /**
+   * @brief turn encoded rows back into dB values
+   */
+  class SpectrumDecoder {
+  public:
+    SpectrumDecoder() { have_prev = false; seq = 0; }
+
+    /**
+     * @brief decode a row
+     * @param buf the row from the waterfall socket
+     * @param len its length in bytes
+     * @param db the decoded row
+     * @param num_buckets length of db
+     * @return false if this isn't a row we can decode -- a row of the
+     * wrong length, or a delta row whose predecessor we never saw.
+     */
+    bool decode(const char * buf, unsigned int len, float * db, unsigned int num_buckets);
+
+    /// true if buf holds a quantized row (rather than plain floats)
+    static bool isEncoded(const char * buf, unsigned int len);
+
+  private:
+    template<typename T> bool decodeRow(const T * words, unsigned int num_words, 
+					bool is_delta, unsigned int num_buckets);
+    
+    std::vector<uint16_t> prev; 
+    bool have_prev;
+    uint16_t seq; 
+  }; 
+}
+
+#endif
@@ -40,14 +40,44 @@
 #include <complex>
 #include "ReSampler.hxx"
 #include "TDResamplerTables625x48.hxx"
+#include "VecOps.hxx"
 
 namespace SoDa {
 
+  /**
+   * @brief inner product of a run of samples with a (real) filter bank.
+   *
+   * The float and complex<float> versions use the VecOps kernels;
+   * anything else gets the plain loop.
+   */
+  template<typename T> struct TDDotProduct {
+    static T dot(const T * x, const float * h, int len) {
+      T sum(0);
+      for(int i = 0; i < len; i++) sum += x[i] * h[i];
+      return sum; 
+    }
+  };
+
+  template<> struct TDDotProduct<float> {
+    static float dot(const float * x, const float * h, int len) {
+      return SoDa::VecOps::dot(x, h, len); 
+    }
+  };
+
+  template<> struct TDDotProduct<std::complex<float> > {
+    static std::complex<float> dot(const std::complex<float> * x, const float * h, int len) {
+      return SoDa::VecOps::dot(x, h, len); 
+    }
+  };
+
 
   template<typename T> class TDFilter : public SoDa::Base {
   public:
     TDFilter(const std::string & name) : SoDa::Base(name) { }
 
+    /// TDResampler625x48 deletes its stages through TDFilter pointers
+    virtual ~TDFilter() { }
+
     /**
      * @brief Perform decimation on a complex float buffer
      * @param in input buffer
@@ -91,14 +121,54 @@ namespace SoDa {
      */
     int apply(T * in, T * out, int inlen, int max_outlen);
 
+    /**
+     * @brief Resample a buffer whose history is already in place.
+     *
+     * The getHistoryLen() samples before in[0] must be the last samples
+     * of the previous call's input, so there is no prefix buffer to
+     * fill.  This is for the streaming resampler -- don't mix calls to
+     * apply and applyWithHistory on one object.
+     *
+     * @param in input buffer, preceded by getHistoryLen() samples of history
+     * @param out output buffer -- must have room for
+     * getMaxOutLen(inlen) samples
+     * @param inlen number of samples in input buffer
+     * @return number of samples in output buffer
+     */
+    int applyWithHistory(const T * in, T * out, int inlen) {
+      int m; 
+      for(m = 0; n < inlen; m++) {
+	out[m] = TDDotProduct<T>::dot(&in[n + 1 - bank_len], filter_bank[k], bank_len); 
+	bumpCounters();
+      }
+      n = n - inlen;
+      return m; 
+    }
+
+    /**
+     * @brief how many samples of history does applyWithHistory need? 
+     */
+    int getHistoryLen() const { return bank_len - 1; }
+
+    /**
+     * @brief most samples we can produce from inlen input samples
+     */
+    int getMaxOutLen(int inlen) const { return 1 + (inlen * L + M - 1) / M; }
+    
   private:
 
     void bumpCounters();
-    
+
+    /**
+     * One bank of taps per phase, time reversed and padded at the
+     * front with zeros to bank_len taps, so that each output is
+     * a contiguous inner product of bank_len input samples ending at x[n].
+     * The gain correction is folded into the taps.
+     */
     float ** filter_bank;
-    float * proto_filter; 
     T * prefix_buf;
-    int M, L, taps; 
+    int M, L, taps;
+    int bank_len; ///< taps rounded up to a multiple of 4 (one SSE/NEON vector)
     int k;
     int n; 
     float gain_correction; 
@@ -153,6 +223,230 @@ namespace SoDa {
     TDResamplerTables625x48 tables; 
   };
 
+  /**
+   * @brief An M:1 decimator that also mixes the input down by a tunable
+   * LO, for the first stage of the RX chain.
+   *
+   * Mixing the input by exp(-j w n) and then filtering gives
+   *
+   *   y[n] = sum_d h[d] x[n-d] exp(-j w (n-d))
+   *        = exp(-j w n) sum_d (h[d] exp(j w d)) x[n-d]
+   *
+   * so instead of rotating every input sample we rotate the taps
+   * once (when the LO is tuned) and apply exp(-j w n) to each output
+   * at the decimated rate.  The LO is a rotator stepped by exp(-j w M)
+   * per output, so its phase is continuous across buffers and retunes.
+   *
+   * It has the same interface as TDRationalResampler so it can stand
+   * in as the first stage of TDStreamResampler625x48.
+   */
+  class TDTranslatingDecimator : public TDFilter<std::complex<float> > {
+  public:
+    /** 
+     * @brief Create a frequency translating decimator 
+     * @param _M decimation rate.  
+     * @param _L interpolation rate -- must be 1
+     * @param proto_filter prototype low-pass anti-aliasing filter
+     * @param filter_len length of prototype filter.
+     * @param gain filter gain
+     */
+    TDTranslatingDecimator(int _M, int _L, float * proto_filter, int filter_len, float gain = 1.0) :
+      TDFilter<std::complex<float> >("TDTranslatingDecimator")
+    {
+      if(_L != 1) {
+	throw SoDa::Radio::Exception("TDTranslatingDecimator only decimates -- L must be 1", this);
+      }
+      M = _M;
+      taps = filter_len; 
+      bank_len = (taps + 3) & ~3;
+      n = 0;
+      out_count = 0; 
+
+      float fsum = 0.0; 
+      for(int i = 0; i < filter_len; i++) fsum += proto_filter[i]; 
+
+      // same layout as the TDRationalResampler bank -- time reversed
+      // with the zero padding at the front.
+      bank = new float[bank_len];
+      cbank = new std::complex<float>[bank_len]; 
+      for(int j = 0; j < bank_len; j++) bank[j] = 0.0; 
+      for(int j = 0; j < taps; j++) {
+	bank[bank_len - 1 - j] = proto_filter[j] * gain / fsum; 
+      }
+
+      prefix_buf = new std::complex<float>[bank_len * 2];
+      for(int i = 0; i < bank_len * 2; i++) prefix_buf[i] = std::complex<float>(0.0, 0.0);
+
+      lo = std::complex<double>(1.0, 0.0);
+      setPhaseIncr(0.0); 
+    }
+
+    ~TDTranslatingDecimator() {
+      delete[] bank;
+      delete[] cbank;
+      delete[] prefix_buf; 
+    }
+
+    /**
+     * @brief tune the LO
+     * @param phase_incr LO frequency in radians per input sample -- the
+     * input is multiplied by exp(-j phase_incr n)
+     */
+    void setPhaseIncr(double phase_incr) {
+      // bank[j] multiplies x[n - d] where d = bank_len - 1 - j
+      for(int j = 0; j < bank_len; j++) {
+	double d = (double) (bank_len - 1 - j);
+	cbank[j] = std::complex<float>(std::polar((double) bank[j], phase_incr * d));
+      }
+      lo_step = std::polar(1.0, -phase_incr * ((double) M)); 
+    }
+
+    /**
+     * @brief Mix and decimate a buffer
+     * @param in input buffer
+     * @param out output buffer 
+     * @param inlen number of samples in input buffer
+     * @param max_outlen maximum number of samples in output buffer
+     * @return number of samples in output buffer
+     */
+    int apply(std::complex<float> * in, std::complex<float> * out, int inlen, int max_outlen) {
+      std::complex<float> * x = &prefix_buf[bank_len];
+      memcpy(x, in, sizeof(std::complex<float>) * bank_len);
+      int m; 
+      for(m = 0; (m < max_outlen) && (n < inlen); m++) {
+	out[m] = step(&x[n + 1 - bank_len]);
+	if((x != in) && (n > (bank_len - 2))) x = in; 
+      }
+      memcpy(prefix_buf, in + (inlen - bank_len), sizeof(std::complex<float>) * bank_len);
+      n = n - inlen;
+      return m; 
+    }
+
+    /// see TDRationalResampler::applyWithHistory
+    int applyWithHistory(const std::complex<float> * in, std::complex<float> * out, int inlen) {
+      int m; 
+      for(m = 0; n < inlen; m++) {
+	out[m] = step(&in[n + 1 - bank_len]);
+      }
+      n = n - inlen;
+      return m; 
+    }
+
+    /// see TDRationalResampler::getHistoryLen
+    int getHistoryLen() const { return bank_len - 1; }
+
+    /// see TDRationalResampler::getMaxOutLen
+    int getMaxOutLen(int inlen) const { return 1 + (inlen + M - 1) / M; }
+    
+  private:
+    /**
+     * @brief produce one output from the bank_len samples at x and 
+     * step the LO and the input index.
+     */
+    std::complex<float> step(const std::complex<float> * x) {
+      std::complex<float> ret = SoDa::VecOps::dot(x, cbank, bank_len) 
+	* std::complex<float>(lo.real(), lo.imag());
+      lo = lo * lo_step;
+      // keep the rotator on the unit circle
+      if(++out_count == 512) {
+	out_count = 0;
+	lo = lo / std::abs(lo); 
+      }
+      n += M; 
+      return ret; 
+    }
+    
+    float * bank; ///< time reversed taps, gain corrected
+    std::complex<float> * cbank; ///< bank rotated by the LO
+    std::complex<float> * prefix_buf;
+    std::complex<double> lo; ///< LO phasor for the current output
+    std::complex<double> lo_step; ///< LO advance per output sample
+    int M, taps, bank_len; 
+    int n;
+    int out_count; 
+  };
+  
+  /**
+   * @brief A streaming version of TDResampler625x48
+   *
+   * TDResampler625x48 runs each of its four stages over the whole
+   * input buffer (30000 samples at the IF rate) and writes a full
+   * intermediate buffer between each stage, so every stage streams
+   * its data in from main memory.
+   *
+   * This version carves the input into tiles of a few thousand samples
+   * and runs each tile through all four stages before moving on to the
+   * next.  Each stage's input buffer starts with its history (the last
+   * few samples of the previous tile) so the filters can read straight
+   * through it.  The intermediate buffers are sized for one tile and
+   * stay in L1.
+   *
+   * The filters are the same as TDResampler625x48's, and so is the output.
+   *
+   * The first (5:1) stage is a TDRationalResampler unless FirstStage
+   * says otherwise -- the RX chain uses a TDTranslatingDecimator to
+   * fold the 3rd LO into it.
+   */
+  template<typename T, typename FirstStage = TDRationalResampler<T> > 
+  class TDStreamResampler625x48 : public TDFilter<T> { 
+  public:
+    /** 
+     * @brief Create a chain of rational resamplers to 
+     * downsample from 625ks/Sec to 48ks/Sec
+     * @param gain filter gain
+     * @param tile_len number of input samples to push through all stages at once
+     */
+    TDStreamResampler625x48(float gain = 1.0, int tile_len = 1250); 
+    ~TDStreamResampler625x48() {
+      delete rs51_p;
+      for(int i = 0; i < 4; i++) {
+	if(i > 0) delete stages[i];
+	delete[] bufs[i];
+      }
+      delete[] obuf; 
+    }
+
+    /**
+     * @brief Perform interpolation on a complex float buffer
+     * @param in input buffer
+     * @param out output buffer 
+     * @param inlen number of samples in input buffer
+     * @param max_outlen maximum number of samples in output buffer
+     * @return number of samples in output buffer
+     */
+    int apply(T * in, T * out, int inlen, int max_outlen);
+
+    /**
+     * @brief tune the LO in the first stage (FirstStage = TDTranslatingDecimator only)
+     * @param phase_incr LO frequency in radians per input sample
+     */
+    void setPhaseIncr(double phase_incr) { rs51_p->setPhaseIncr(phase_incr); }
+    
+  private:
+    /**
+     * @brief push one tile through stages 2 through 4
+     * @param len number of samples that stage 1 put in bufs[1]
+     * @param out where the 48kS/s samples go
+     * @param max_outlen room left in out
+     * @return number of samples written to out
+     */
+    int applyTail(int len, T * out, int max_outlen); 
+
+    /// first stage resampler: 5 to 1
+    FirstStage * rs51_p; 
+    /// 5:3, 5:4, 5:4 in stages[1..3]. (stages[0] is unused)
+    TDRationalResampler<T> * stages[4];
+    /// stage i's input: getHistoryLen() samples of history, then the tile
+    T * bufs[4];
+    /// where each stage's input tile starts (after the history)
+    T * tile_start[4];
+    /// the last stage writes here, in case out fills up.
+    T * obuf;
+    int tile_len; 
+
+    TDResamplerTables625x48 tables; 
+  };
+  
   template <typename T> TDRationalResampler<T>::TDRationalResampler(int _M, int _L, float * _proto_filter, int filter_len, float gain) :
     TDFilter<T>(SoDa::Format("RationalResampler %0 to %1")
 		.addI(M)
@@ -161,26 +455,27 @@ namespace SoDa {
     M = _M; 
     L = _L; 
     taps = filter_len / L;
+    bank_len = (taps + 3) & ~3; 
     k = 0;   
     n = 0; 
-    prefix_buf = new T[taps * 2];
+    prefix_buf = new T[bank_len * 2];
     int i; 
-    for(i = 0; i < taps * 2; i++) prefix_buf[i] = T(0);
+    for(i = 0; i < bank_len * 2; i++) prefix_buf[i] = T(0);
 
-    proto_filter = new float[filter_len]; 
-    memcpy(proto_filter, _proto_filter, sizeof(float) * filter_len); 
+    float fsum = 0.0; 
+    for(i = 0; i < filter_len; i++) fsum += _proto_filter[i]; 
+
+    gain_correction = gain * ((float) L) / fsum;
 
+    // filter_bank[i][bank_len - 1 - j] multiplies x[n - j]
     filter_bank = new float*[L]; 
     for(i = 0; i < L; i++) {
-      filter_bank[i] = new float[taps]; 
+      filter_bank[i] = new float[bank_len];
+      for(int j = 0; j < bank_len; j++) filter_bank[i][j] = 0.0; 
       for(int j = 0; j < taps; j++) {
-	filter_bank[i][j] = proto_filter[i + j * L]; 
+	filter_bank[i][bank_len - 1 - j] = _proto_filter[i + j * L] * gain_correction; 
       }
     }
-    float fsum = 0.0; 
-    for(i = 0; i < filter_len; i++) fsum += proto_filter[i]; 
-
-    gain_correction = gain * ((float) L) / fsum;
   }
 
   template<typename T> int TDRationalResampler<T>::apply(T *in, T * out, 
@@ -189,34 +484,27 @@ namespace SoDa {
     // Using the terminology from Lyons pp 541 -- note that we use the
     // recurrence sum in equation 10-20'' rather than the fancy diagram
     // with the separate shift registers.  
-    T zero(0);
-    T rsum; 
-
     T * x; 
-    x = &prefix_buf[taps];
+    x = &prefix_buf[bank_len];
     // we need a prefix buffer for the "old" samples before in[n]
-    memcpy(x, in, sizeof(T) * taps);
+    memcpy(x, in, sizeof(T) * bank_len);
 
     int m; 
     // first consume the prefix buffer, then the input vector
     for(m = 0; (m < max_outlen) && (n < inlen); m++) {
-      rsum = zero; 
-      for(int i = 0; i < taps; i++) {
-	// rsum += filter_bank[k][i] * x[n - i];
-	rsum += proto_filter[i * L + k] * x[n - i];
-      }
-      out[m] = rsum * gain_correction; 
+      // sum of filter_bank[k][j] * x[n + 1 - bank_len + j]
+      out[m] = TDDotProduct<T>::dot(&x[n + 1 - bank_len], filter_bank[k], bank_len); 
       bumpCounters();
       // once we've gotten through the prefix (leftover from last pass)
       // switch to the actual input buffer
-      if((x != in) && (n > (taps - 2))) {
+      if((x != in) && (n > (bank_len - 2))) {
 	x = in; 
       }
     }
 
     // now save the last of the input vector
-    for(int i = 0; i < taps; i++) {
-      prefix_buf[i] = in[i + (inlen - taps)]; 
+    for(int i = 0; i < bank_len; i++) {
+      prefix_buf[i] = in[i + (inlen - bank_len)]; 
     }
     n = n - inlen; 
     return m; 
@@ -280,5 +568,79 @@ namespace SoDa {
     return len; 
   }
   
+  template<typename T, typename FirstStage> 
+  TDStreamResampler625x48<T, FirstStage>::TDStreamResampler625x48(float gain, int _tile_len) :
+    TDFilter<T>("TDStreamResampler625x48")
+  {
+    tile_len = _tile_len;
+    
+    rs51_p = new FirstStage(5, 1, tables.HCLPF35_5x1_125, 35);
+    stages[0] = NULL; 
+    stages[1] = new TDRationalResampler<T>(5, 3, tables.PMLPF30_5x3_75, 30);
+    stages[2] = new TDRationalResampler<T>(5, 4, tables.PMLPF32_5x4_60, 32);
+    stages[3] = new TDRationalResampler<T>(5, 4, tables.PMLPF40_5x4_48, 40, gain);
+
+    int len = tile_len; 
+    for(int i = 0; i < 4; i++) {
+      int hist = (i == 0) ? rs51_p->getHistoryLen() : stages[i]->getHistoryLen();
+      bufs[i] = new T[hist + len];
+      for(int j = 0; j < hist + len; j++) bufs[i][j] = T(0);
+      tile_start[i] = bufs[i] + hist;
+      len = (i == 0) ? rs51_p->getMaxOutLen(len) : stages[i]->getMaxOutLen(len); 
+    }
+    obuf = new T[len]; 
+  }
+
+  template<typename T, typename FirstStage> 
+  int TDStreamResampler625x48<T, FirstStage>::applyTail(int len, T * out, int max_outlen)
+  {
+    for(int i = 1; i < 4; i++) {
+      T * dest = (i == 3) ? obuf : tile_start[i + 1];
+      int olen = stages[i]->applyWithHistory(tile_start[i], dest, len);
+      // the end of this tile is the history for the next one.
+      memmove(bufs[i], bufs[i] + len, sizeof(T) * stages[i]->getHistoryLen()); 
+      len = olen; 
+    }
+
+    if(len > max_outlen) len = max_outlen; 
+    memcpy(out, obuf, sizeof(T) * len);
+    return len; 
+  }
+  
+  template<typename T, typename FirstStage> 
+  int TDStreamResampler625x48<T, FirstStage>::apply(T * in, 
+						    T * out, 
+						    int inlen, int max_outlen)
+  {
+    int hist = rs51_p->getHistoryLen(); 
+    int m = 0;
+    int len; 
+
+    for(int pos = 0; pos < inlen; pos += len) {
+      len = ((inlen - pos) < tile_len) ? (inlen - pos) : tile_len;
+      // Until we're hist samples into the input buffer, the history
+      // for the first stage is at the end of the last input buffer,
+      // so the tile goes through bufs[0].  After that, the history
+      // is right there in the input buffer. 
+      bool use_buf = pos < hist; 
+      T * x = in + pos; 
+      if(use_buf) {
+	memcpy(tile_start[0], x, sizeof(T) * len);
+	x = tile_start[0]; 
+      }
+      int olen = rs51_p->applyWithHistory(x, tile_start[1], len);
+      if(use_buf) {
+	memmove(bufs[0], bufs[0] + len, sizeof(T) * hist); 
+      }
+      m += applyTail(olen, out + m, max_outlen - m); 
+    }
+
+    // save the end of the input as history for the next call
+    if(inlen >= hist) {
+      memcpy(bufs[0], in + (inlen - hist), sizeof(T) * hist);
+    }
+    
+    return m; 
+  }
 }
 #endif
@@ -89,6 +89,15 @@ namespace SoDa {
 	debug = v;
       }
 
+      /**
+       * @brief which descriptor should we poll for input?
+       *
+       * @return the connection if we have one, otherwise the listening socket.
+       */
+      int getWaitFD() {
+	return ready ? conn_socket : server_socket; 
+      }
+
     private:
       bool debug; 
       bool ready;
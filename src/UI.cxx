@@ -28,6 +28,7 @@
 
 #include "UI.hxx"
 #include "version.h"
+#include "VecOps.hxx"
 
 const double SoDa::UI::spectrum_span = 200e3;
 
@@ -50,7 +51,7 @@ SoDa::UI::UI(Params * params) : SoDa::Thread("UI")
   
   // create the spectrogram object -- it eats RX IF buffers and produces
   // power spectral density plots.
-  spectrogram_buckets = 4 * 4096;
+  spectrogram_buckets = spectrogram_len;
   spectrogram = new Spectrogram(spectrogram_buckets);
 
   // we also need an LO check spectrogram.  In particular we want
@@ -68,6 +69,19 @@ SoDa::UI::UI(Params * params) : SoDa::Thread("UI")
   hz_per_bucket = rxrate / ((float) spectrogram_buckets);
   required_spect_buckets = (int) (floor(0.5 + spectrum_span / hz_per_bucket));
   lo_hz_per_bucket = rxrate / ((float) lo_spectrogram_buckets);
+
+  zoom_spectrogram = new ZoomSpectrogram(spectrogram_buckets, rxrate, spectrum_span);
+
+  // plan the transforms now, not on the first IF buffer. 
+  unsigned int if_len = params->getRFBufferSize();
+  spectrogram->planFor(if_len);
+  lo_spectrogram->planFor(if_len);
+  zoom_spectrogram->planFor(if_len);
+  zoom_spectrum = new float[zoom_spectrogram->getFFTLen()];
+  for(unsigned int i = 0; i < zoom_spectrogram->getFFTLen(); i++) {
+    zoom_spectrum[i] = 1e-20; 
+  }
+  zoom_mode = false; 
   
   // now allocate the buffer that we'll send to the UI
   spectrum = new float[spectrogram_buckets * 4];
@@ -80,6 +94,7 @@ SoDa::UI::UI(Params * params) : SoDa::Thread("UI")
 
   fft_send_counter = 0;
   fft_update_interval = 4;
+  wfall_connected = false; 
   new_spectrum_setting = true;
   fft_acc_gain = 0.9;
   // we are not yet in lo check mode
@@ -88,15 +103,15 @@ SoDa::UI::UI(Params * params) : SoDa::Thread("UI")
 
 void SoDa::UI::updateSpectrumState()
 {
-  cmd_stream->put(new SoDa::Command(Command::REP, Command::SPEC_STEP,
+  cmd_stream->put(cmd_stream->make(Command::REP, Command::SPEC_STEP,
 				    hz_per_bucket));
-  cmd_stream->put(new SoDa::Command(Command::REP, Command::SPEC_BUF_LEN,
+  cmd_stream->put(cmd_stream->make(Command::REP, Command::SPEC_BUF_LEN,
 				    required_spect_buckets));
-  cmd_stream->put(new SoDa::Command(Command::REP, Command::SPEC_RANGE_LOW,
+  cmd_stream->put(cmd_stream->make(Command::REP, Command::SPEC_RANGE_LOW,
 				    spectrum_center_freq - 0.5 * spectrum_span));
-  cmd_stream->put(new SoDa::Command(Command::REP, Command::SPEC_RANGE_HI,
+  cmd_stream->put(cmd_stream->make(Command::REP, Command::SPEC_RANGE_HI,
 				    spectrum_center_freq + 0.5 * spectrum_span));
-  cmd_stream->put(new SoDa::Command(Command::REP, Command::SPEC_DIMS, 
+  cmd_stream->put(cmd_stream->make(Command::REP, Command::SPEC_DIMS, 
 				    spectrum_center_freq, 
 				    spectrum_span, 
 				    ((double) required_spect_buckets)));
@@ -111,6 +126,8 @@ SoDa::UI::~UI()
 void SoDa::UI::run()
 {
   SoDa::Command * net_cmd, * ring_cmd;
+  const unsigned int cmd_batch_size = 16; 
+  SoDa::Command * ring_cmds[cmd_batch_size]; 
 
   if((cwtxt_stream == NULL) || 
      (if_stream == NULL) || 
@@ -128,15 +145,20 @@ void SoDa::UI::run()
   net_cmd = NULL;
   ring_cmd = NULL;
   
-  cmd_stream->put(new SoDa::Command(Command::SET, Command::RX_FE_FREQ, 144.2e6));
-  cmd_stream->put(new SoDa::Command(Command::SET, Command::TX_FE_FREQ, 144.2e6));
-  cmd_stream->put(new SoDa::Command(Command::SET, Command::RX_LO3_FREQ, 100e3));
-  cmd_stream->put(new SoDa::Command(Command::SET, Command::RX_AF_FILTER, 1));
+  cmd_stream->put(cmd_stream->make(Command::SET, Command::RX_FE_FREQ, 144.2e6));
+  cmd_stream->put(cmd_stream->make(Command::SET, Command::TX_FE_FREQ, 144.2e6));
+  cmd_stream->put(cmd_stream->make(Command::SET, Command::RX_LO3_FREQ, 100e3));
+  cmd_stream->put(cmd_stream->make(Command::SET, Command::RX_AF_FILTER, 1));
   sleep_ms(100);
-  cmd_stream->put(new SoDa::Command(Command::SET, Command::TX_STATE, 0));
+  cmd_stream->put(cmd_stream->make(Command::SET, Command::TX_STATE, 0));
 
   updateSpectrumState(); 
 
+  SoDa::WaitSet wait_set;
+  wait_set.add(cmd_stream, cmd_subs);
+  wait_set.add(gps_stream, gps_subs);
+  wait_set.add(if_stream, if_subs);
+
   unsigned int socket_read_count = 0;
   unsigned int socket_empty_count = 0;
   unsigned int iter_count = 0;
@@ -147,23 +169,29 @@ void SoDa::UI::run()
     bool got_new_netmsg = false; 
     // listen on the socket.
 
+    // nobody needs IF buffers unless there is a spectrum listener.
+    if_stream->setActive(if_subs, wfall_socket->isReady());
+
     if(server_socket->isReady()) {
       if(new_connection) {
 	updateSpectrumState();
+	// a new client gets plain float rows until it asks for something else.
+	spect_encoder.configure(SpectrumEncoding::FLOAT32, 0, 
+				spect_encoder.getFloor(), spect_encoder.getRange());
 
 	std::string vers= SoDa::Format("%0 Git %1")
 	  .addS(SoDaRadio_VERSION)
 	  .addS(SoDaRadio_GIT_ID).str();
 	
-	SoDa::Command * vers_cmd = new SoDa::Command(Command::REP,
-						     Command::SDR_VERSION,
-						     vers.c_str());
-	server_socket->put(vers_cmd, sizeof(SoDa::Command));
+	SoDa::Command vers_cmd(Command::REP,
+			       Command::SDR_VERSION,
+			       vers.c_str());
+	server_socket->put(&vers_cmd, sizeof(SoDa::Command));
 	new_connection = false; 
       }
       
       if(net_cmd == NULL) {
-	net_cmd = new SoDa::Command();
+	net_cmd = cmd_stream->make();
       }
       int stat = server_socket->get(net_cmd, sizeof(SoDa::Command));
       if(stat <= 0) {
@@ -181,48 +209,62 @@ void SoDa::UI::run()
     // if there are commands arriving from the socket port, handle them.
     if(got_new_netmsg) {
       debugMsg(SoDa::Format("UI got message [%0]\n").addS(net_cmd->toString()));
+      // once it is posted, the command belongs to the subscribers
+      SoDa::Command::CmdTarget net_target = net_cmd->target; 
       cmd_stream->put(net_cmd);
       didwork = true;
-      if(net_cmd->target == SoDa::Command::TX_CW_EMPTY) {
+      if(net_target == SoDa::Command::TX_CW_EMPTY) {
        	debugMsg("got TX_CW_EMPTY command from socket.\n"); 
       }
-      if(net_cmd->target == SoDa::Command::STOP) {
+      if(net_target == SoDa::Command::STOP) {
 	// relay "stop" commands to the GPS unit. 
-	gps_stream->put(new SoDa::Command(Command::SET, Command::STOP, 0));
+	gps_stream->put(gps_stream->make(Command::SET, Command::STOP, 0));
 	break;
       }
       net_cmd = NULL; 
     }
 
-    while((ring_cmd = cmd_stream->get(cmd_subs)) != NULL) {
-      if(ring_cmd->cmd == SoDa::Command::REP) {
-	server_socket->put(ring_cmd, sizeof(SoDa::Command));
-      }
-      // if(net_cmd->target == SoDa::Command::TX_CW_EMPTY) {
-      // 	debugMsg("send TX_CW_EMPTY report to socket.\n"); 
-      // }
+    unsigned int i, ncmds; 
+    bool got_stop = false; 
+    while((ncmds = cmd_stream->getBatch(cmd_subs, ring_cmds, cmd_batch_size)) != 0) {
+      for(i = 0; i < ncmds; i++) {
+	ring_cmd = ring_cmds[i]; 
+	// somebody other than the client (a radio that ran out of
+	// samples, say) can stop the server, too. 
+	got_stop |= (ring_cmd->target == SoDa::Command::STOP); 
+	if(ring_cmd->cmd == SoDa::Command::REP) {
+	  server_socket->put(ring_cmd, sizeof(SoDa::Command));
+	}
+	// if(net_cmd->target == SoDa::Command::TX_CW_EMPTY) {
+	// 	debugMsg("send TX_CW_EMPTY report to socket.\n"); 
+	// }
       
-      execCommand(ring_cmd); 
-      cmd_stream->free(ring_cmd);
+	execCommand(ring_cmd); 
+      }
+      cmd_stream->freeBatch(ring_cmds, ncmds);
       didwork = true; 
     }
+    if(got_stop) {
+      gps_stream->put(gps_stream->make(Command::SET, Command::STOP, 0));
+      break;
+    }
 
-    while((ring_cmd = gps_stream->get(gps_subs)) != NULL) {
-      if(ring_cmd->cmd == SoDa::Command::REP) {
-	server_socket->put(ring_cmd, sizeof(SoDa::Command));
+    while((ncmds = gps_stream->getBatch(gps_subs, ring_cmds, cmd_batch_size)) != 0) {
+      for(i = 0; i < ncmds; i++) {
+	ring_cmd = ring_cmds[i]; 
+	if(ring_cmd->cmd == SoDa::Command::REP) {
+	  server_socket->put(ring_cmd, sizeof(SoDa::Command));
+	}
+	execCommand(ring_cmd); 
       }
-      execCommand(ring_cmd); 
-      gps_stream->free(ring_cmd);
+      gps_stream->freeBatch(ring_cmds, ncmds);
       didwork = true; 
     }
       
     
-    // listen ont the IF stream
-    int bcount;
+    // listen ont the IF stream -- we only ever see the latest buffer.
     SoDa::Buf * if_buf; 
-    for(bcount = 0;
-	(bcount < 4) && ((if_buf = if_stream->get(if_subs)) != NULL);
-	bcount++) {
+    if((if_buf = if_stream->get(if_subs)) != NULL) {
       sendFFT(if_buf);
       if_stream->free(if_buf); 
     }
@@ -234,9 +276,14 @@ void SoDa::UI::run()
     // if there are any socket listeners on the status channel,
     // clue them in.
     
-    // if there is nothing to do, sleep for a little while. -- 
-    // do small sleep, to speedup spectrum update.
-    if(!didwork) sleep_us(5000);
+    // if there is nothing to do, sleep until a mailbox or the
+    // client socket has something for us.  The timeout is just
+    // a backstop for connection state changes that poll can't see.
+    if(!didwork) {
+      wait_set.clearFDs();
+      wait_set.addFD(server_socket->getWaitFD());
+      wait_set.wait(100000);
+    }
   }
 
 
@@ -245,24 +292,24 @@ void SoDa::UI::run()
 
 void SoDa::UI::reportSpectrumCenterFreq()
 {
-    server_socket->put(new SoDa::Command(Command::REP, Command::SPEC_RANGE_LOW,
-					 spectrum_center_freq - 0.5 * spectrum_span),
-		       sizeof(SoDa::Command));
-    server_socket->put(new SoDa::Command(Command::REP, Command::SPEC_RANGE_HI,
-					 spectrum_center_freq + 0.5 * spectrum_span),
-		       sizeof(SoDa::Command));
-    server_socket->put(new SoDa::Command(Command::REP, Command::SPEC_STEP,
-					 hz_per_bucket),
-		       sizeof(SoDa::Command));
-    server_socket->put(new SoDa::Command(Command::REP, Command::SPEC_BUF_LEN,
-					 required_spect_buckets),
-		       sizeof(SoDa::Command));
-    server_socket->put(new SoDa::Command(Command::REP, Command::SPEC_DIMS, 
-					 spectrum_center_freq, 
-					 spectrum_span, 
-					 ((double) required_spect_buckets)), 
-		       sizeof(SoDa::Command));
-    
+    // these go straight to the socket, so they can live on the stack.
+    SoDa::Command range_low(Command::REP, Command::SPEC_RANGE_LOW,
+			    spectrum_center_freq - 0.5 * spectrum_span);
+    server_socket->put(&range_low, sizeof(SoDa::Command));
+    SoDa::Command range_hi(Command::REP, Command::SPEC_RANGE_HI,
+			   spectrum_center_freq + 0.5 * spectrum_span);
+    server_socket->put(&range_hi, sizeof(SoDa::Command));
+    SoDa::Command step(Command::REP, Command::SPEC_STEP,
+		       hz_per_bucket);
+    server_socket->put(&step, sizeof(SoDa::Command));
+    SoDa::Command buf_len(Command::REP, Command::SPEC_BUF_LEN,
+			  required_spect_buckets);
+    server_socket->put(&buf_len, sizeof(SoDa::Command));
+    SoDa::Command dims(Command::REP, Command::SPEC_DIMS, 
+		       spectrum_center_freq, 
+		       spectrum_span, 
+		       ((double) required_spect_buckets));
+    server_socket->put(&dims, sizeof(SoDa::Command));
 }
 
 
@@ -288,6 +335,16 @@ void SoDa::UI::execSetCommand(Command * cmd)
 	     .addI(cmd->iparms[0])
 	     .addI(fft_update_interval));
     break; 
+  case SoDa::Command::SPEC_ENCODING:
+    spect_encoder.configure(cmd->iparms[0], cmd->iparms[1], 
+			    (float) cmd->iparms[2], (float) cmd->iparms[3]);
+    // tell the client what it will actually get.
+    cmd_stream->put(cmd_stream->make(Command::REP, Command::SPEC_ENCODING, 
+				     spect_encoder.getFormat(), 
+				     spect_encoder.getFlags(),
+				     (int) spect_encoder.getFloor(),
+				     (int) spect_encoder.getRange()));
+    break; 
   default:
     break; 
   }
@@ -301,6 +358,12 @@ void SoDa::UI::execGetCommand(Command * cmd)
     lo_check_mode = true;
     fft_send_counter = 0; 
     break; 
+  case SoDa::Command::DBG_REP: // report status
+    if(SoDa::Command::UnitSelector(cmd->iparms[0]) == SoDa::Command::MBOXES) {
+      std::cerr << SoDa::BaseMBox::getAllStats();
+      std::cerr << SoDa::BufArena::describe() << std::endl;
+    }
+    break; 
   default:
     break;
   }
@@ -319,118 +382,139 @@ void SoDa::UI::execRepCommand(Command * cmd)
 }
 
 
-static unsigned int dbgctrfft = 0;
-static bool first_ready = true;
-static bool calc_max_first = true;
-
 void SoDa::UI::sendFFT(SoDa::Buf * buf)
 {
   fft_send_counter++; 
-  dbgctrfft++; 
   if(!wfall_socket->isReady()) {
+    wfall_connected = false; 
     return;
   }
-  if(first_ready == true) dbgctrfft = 0;
-  first_ready = false; 
-  
+  if(!wfall_connected) {
+    // a delta row means nothing to a new listener.
+    spect_encoder.reset();
+    wfall_connected = true; 
+  }
   
-  // Do an FFT on the buffer
-  // Note that we'll only send over on buffer every
-  // fft_update_interval times that we're called -- this will keep
-  // the IP traffic to something reasonable. 
   if(lo_check_mode) {
     lo_spectrogram->apply_acc(buf->getComplexBuf(), buf->getComplexLen(), lo_spectrum, (fft_send_counter == 0) ? 0.0 : 0.1);
+    if(fft_send_counter >= 8) reportLOOffset();
+    return; 
   }
-  else {
-    spectrogram->apply_acc(buf->getComplexBuf(), buf->getComplexLen(), spectrum,
-			   (new_spectrum_setting) ? 0.0 : fft_acc_gain);
-  }
-  new_spectrum_setting = false; 
-  calc_max_first = false; 
 
-  float * slice = spectrum;
+  // Note that we'll only send over on buffer every
+  // fft_update_interval times that we're called -- this will keep
+  // the IP traffic to something reasonable.  Nobody sees the
+  // spectra in between, so don't bother calculating them. 
+  unsigned int period = (fft_update_interval < 1) ? 1 : fft_update_interval;
+  if(fft_send_counter < period) {
+    return; 
+  }
   
-  if(!lo_check_mode) {
-    // find the right slice
-    int idx;
+  // We used to fold every buffer into the average.  Now we
+  // fold in one of every [period], so stretch the decay to
+  // keep the same time constant.
+  double offset = spectrum_center_freq - baseband_rx_freq;
+  bool use_zoom = zoom_spectrogram->covers(offset);
+  float acc_gain = (new_spectrum_setting || (use_zoom != zoom_mode)) ? 0.0 : pow(fft_acc_gain, (float) period);
+  new_spectrum_setting = false; 
+  zoom_mode = use_zoom; 
+
+  float * slice = NULL;
+  // find the right slice
+  int idx;
+  // offset of the display center from the baseband rx freq, in buckets
+  int offset_buckets = (int) round(offset / hz_per_bucket);
+  if(use_zoom) {
+    // mix the window down by a whole number of buckets, so we
+    // land on the same frequency grid as the full band spectrum.
+    zoom_spectrogram->apply_acc(buf->getComplexBuf(), buf->getComplexLen(), zoom_spectrum,
+				acc_gain, hz_per_bucket * ((double) offset_buckets));
+    idx = (zoom_spectrogram->getFFTLen() / 2) - (required_spect_buckets / 2);
+    slice = &(zoom_spectrum[idx]);
+  }
+  else {
+    // the window hangs off the edge of the IF band, do the whole thing. 
+    spectrogram->apply_acc(buf->getComplexBuf(), buf->getComplexLen(), spectrum, acc_gain);
     // first the index of the center point
     // this is the bucket for the baseband rx freq
     idx = (spectrogram_buckets / 2); 
-    idx += (int) round((spectrum_center_freq - baseband_rx_freq) / hz_per_bucket);
+    idx += offset_buckets;
     // now we've got the index for the center.
     // correct it to be the start...
     idx -= required_spect_buckets / 2; 
     int sbuck_target = (int) spectrogram_buckets;
-    if((idx < 0) || (idx > sbuck_target)) {
-      slice = NULL; 
-    }
-    else {
+    if((idx >= 0) && (idx <= sbuck_target)) {
       slice = &(spectrum[idx]);
     }
   }
 
-  if(lo_check_mode && (fft_send_counter >= 8)) {
-    // scan the buffer. Then find the peak.
-    // scan from lo_spectrum midpoint minus 2KHz to plus 2KHz
-    float magmax = 0.0;
-    int maxi = 0;
-    int idxrange = ((int) (2000.0 / lo_hz_per_bucket));
-    int i, j; 
-    for(i = -idxrange, j = (lo_spectrogram_buckets / 2) - idxrange; i < idxrange; i++, j++) {
-      std::complex<float> v = lo_spectrum[j];
-      float mag = v.real() * v.real() + v.imag() * v.imag();
-      if(mag > magmax) {
-	magmax = mag;
-	maxi = i; 
-      }
-    }
-    lo_check_mode = false;
-    // send the report
-    double freq = ((float) maxi) * lo_hz_per_bucket;
-    debugMsg(SoDa::Format("offset = %0\n").addF(freq, 10, 6, 'e')); 
-    cmd_stream->put(new SoDa::Command(Command::REP, Command::LO_OFFSET,
-				      freq)); 
-    cmd_stream->put(new SoDa::Command(Command::REP, Command::SPEC_RANGE_LOW,
-				      spectrum_center_freq - 0.5 * spectrum_span));
-    cmd_stream->put(new SoDa::Command(Command::REP, Command::SPEC_RANGE_HI,
-				      spectrum_center_freq + 0.5 * spectrum_span));
-    cmd_stream->put(new SoDa::Command(Command::REP, Command::SPEC_DIMS, 
-				      spectrum_center_freq, 
-				      spectrum_span, 
-				      ((double) required_spect_buckets)));
-    // send the end-of-calib command
-    cmd_stream->put(new SoDa::Command(Command::SET, Command::LO_CHECK,
-				      0.0)); 
-  }
-  else if((fft_send_counter >= fft_update_interval) && (slice != NULL)) {
+  if(slice != NULL) {
     // send the buffer over to the XY plotter.
-    for(int i = 0; i < required_spect_buckets; i++) {
-      log_spectrum[i] = 10.0 * log10(slice[i] * 0.05); 
-    }
-    wfall_socket->put(log_spectrum, sizeof(float) * required_spect_buckets);
+    SoDa::VecOps::dB(log_spectrum, slice, 0.05, required_spect_buckets);
+    unsigned int len = spect_encoder.encode(log_spectrum, required_spect_buckets); 
+    wfall_socket->put(spect_encoder.getBuffer(), len);
     fft_send_counter = 0;
-    calc_max_first = true; 
-    float maxmag = 0.0;
+  }
+}
 
-    for(unsigned int ii = 0; ii < spectrogram_buckets; ii++) {
-      if(spectrum[ii] > maxmag) {
-	maxmag = spectrum[ii];
-      }
+void SoDa::UI::reportLOOffset()
+{
+  // scan the buffer. Then find the peak.
+  // scan from lo_spectrum midpoint minus 2KHz to plus 2KHz
+  float magmax = 0.0;
+  int maxi = 0;
+  int idxrange = ((int) (2000.0 / lo_hz_per_bucket));
+  int i, j; 
+  for(i = -idxrange, j = (lo_spectrogram_buckets / 2) - idxrange; i < idxrange; i++, j++) {
+    std::complex<float> v = lo_spectrum[j];
+    float mag = v.real() * v.real() + v.imag() * v.imag();
+    if(mag > magmax) {
+      magmax = mag;
+      maxi = i; 
     }
   }
+  lo_check_mode = false;
+  // the waterfall average is stale now. 
+  new_spectrum_setting = true; 
+  // send the report
+  double freq = ((float) maxi) * lo_hz_per_bucket;
+  debugMsg(SoDa::Format("offset = %0\n").addF(freq, 10, 6, 'e')); 
+  cmd_stream->put(cmd_stream->make(Command::REP, Command::LO_OFFSET,
+				    freq)); 
+  cmd_stream->put(cmd_stream->make(Command::REP, Command::SPEC_RANGE_LOW,
+				    spectrum_center_freq - 0.5 * spectrum_span));
+  cmd_stream->put(cmd_stream->make(Command::REP, Command::SPEC_RANGE_HI,
+				    spectrum_center_freq + 0.5 * spectrum_span));
+  cmd_stream->put(cmd_stream->make(Command::REP, Command::SPEC_DIMS, 
+				    spectrum_center_freq, 
+				    spectrum_span, 
+				    ((double) required_spect_buckets)));
+  // send the end-of-calib command
+  cmd_stream->put(cmd_stream->make(Command::SET, Command::LO_CHECK,
+				    0.0)); 
 }
 
 /// implement the subscription method
 void SoDa::UI::subscribeToMailBox(const std::string & mbox_name, BaseMBox * mbox_p)
 {
   if(SoDa::connectMailBox<SoDa::CmdMBox>(this, cmd_stream, "CMD", mbox_name, mbox_p)) {
-    cmd_subs = cmd_stream->subscribe();
+    // we forward every report to the client, but only act
+    // on a few SET/GET commands ourselves.
+    SoDa::MBoxFilter filt = Command::makeFilter({Command::SPEC_AVG_WINDOW,
+	  Command::SPEC_CENTER_FREQ,
+	  Command::SPEC_UPDATE_RATE,
+	  Command::SPEC_ENCODING},
+      {Command::SET});
+    filt.merge(Command::makeFilter({Command::LO_OFFSET, Command::DBG_REP}, {Command::GET}));
+    Command::addTypeToFilter(filt, Command::REP);
+    cmd_subs = cmd_stream->subscribe(filt);
   }
   if(SoDa::connectMailBox<SoDa::CmdMBox>(this, cwtxt_stream, "CW_TXT", mbox_name, mbox_p)) {
     // we publish here. 
   }
   if(SoDa::connectMailBox<SoDa::DatMBox>(this, if_stream, "IF", mbox_name, mbox_p)) {
-    if_subs = if_stream->subscribe();
+    // the spectrum display only needs the newest IF buffer.
+    if_subs = if_stream->subscribeLatest();
   }
   if(SoDa::connectMailBox<SoDa::CmdMBox>(this, gps_stream, "GPS", mbox_name, mbox_p)) {
     gps_subs = gps_stream->subscribe();
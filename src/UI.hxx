@@ -36,6 +36,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "UI.hxx"
 #include "UDSockets.hxx"
 #include "Spectrogram.hxx"
+#include "SpectrumEncoding.hxx"
 
 namespace SoDa {
   class UI : public SoDa::Thread {
@@ -48,11 +49,20 @@ namespace SoDa {
     
     void run();
 
+    // the spectrum runs from -100kHz below to 100kHz above the center freq. 
+    static const double spectrum_span; // = 200e3; 
+
+    // full band spectrogram length -- the zoomed spectrum matches its resolution
+    static const unsigned int spectrogram_len = 4 * 4096; 
+
   private:
     // Do an FFT on an rx buffer and send the positive
     // frequencies to any network listeners. 
     void sendFFT(SoDa::Buf * buf);
 
+    // find the peak in the LO check spectrum and report it. 
+    void reportLOOffset();
+
     // the internal communications paths -- between the SoDa threads. 
     CmdMBox * cwtxt_stream, * cmd_stream, * gps_stream;
     DatMBox * if_stream; 
@@ -66,13 +76,17 @@ namespace SoDa {
     Spectrogram * spectrogram;
     unsigned int spectrogram_buckets; 
 
+    // when the display window fits in the IF band, we transform
+    // just the window -- same resolution, smaller FFT. 
+    ZoomSpectrogram * zoom_spectrogram;
+    float * zoom_spectrum;
+    bool zoom_mode; ///< true if the last spectrum came from zoom_spectrogram
+
     Spectrogram * lo_spectrogram; 
     unsigned int lo_spectrogram_buckets;
     double lo_hz_per_bucket;
     float * lo_spectrum; 
 
-    // the spectrum runs from -100kHz below to 100kHz above the center freq. 
-    static const double spectrum_span; // = 200e3; 
     
     double baseband_rx_freq;
     double spectrum_center_freq;
@@ -86,6 +100,10 @@ namespace SoDa {
     unsigned int fft_update_interval;
 
     unsigned int fft_send_counter;
+
+    // how the client wants its spectrum rows -- plain floats unless it asks. 
+    SpectrumEncoder spect_encoder;
+    bool wfall_connected; ///< if false, the next row goes to a new client
     
     // flag to signal that we're in microwave LO search mode.
     bool lo_check_mode;
@@ -27,7 +27,6 @@
 */
 
 #include "USRPRX.hxx"
-#include "QuadratureOscillator.hxx"
 
 #include <uhd/version.hpp>
 #include <uhd/utils/safe_main.hpp>
@@ -116,7 +115,8 @@ void SoDa::USRPRX::run()
 			  this);	
   }
   
-  uhd::set_thread_priority_safe(); 
+  // leave the priority alone if it was set on the command line.
+  if(!hasSchedPolicy()) uhd::set_thread_priority_safe(); 
   // now do the event loop.  we watch
   // for commands and responses on the command stream.
   // and we watch for data in the input buffer. 
@@ -134,10 +134,7 @@ void SoDa::USRPRX::run()
     else if(audio_rx_stream_enabled) {
       // go get some data
       // get a free buffer.
-      SoDa::Buf * buf = rx_stream->alloc();
-      if(buf == NULL) {
-	buf = new SoDa::Buf(rx_buffer_size); 
-      }
+      SoDa::Buf * buf = rx_stream->allocOrNew(rx_buffer_size);
 
       if(buf == NULL) throw SoDa::Radio::Exception("USRPRX couldn't allocate SoDa::Buf object", this); 
       if(buf->getComplexBuf() == NULL) throw SoDa::Radio::Exception("USRPRX allocated empty SoDa::Buf object", this);
@@ -161,13 +158,10 @@ void SoDa::USRPRX::run()
       // If the UI is listening, it will do an FFT on the buffer
       // and send the positive spectrum via the UI to any listener.
       // the UI does the FFT then puts it on its own ring.
-      if(enable_spectrum_report && (if_stream->getSubscriberCount() > 0)) {
-	// clone a buffer, cause we're going to modify
-	// it before the send is complete. 
-	SoDa::Buf * if_buf = if_stream->alloc();
-	if(if_buf == NULL) {
-	  if_buf = new SoDa::Buf(rx_buffer_size); 
-	}
+      // Headless stations have no spectrum listener, so skip the copy.
+      if(enable_spectrum_report && if_stream->hasActiveSubscriber()) {
+	// clone a buffer -- each mailbox recycles its own buffers.
+	SoDa::Buf * if_buf = if_stream->allocOrNew(rx_buffer_size);
 
 	if(if_buf->copy(buf)) {
 	  if_stream->put(if_buf);
@@ -181,9 +175,8 @@ void SoDa::USRPRX::run()
       // support debug... 
       scount++;
 
-      // tune it down with the IF oscillator
-      doMixer(buf); 
-      // now put the baseband signal on the ring.
+      // now put the IF signal on the ring.  (BaseBandRX
+      // takes care of the 3rd LO.)
       rx_stream->put(buf);
 
       // write the buffer output
@@ -196,26 +189,6 @@ void SoDa::USRPRX::run()
   stopStream(); 
 }
 
-void SoDa::USRPRX::doMixer(SoDa::Buf * inout)
-{
-  unsigned int i;
-  std::complex<float> o;
-  std::complex<float> * ioa = inout->getComplexBuf();
-  for(i = 0; i < inout->getComplexMaxLen(); i++) {
-    o = IF_osc.stepOscCF();
-    ioa[i] = ioa[i] * o; 
-  }
-}
-
-void SoDa::USRPRX::set3rdLOFreq(double IF_tuning)
-{
-  // calculate the advance of phase for the IF
-  // oscilator in terms of radians per sample
-  IF_osc.setPhaseIncr(IF_tuning * 2.0 * M_PI / rx_sample_rate);
-  debugMsg(SoDa::Format("Changed 3rdLO to freq = %0\n")
-	   .addF(IF_tuning, 10, 6, 'e'));
-}
-
 void SoDa::USRPRX::execCommand(Command * cmd)
 {
   switch (cmd->cmd) {
@@ -253,10 +226,6 @@ void SoDa::USRPRX::execSetCommand(Command * cmd)
   case SoDa::Command::RX_MODE:
     rx_modulation = SoDa::Command::ModulationType(cmd->iparms[0]); 
     break; 
-  case Command::RX_LO3_FREQ:
-    current_IF_tuning = cmd->dparms[0];
-    set3rdLOFreq(cmd->dparms[0]); 
-    break;
   case SoDa::Command::TX_STATE: // SET TX_ON
     if(cmd->iparms[0] == 3) {
       if((rx_modulation == SoDa::Command::CW_L) || (rx_modulation == SoDa::Command::CW_U)) {
@@ -281,7 +250,7 @@ void SoDa::USRPRX::execSetCommand(Command * cmd)
       startStream();
       enable_spectrum_report = true;
       // tell the baseband unit that it is ready to start. 
-      cmd_stream->put(new Command(Command::SET, Command::TX_STATE, 
+      cmd_stream->put(cmd_stream->make(Command::SET, Command::TX_STATE, 
 				  4));
     }
     break; 
@@ -304,7 +273,10 @@ void SoDa::USRPRX::execRepCommand(Command * cmd)
 void SoDa::USRPRX::subscribeToMailBox(const std::string & mbox_name, 
 					SoDa::BaseMBox * mbox_p) {
   if(SoDa::connectMailBox<SoDa::CmdMBox>(this, cmd_stream, "CMD", mbox_name, mbox_p)) {
-    cmd_subs = cmd_stream->subscribe();
+    // we only care about a handful of SET commands
+    cmd_subs = cmd_stream->subscribe(Command::makeFilter({Command::RX_MODE,
+	    Command::TX_STATE},
+	{Command::SET}));
   }
   if(SoDa::connectMailBox<SoDa::DatMBox>(this, rx_stream, "RX", mbox_name, mbox_p)) {
     // we don't subscribe -- we publish
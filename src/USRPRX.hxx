@@ -34,7 +34,6 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Command.hxx"
 #include "Params.hxx"
 #include "UI.hxx"
-#include "QuadratureOscillator.hxx"
 #include <uhd/usrp/multi_usrp.hpp>
 #include <uhd/stream.hpp>
 
@@ -43,6 +42,10 @@ namespace SoDa {
    * The Receive RF Path
    *
    * @image html SoDa_Radio_RX_Signal_Path.svg
+   *
+   * USRPRX publishes the 3rd IF as it comes from the radio.  The 3rd
+   * LO mix is done downstream, in BaseBandRX, where it is folded into
+   * the first decimation stage.
    */
   class USRPRX : public SoDa::Thread {
   public:
@@ -72,16 +75,6 @@ namespace SoDa {
     void startStream();
     void stopStream(); 
 
-    /**
-     * @brief implement a complex down converter with complex multiplication
-     *
-     * This is a complex downconverter in the manner presented in Lyons pp 457-458
-     *
-     * @param inout the input/output RF buffer
-     */
-    void doMixer(SoDa::Buf * inout);
-    void set3rdLOFreq(double IF_tuning);
-
     DatMBox * rx_stream;
     DatMBox * if_stream; 
     CmdMBox * cmd_stream;
@@ -101,9 +94,6 @@ namespace SoDa {
     // pointer to user interface box -- we send it FFT snapshots
     UI * ui;
 
-    // IF tuner
-    QuadratureOscillator IF_osc;
-    double current_IF_tuning;
     double rx_sample_rate;
 
     // spectrum reporting
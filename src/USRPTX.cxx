@@ -115,7 +115,8 @@ void SoDa::USRPTX::run()
 			  this);	
   }
 
-  uhd::set_thread_priority_safe(); 
+  // leave the priority alone if it was set on the command line.
+  if(!hasSchedPolicy()) uhd::set_thread_priority_safe(); 
   // now do the event loop.  we watch
   // for commands and responses on the command stream.
   // and we watch for data in the input buffer. 
@@ -130,6 +131,11 @@ void SoDa::USRPTX::run()
   Command * cmd; 
   std::vector<std::complex<float> *> buffers(LO_capable ? 2 : 1);
 
+  // When the transmitter is on, we're paced by tx_bits->send.  When
+  // it is off, the only thing that can change that is a command.
+  SoDa::WaitSet wait_set;
+  wait_set.add(cmd_stream, cmd_subs);
+
   while(!exitflag) {
     bool didwork = false; 
     if(LO_capable && LO_enabled && LO_configured) buffers[1] = const_buf;
@@ -179,9 +185,12 @@ void SoDa::USRPTX::run()
 	tx_bits->send(buffers, tx_buffer_size, md); 
 	// are we supposed to tell anybody about this? 
 	if(waiting_to_run_dry) {
-	  cmd_stream->put(new Command(Command::REP, Command::TX_CW_EMPTY, 0));
+	  cmd_stream->put(cmd_stream->make(Command::REP, Command::TX_CW_EMPTY, 0));
 	  waiting_to_run_dry = false; 
 	}
+	// send paced us, and we need to come right back to look
+	// for more envelopes -- don't go to sleep on the wait set.
+	didwork = true; 
       }
     }
     else if(tx_enabled &&
@@ -206,7 +215,7 @@ void SoDa::USRPTX::run()
     }
 
     if(!didwork) {
-      sleep_us(100);
+      wait_set.wait();
     }
   }
 
@@ -217,11 +226,10 @@ void SoDa::USRPTX::run()
 void SoDa::USRPTX::doCW(std::complex<float> * out, float * envelope, unsigned int env_len)
 {
   unsigned int i;
-  std::complex<float> c;
-  
+
+  CW_osc.fill(out, env_len);
   for(i = 0; i < env_len; i++) {
-    c = CW_osc.stepOscCF(); 
-    out[i] = c * envelope[i] * cw_env_amplitude;
+    out[i] *= envelope[i] * cw_env_amplitude;
   }
 }
 
@@ -279,7 +287,7 @@ void SoDa::USRPTX::execSetCommand(Command * cmd)
     // setup for TX <-> RX mode transitions.
     if((cmd->iparms[0] & 0x2) != 0) {  
       transmitSwitch(cmd->iparms[0] == 3);
-      cmd_stream->put(new Command(Command::REP, Command::TX_STATE, tx_enabled ? 1 : 0));
+      cmd_stream->put(cmd_stream->make(Command::REP, Command::TX_STATE, tx_enabled ? 1 : 0));
     }
     break;
   case Command::TX_BEACON:
@@ -305,7 +313,7 @@ void SoDa::USRPTX::execGetCommand(Command * cmd)
 {
   switch(cmd->target) {
   case Command::TX_STATE:
-    cmd_stream->put(new Command(Command::REP, Command::TX_STATE, tx_enabled ? 1 : 0)); 
+    cmd_stream->put(cmd_stream->make(Command::REP, Command::TX_STATE, tx_enabled ? 1 : 0)); 
     break;
   default:
     break; 
@@ -328,7 +336,16 @@ void SoDa::USRPTX::execRepCommand(Command * cmd)
 void SoDa::USRPTX::subscribeToMailBox(const std::string & mbox_name, 
 					SoDa::BaseMBox * mbox_p) {
   if(SoDa::connectMailBox<SoDa::CmdMBox>(this, cmd_stream, "CMD", mbox_name, mbox_p)) {
-    cmd_subs = cmd_stream->subscribe();
+    SoDa::MBoxFilter filt = Command::makeFilter({Command::TVRT_LO_DISABLE,
+	  Command::TVRT_LO_ENABLE,
+	  Command::TX_BEACON,
+	  Command::TX_CW_EMPTY,
+	  Command::TX_MODE,
+	  Command::TX_STATE},
+      {Command::SET});
+    filt.merge(Command::makeFilter({Command::TX_STATE}, {Command::GET}));
+    filt.merge(Command::makeFilter({Command::TVRT_LO_CONFIG}, {Command::REP}));
+    cmd_subs = cmd_stream->subscribe(filt);
   }
   if(SoDa::connectMailBox<SoDa::DatMBox>(this, tx_stream, "TX", mbox_name, mbox_p)) {
     tx_subs = tx_stream->subscribe();
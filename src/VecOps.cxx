@@ -0,0 +1,1043 @@
+/*
+  Copyright (c) 2026, Matthew H. Reilly (kb1vc)
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+  Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in
+  the documentation and/or other materials provided with the
+  distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "VecOps.hxx"
+#include <math.h>
+#include <string.h>
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#  define SODA_VEC_X86 1
+#  include <immintrin.h>
+#else
+#  define SODA_VEC_X86 0
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  define SODA_VEC_NEON 1
+#  include <arm_neon.h>
+#else
+#  define SODA_VEC_NEON 0
+#endif
+
+// The x86 kernels are compiled with target attributes so that the
+// rest of the build doesn't need -mavx2; we only call them when
+// the CPU says it can run them.
+#if SODA_VEC_X86
+#  define SODA_TARGET_SSE2 __attribute__((target("sse2")))
+#  define SODA_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+
+namespace {
+  // ---------------- scalar ----------------
+  // These also finish the last few elements for the vector versions.
+  // They walk the pointers, as indexing the interleaved samples by
+  // 2*i convinces gcc to build a very slow gather. 
+
+  void cmulScaleScalar(float * out, const float * a, const float * b, float scale, unsigned int len)
+  {
+    for(unsigned int i = 0; i < 2 * len; i += 2) {
+      float ar = a[i], ai = a[i+1];
+      float br = b[i], bi = b[i+1];
+      out[i] = (ar * br - ai * bi) * scale;
+      out[i+1] = (ar * bi + ai * br) * scale; 
+    }
+  }
+
+  void cmulRealScalar(float * out, const float * a, const float * w, unsigned int len)
+  {
+    for(; len > 0; len--, out += 2, a += 2, w++) {
+      out[0] = a[0] * w[0];
+      out[1] = a[1] * w[0];
+    }
+  }
+
+  void magSqAccScalar(float * acc, const float * a, float gain, unsigned int len)
+  {
+    for(; len > 0; len--, acc++, a += 2) {
+      acc[0] += gain * (a[0] * a[0] + a[1] * a[1]); 
+    }
+  }
+
+  void expAvgScalar(float * acc, const float * in, float alpha, unsigned int len)
+  {
+    float beta = 1.0 - alpha; 
+    for(unsigned int i = 0; i < len; i++) {
+      acc[i] = in[i] * beta + acc[i] * alpha;
+    }
+  }
+
+  float dotRealScalar(const float * x, const float * h, unsigned int len)
+  {
+    float sum = 0.0;
+    for(unsigned int i = 0; i < len; i++) sum += x[i] * h[i];
+    return sum; 
+  }
+
+  void dotCplxRealScalar(float * res, const float * x, const float * h, unsigned int len)
+  {
+    float re = 0.0, im = 0.0; 
+    for(; len > 0; len--, x += 2, h++) {
+      re += x[0] * h[0];
+      im += x[1] * h[0];
+    }
+    res[0] = re;
+    res[1] = im; 
+  }
+
+  void dotCplxScalar(float * res, const float * x, const float * h, unsigned int len)
+  {
+    float re = 0.0, im = 0.0; 
+    for(; len > 0; len--, x += 2, h += 2) {
+      re += x[0] * h[0] - x[1] * h[1];
+      im += x[0] * h[1] + x[1] * h[0];
+    }
+    res[0] = re;
+    res[1] = im; 
+  }
+
+  // atan(z) for 0 <= z <= 1: a minimax odd polynomial, good to
+  // about 1e-6 radians, which is well below the noise in any FM
+  // signal we'll see.  The vector versions use the same coefficients
+  // and the same octant folding, so all the kernel sets agree.
+  const float atan_c1 = 0.99997726f;
+  const float atan_c3 = -0.33262347f;
+  const float atan_c5 = 0.19354346f;
+  const float atan_c7 = -0.11643287f;
+  const float atan_c9 = 0.05265332f;
+  const float atan_c11 = -0.01172120f; 
+
+  inline float atan2Poly(float y, float x)
+  {
+    float ax = fabsf(x), ay = fabsf(y);
+    bool swap = ay > ax; 
+    float mx = swap ? ay : ax;
+    float mn = swap ? ax : ay; 
+    float z = (mx > 0.0f) ? (mn / mx) : 0.0f; 
+    float s = z * z;
+    float r = z * (atan_c1 + s * (atan_c3 + s * (atan_c5 + s * (atan_c7 + s * (atan_c9 + s * atan_c11)))));
+    if(swap) r = (float) M_PI_2 - r;
+    if(x < 0.0f) r = (float) M_PI - r;
+    return copysignf(r, y); 
+  }
+
+  void fmDiscScalar(float * out, const float * in, float * prev, float gain, unsigned int len)
+  {
+    float pr = prev[0], pi = prev[1];
+    for(; len > 0; len--, out++, in += 2) {
+      float cr = in[0], ci = in[1];
+      // in * conj(prev)
+      out[0] = gain * atan2Poly(ci * pr - cr * pi, cr * pr + ci * pi);
+      pr = cr;
+      pi = ci; 
+    }
+    prev[0] = pr;
+    prev[1] = pi; 
+  }
+
+  float magScalar(float * out, const float * in, float scale, unsigned int len)
+  {
+    float sum = 0.0; 
+    for(; len > 0; len--, out++, in += 2) {
+      out[0] = scale * sqrtf(in[0] * in[0] + in[1] * in[1]);
+      sum += out[0]; 
+    }
+    return sum; 
+  }
+
+  void ssbCombineScalar(float * out, const float * in, float sbmul, unsigned int len)
+  {
+    for(; len > 0; len--, out++, in += 2) {
+      out[0] = in[0] + sbmul * in[1];
+    }
+  }
+
+  void sumSqPeakScalar(float * res, const float * in, unsigned int len)
+  {
+    float sum = 0.0, peak = 0.0; 
+    for(unsigned int i = 0; i < len; i++) {
+      sum += in[i] * in[i];
+      float a = fabsf(in[i]);
+      peak = (a > peak) ? a : peak; 
+    }
+    res[0] = sum;
+    res[1] = peak; 
+  }
+
+  // 10 log10(x) = (10 / ln 10) * (e ln 2 + ln m) where x = m 2^e
+  // and m is in [sqrt(1/2), sqrt(2)).  With s = (m - 1)/(m + 1),
+  // ln m = 2 (s + s^3/3 + s^5/5 + s^7/7 + ...) and |s| < 0.172 so
+  // four terms are plenty.  The vector versions do the same thing. 
+  const float db_per_ln = 4.342944819f;
+  const float db_ln2 = 0.693147181f;
+  const float db_sqrt2 = 1.414213562f;
+  const float db_min = 1e-30f; 
+  
+  void dBScalar(float * out, const float * in, float scale, unsigned int len)
+  {
+    for(unsigned int i = 0; i < len; i++) {
+      float x = in[i] * scale;
+      x = (x > db_min) ? x : db_min; 
+      // split x into m 2^e with m in [1, 2)
+      uint32_t xi;
+      memcpy(&xi, &x, sizeof(xi));
+      int e = ((int) (xi >> 23)) - 127;
+      xi = (xi & 0x007fffff) | 0x3f800000;
+      float m;
+      memcpy(&m, &xi, sizeof(m));
+      if(m > db_sqrt2) {
+	m = m * 0.5f;
+	e = e + 1; 
+      }
+      float s = (m - 1.0f) / (m + 1.0f);
+      float s2 = s * s; 
+      float lnm = 2.0f * s * (1.0f + s2 * (1.0f / 3.0f + s2 * (0.2f + s2 * (1.0f / 7.0f))));
+      out[i] = db_per_ln * (((float) e) * db_ln2 + lnm);
+    }
+  }
+
+#if SODA_VEC_X86
+  // ---------------- SSE2 ----------------
+  // SSE2 has no addsub, so the complex multiply flips the sign of
+  // the even (real) lanes of the cross product with an xor.
+
+  SODA_TARGET_SSE2 inline __m128 cmul2SSE2(__m128 a, __m128 b, __m128 sign)
+  {
+    __m128 b_re = _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 2, 0, 0)); 
+    __m128 b_im = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 3, 1, 1));
+    __m128 a_sw = _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 cross = _mm_xor_ps(_mm_mul_ps(a_sw, b_im), sign);
+    return _mm_add_ps(_mm_mul_ps(a, b_re), cross); 
+  }
+
+  SODA_TARGET_SSE2 void cmulScaleSSE2(float * out, const float * a, const float * b, float scale, unsigned int len)
+  {
+    const __m128 sign = _mm_set_ps(0.0f, -0.0f, 0.0f, -0.0f);
+    const __m128 vs = _mm_set1_ps(scale); 
+    unsigned int i = 0;
+    for(; i + 2 <= len; i += 2) {
+      __m128 r = cmul2SSE2(_mm_loadu_ps(a + 2*i), _mm_loadu_ps(b + 2*i), sign);
+      _mm_storeu_ps(out + 2*i, _mm_mul_ps(r, vs));
+    }
+    cmulScaleScalar(out + 2*i, a + 2*i, b + 2*i, scale, len - i); 
+  }
+
+  SODA_TARGET_SSE2 void cmulRealSSE2(float * out, const float * a, const float * w, unsigned int len)
+  {
+    unsigned int i = 0;
+    for(; i + 4 <= len; i += 4) {
+      __m128 vw = _mm_loadu_ps(w + i);
+      __m128 w_lo = _mm_unpacklo_ps(vw, vw);
+      __m128 w_hi = _mm_unpackhi_ps(vw, vw); 
+      _mm_storeu_ps(out + 2*i, _mm_mul_ps(_mm_loadu_ps(a + 2*i), w_lo));
+      _mm_storeu_ps(out + 2*i + 4, _mm_mul_ps(_mm_loadu_ps(a + 2*i + 4), w_hi));
+    }
+    cmulRealScalar(out + 2*i, a + 2*i, w + i, len - i);
+  }
+
+  SODA_TARGET_SSE2 void magSqAccSSE2(float * acc, const float * a, float gain, unsigned int len)
+  {
+    const __m128 vg = _mm_set1_ps(gain); 
+    unsigned int i = 0;
+    for(; i + 4 <= len; i += 4) {
+      __m128 a0 = _mm_loadu_ps(a + 2*i);
+      __m128 a1 = _mm_loadu_ps(a + 2*i + 4);
+      a0 = _mm_mul_ps(a0, a0);
+      a1 = _mm_mul_ps(a1, a1);
+      __m128 re = _mm_shuffle_ps(a0, a1, _MM_SHUFFLE(2, 0, 2, 0));
+      __m128 im = _mm_shuffle_ps(a0, a1, _MM_SHUFFLE(3, 1, 3, 1));
+      __m128 m = _mm_mul_ps(_mm_add_ps(re, im), vg); 
+      _mm_storeu_ps(acc + i, _mm_add_ps(_mm_loadu_ps(acc + i), m)); 
+    }
+    magSqAccScalar(acc + i, a + 2*i, gain, len - i);
+  }
+
+  SODA_TARGET_SSE2 void expAvgSSE2(float * acc, const float * in, float alpha, unsigned int len)
+  {
+    const __m128 va = _mm_set1_ps(alpha);
+    const __m128 vb = _mm_set1_ps(1.0f - alpha); 
+    unsigned int i = 0;
+    for(; i + 4 <= len; i += 4) {
+      __m128 r = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(in + i), vb),
+			    _mm_mul_ps(_mm_loadu_ps(acc + i), va));
+      _mm_storeu_ps(acc + i, r);
+    }
+    expAvgScalar(acc + i, in + i, alpha, len - i); 
+  }
+
+  SODA_TARGET_SSE2 float dotRealSSE2(const float * x, const float * h, unsigned int len)
+  {
+    __m128 acc = _mm_setzero_ps();
+    unsigned int i = 0;
+    for(; i + 4 <= len; i += 4) {
+      acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(h + i)));
+    }
+    float a[4];
+    _mm_storeu_ps(a, acc);
+    return (a[0] + a[1]) + (a[2] + a[3]) + dotRealScalar(x + i, h + i, len - i); 
+  }
+
+  SODA_TARGET_SSE2 void dotCplxRealSSE2(float * res, const float * x, const float * h, unsigned int len)
+  {
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();    
+    unsigned int i = 0;
+    for(; i + 4 <= len; i += 4) {
+      __m128 vh = _mm_loadu_ps(h + i);
+      acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(x + 2*i), _mm_unpacklo_ps(vh, vh)));
+      acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(x + 2*i + 4), _mm_unpackhi_ps(vh, vh)));
+    }
+    float a[4];
+    _mm_storeu_ps(a, _mm_add_ps(acc0, acc1));
+    dotCplxRealScalar(res, x + 2*i, h + i, len - i);
+    res[0] += a[0] + a[2];
+    res[1] += a[1] + a[3];
+  }
+
+  SODA_TARGET_SSE2 void dotCplxSSE2(float * res, const float * x, const float * h, unsigned int len)
+  {
+    // accumulate x * h.re and swapped(x) * h.im separately, and
+    // sort out the signs at the end.
+    __m128 acc_a = _mm_setzero_ps();
+    __m128 acc_b = _mm_setzero_ps();    
+    unsigned int i = 0;
+    for(; i + 2 <= len; i += 2) {
+      __m128 vx = _mm_loadu_ps(x + 2*i);
+      __m128 vh = _mm_loadu_ps(h + 2*i);
+      __m128 h_re = _mm_shuffle_ps(vh, vh, _MM_SHUFFLE(2, 2, 0, 0)); 
+      __m128 h_im = _mm_shuffle_ps(vh, vh, _MM_SHUFFLE(3, 3, 1, 1));
+      __m128 x_sw = _mm_shuffle_ps(vx, vx, _MM_SHUFFLE(2, 3, 0, 1));
+      acc_a = _mm_add_ps(acc_a, _mm_mul_ps(vx, h_re));
+      acc_b = _mm_add_ps(acc_b, _mm_mul_ps(x_sw, h_im));
+    }
+    float a[4], b[4];
+    _mm_storeu_ps(a, acc_a);
+    _mm_storeu_ps(b, acc_b);
+    dotCplxScalar(res, x + 2*i, h + 2*i, len - i);
+    res[0] += (a[0] + a[2]) - (b[0] + b[2]);
+    res[1] += (a[1] + a[3]) + (b[1] + b[3]);
+  }
+
+  SODA_TARGET_SSE2 inline __m128 atan2SSE2(__m128 y, __m128 x)
+  {
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    const __m128 zero = _mm_setzero_ps(); 
+    __m128 ax = _mm_andnot_ps(sign, x);
+    __m128 ay = _mm_andnot_ps(sign, y);
+    __m128 swap = _mm_cmpgt_ps(ay, ax);
+    __m128 mx = _mm_max_ps(ax, ay);
+    // 0/0 is a NaN, the mask turns it into a 0.
+    __m128 z = _mm_and_ps(_mm_div_ps(_mm_min_ps(ax, ay), mx), _mm_cmpgt_ps(mx, zero)); 
+    __m128 s = _mm_mul_ps(z, z);
+    __m128 p = _mm_add_ps(_mm_set1_ps(atan_c9), _mm_mul_ps(s, _mm_set1_ps(atan_c11)));
+    p = _mm_add_ps(_mm_set1_ps(atan_c7), _mm_mul_ps(s, p));
+    p = _mm_add_ps(_mm_set1_ps(atan_c5), _mm_mul_ps(s, p));
+    p = _mm_add_ps(_mm_set1_ps(atan_c3), _mm_mul_ps(s, p));
+    p = _mm_add_ps(_mm_set1_ps(atan_c1), _mm_mul_ps(s, p));
+    __m128 r = _mm_mul_ps(z, p);
+    __m128 f = _mm_sub_ps(_mm_set1_ps((float) M_PI_2), r);
+    r = _mm_or_ps(_mm_and_ps(swap, f), _mm_andnot_ps(swap, r));
+    __m128 neg = _mm_cmplt_ps(x, zero);
+    f = _mm_sub_ps(_mm_set1_ps((float) M_PI), r);
+    r = _mm_or_ps(_mm_and_ps(neg, f), _mm_andnot_ps(neg, r));
+    // r is positive, so this is copysign
+    return _mm_or_ps(r, _mm_and_ps(y, sign)); 
+  }
+
+  SODA_TARGET_SSE2 void fmDiscSSE2(float * out, const float * in, float * prev, float gain, unsigned int len)
+  {
+    if(len == 0) return; 
+    // after the first sample, the previous sample is just in[i-1]
+    fmDiscScalar(out, in, prev, gain, 1);
+    const __m128 vg = _mm_set1_ps(gain); 
+    unsigned int i = 1;
+    for(; i + 4 <= len; i += 4) {
+      __m128 c0 = _mm_loadu_ps(in + 2*i);
+      __m128 c1 = _mm_loadu_ps(in + 2*i + 4);
+      __m128 p0 = _mm_loadu_ps(in + 2*i - 2);
+      __m128 p1 = _mm_loadu_ps(in + 2*i + 2);
+      __m128 cr = _mm_shuffle_ps(c0, c1, _MM_SHUFFLE(2, 0, 2, 0));
+      __m128 ci = _mm_shuffle_ps(c0, c1, _MM_SHUFFLE(3, 1, 3, 1));
+      __m128 pr = _mm_shuffle_ps(p0, p1, _MM_SHUFFLE(2, 0, 2, 0));
+      __m128 pi = _mm_shuffle_ps(p0, p1, _MM_SHUFFLE(3, 1, 3, 1));
+      __m128 y = _mm_sub_ps(_mm_mul_ps(ci, pr), _mm_mul_ps(cr, pi));
+      __m128 x = _mm_add_ps(_mm_mul_ps(cr, pr), _mm_mul_ps(ci, pi));
+      _mm_storeu_ps(out + i, _mm_mul_ps(atan2SSE2(y, x), vg));
+    }
+    prev[0] = in[2*i - 2];
+    prev[1] = in[2*i - 1];
+    fmDiscScalar(out + i, in + 2*i, prev, gain, len - i);
+  }
+
+  SODA_TARGET_SSE2 float magSSE2(float * out, const float * in, float scale, unsigned int len)
+  {
+    const __m128 vs = _mm_set1_ps(scale); 
+    __m128 acc = _mm_setzero_ps();
+    unsigned int i = 0;
+    for(; i + 4 <= len; i += 4) {
+      __m128 a0 = _mm_loadu_ps(in + 2*i);
+      __m128 a1 = _mm_loadu_ps(in + 2*i + 4);
+      a0 = _mm_mul_ps(a0, a0);
+      a1 = _mm_mul_ps(a1, a1);
+      __m128 m = _mm_add_ps(_mm_shuffle_ps(a0, a1, _MM_SHUFFLE(2, 0, 2, 0)),
+			    _mm_shuffle_ps(a0, a1, _MM_SHUFFLE(3, 1, 3, 1)));
+      m = _mm_mul_ps(_mm_sqrt_ps(m), vs);
+      acc = _mm_add_ps(acc, m); 
+      _mm_storeu_ps(out + i, m);
+    }
+    float a[4];
+    _mm_storeu_ps(a, acc);
+    return (a[0] + a[1]) + (a[2] + a[3]) + magScalar(out + i, in + 2*i, scale, len - i);
+  }
+
+  SODA_TARGET_SSE2 void ssbCombineSSE2(float * out, const float * in, float sbmul, unsigned int len)
+  {
+    const __m128 vm = _mm_set1_ps(sbmul); 
+    unsigned int i = 0;
+    for(; i + 4 <= len; i += 4) {
+      __m128 a0 = _mm_loadu_ps(in + 2*i);
+      __m128 a1 = _mm_loadu_ps(in + 2*i + 4);
+      __m128 re = _mm_shuffle_ps(a0, a1, _MM_SHUFFLE(2, 0, 2, 0));
+      __m128 im = _mm_shuffle_ps(a0, a1, _MM_SHUFFLE(3, 1, 3, 1));
+      _mm_storeu_ps(out + i, _mm_add_ps(re, _mm_mul_ps(im, vm)));
+    }
+    ssbCombineScalar(out + i, in + 2*i, sbmul, len - i);
+  }
+
+  SODA_TARGET_SSE2 void sumSqPeakSSE2(float * res, const float * in, unsigned int len)
+  {
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    __m128 acc = _mm_setzero_ps();
+    __m128 pk = _mm_setzero_ps();
+    unsigned int i = 0;
+    for(; i + 4 <= len; i += 4) {
+      __m128 v = _mm_loadu_ps(in + i);
+      acc = _mm_add_ps(acc, _mm_mul_ps(v, v));
+      pk = _mm_max_ps(pk, _mm_andnot_ps(sign, v));
+    }
+    float a[4], b[4];
+    _mm_storeu_ps(a, acc);
+    _mm_storeu_ps(b, pk);
+    sumSqPeakScalar(res, in + i, len - i);
+    res[0] += (a[0] + a[1]) + (a[2] + a[3]);
+    for(int j = 0; j < 4; j++) res[1] = (b[j] > res[1]) ? b[j] : res[1];
+  }
+
+  SODA_TARGET_SSE2 void dBSSE2(float * out, const float * in, float scale, unsigned int len)
+  {
+    const __m128 vscale = _mm_set1_ps(scale);
+    const __m128 vmin = _mm_set1_ps(db_min);
+    const __m128i mant_mask = _mm_set1_epi32(0x007fffff);
+    const __m128i one_bits = _mm_set1_epi32(0x3f800000);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 vsqrt2 = _mm_set1_ps(db_sqrt2); 
+    unsigned int i = 0;
+    for(; i + 4 <= len; i += 4) {
+      __m128 x = _mm_max_ps(_mm_mul_ps(_mm_loadu_ps(in + i), vscale), vmin);
+      __m128i xi = _mm_castps_si128(x);
+      __m128 e = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(xi, 23), _mm_set1_epi32(127)));
+      __m128 m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(xi, mant_mask), one_bits));
+      __m128 big = _mm_cmpgt_ps(m, vsqrt2);
+      m = _mm_or_ps(_mm_and_ps(big, _mm_mul_ps(m, half)), _mm_andnot_ps(big, m));
+      e = _mm_add_ps(e, _mm_and_ps(big, one)); 
+      __m128 s = _mm_div_ps(_mm_sub_ps(m, one), _mm_add_ps(m, one));
+      __m128 s2 = _mm_mul_ps(s, s);
+      __m128 p = _mm_add_ps(_mm_set1_ps(0.2f), _mm_mul_ps(s2, _mm_set1_ps(1.0f / 7.0f)));
+      p = _mm_add_ps(_mm_set1_ps(1.0f / 3.0f), _mm_mul_ps(s2, p));
+      p = _mm_add_ps(one, _mm_mul_ps(s2, p));
+      __m128 lnx = _mm_add_ps(_mm_mul_ps(e, _mm_set1_ps(db_ln2)),
+			      _mm_mul_ps(_mm_add_ps(s, s), p));
+      _mm_storeu_ps(out + i, _mm_mul_ps(lnx, _mm_set1_ps(db_per_ln)));
+    }
+    dBScalar(out + i, in + i, scale, len - i); 
+  }
+
+  // ---------------- AVX2 + FMA ----------------
+  // fmaddsub does the subtract in the even (real) lanes and the add
+  // in the odd (imaginary) lanes, which is exactly the complex multiply.
+
+  SODA_TARGET_AVX2 void cmulScaleAVX2(float * out, const float * a, const float * b, float scale, unsigned int len)
+  {
+    const __m256 vs = _mm256_set1_ps(scale); 
+    unsigned int i = 0;
+    for(; i + 4 <= len; i += 4) {
+      __m256 va = _mm256_loadu_ps(a + 2*i);
+      __m256 vb = _mm256_loadu_ps(b + 2*i);
+      __m256 b_re = _mm256_moveldup_ps(vb);
+      __m256 b_im = _mm256_movehdup_ps(vb);
+      __m256 a_sw = _mm256_permute_ps(va, 0xb1);
+      __m256 r = _mm256_fmaddsub_ps(va, b_re, _mm256_mul_ps(a_sw, b_im));
+      _mm256_storeu_ps(out + 2*i, _mm256_mul_ps(r, vs));
+    }
+    cmulScaleScalar(out + 2*i, a + 2*i, b + 2*i, scale, len - i);
+  }
+
+  SODA_TARGET_AVX2 void cmulRealAVX2(float * out, const float * a, const float * w, unsigned int len)
+  {
+    const __m256i lo_idx = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+    const __m256i hi_idx = _mm256_setr_epi32(4, 4, 5, 5, 6, 6, 7, 7);
+    unsigned int i = 0;
+    for(; i + 8 <= len; i += 8) {
+      __m256 vw = _mm256_loadu_ps(w + i);
+      __m256 w_lo = _mm256_permutevar8x32_ps(vw, lo_idx);
+      __m256 w_hi = _mm256_permutevar8x32_ps(vw, hi_idx);
+      _mm256_storeu_ps(out + 2*i, _mm256_mul_ps(_mm256_loadu_ps(a + 2*i), w_lo));
+      _mm256_storeu_ps(out + 2*i + 8, _mm256_mul_ps(_mm256_loadu_ps(a + 2*i + 8), w_hi));
+    }
+    cmulRealScalar(out + 2*i, a + 2*i, w + i, len - i);
+  }
+
+  SODA_TARGET_AVX2 void magSqAccAVX2(float * acc, const float * a, float gain, unsigned int len)
+  {
+    const __m256 vg = _mm256_set1_ps(gain); 
+    unsigned int i = 0;
+    for(; i + 8 <= len; i += 8) {
+      __m256 a0 = _mm256_loadu_ps(a + 2*i);
+      __m256 a1 = _mm256_loadu_ps(a + 2*i + 8);
+      // hadd works within 128 bit lanes, so the sums come out
+      // as 0 1 4 5 2 3 6 7 -- put them back in order. 
+      __m256 m = _mm256_hadd_ps(_mm256_mul_ps(a0, a0), _mm256_mul_ps(a1, a1));
+      m = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(m), _MM_SHUFFLE(3, 1, 2, 0)));
+      _mm256_storeu_ps(acc + i, _mm256_fmadd_ps(m, vg, _mm256_loadu_ps(acc + i)));
+    }
+    magSqAccScalar(acc + i, a + 2*i, gain, len - i);
+  }
+
+  SODA_TARGET_AVX2 void expAvgAVX2(float * acc, const float * in, float alpha, unsigned int len)
+  {
+    const __m256 va = _mm256_set1_ps(alpha);
+    const __m256 vb = _mm256_set1_ps(1.0f - alpha); 
+    unsigned int i = 0;
+    for(; i + 8 <= len; i += 8) {
+      __m256 r = _mm256_fmadd_ps(_mm256_loadu_ps(acc + i), va,
+				 _mm256_mul_ps(_mm256_loadu_ps(in + i), vb));
+      _mm256_storeu_ps(acc + i, r);
+    }
+    expAvgScalar(acc + i, in + i, alpha, len - i); 
+  }
+  SODA_TARGET_AVX2 float dotRealAVX2(const float * x, const float * h, unsigned int len)
+  {
+    __m256 acc = _mm256_setzero_ps();
+    unsigned int i = 0;
+    for(; i + 8 <= len; i += 8) {
+      acc = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(h + i), acc);
+    }
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    float a[4];
+    _mm_storeu_ps(a, s);
+    return (a[0] + a[1]) + (a[2] + a[3]) + dotRealScalar(x + i, h + i, len - i); 
+  }
+
+  SODA_TARGET_AVX2 void dotCplxRealAVX2(float * res, const float * x, const float * h, unsigned int len)
+  {
+    const __m256i lo_idx = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+    const __m256i hi_idx = _mm256_setr_epi32(4, 4, 5, 5, 6, 6, 7, 7);
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();    
+    unsigned int i = 0;
+    for(; i + 8 <= len; i += 8) {
+      __m256 vh = _mm256_loadu_ps(h + i);
+      acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + 2*i), _mm256_permutevar8x32_ps(vh, lo_idx), acc0);
+      acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(x + 2*i + 8), _mm256_permutevar8x32_ps(vh, hi_idx), acc1);
+    }
+    __m256 acc = _mm256_add_ps(acc0, acc1); 
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    float a[4];
+    _mm_storeu_ps(a, s);
+    dotCplxRealScalar(res, x + 2*i, h + i, len - i);
+    res[0] += a[0] + a[2];
+    res[1] += a[1] + a[3];
+  }
+
+  SODA_TARGET_AVX2 void dotCplxAVX2(float * res, const float * x, const float * h, unsigned int len)
+  {
+    __m256 acc_a = _mm256_setzero_ps();
+    __m256 acc_b = _mm256_setzero_ps();    
+    unsigned int i = 0;
+    for(; i + 4 <= len; i += 4) {
+      __m256 vx = _mm256_loadu_ps(x + 2*i);
+      __m256 vh = _mm256_loadu_ps(h + 2*i);
+      acc_a = _mm256_fmadd_ps(vx, _mm256_moveldup_ps(vh), acc_a);
+      acc_b = _mm256_fmadd_ps(_mm256_permute_ps(vx, 0xb1), _mm256_movehdup_ps(vh), acc_b);
+    }
+    __m128 sa = _mm_add_ps(_mm256_castps256_ps128(acc_a), _mm256_extractf128_ps(acc_a, 1));
+    __m128 sb = _mm_add_ps(_mm256_castps256_ps128(acc_b), _mm256_extractf128_ps(acc_b, 1));
+    float a[4], b[4];
+    _mm_storeu_ps(a, sa);
+    _mm_storeu_ps(b, sb);
+    dotCplxScalar(res, x + 2*i, h + 2*i, len - i);
+    res[0] += (a[0] + a[2]) - (b[0] + b[2]);
+    res[1] += (a[1] + a[3]) + (b[1] + b[3]);
+  }
+  SODA_TARGET_AVX2 inline __m256 atan2AVX2(__m256 y, __m256 x)
+  {
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    const __m256 zero = _mm256_setzero_ps(); 
+    __m256 ax = _mm256_andnot_ps(sign, x);
+    __m256 ay = _mm256_andnot_ps(sign, y);
+    __m256 swap = _mm256_cmp_ps(ay, ax, _CMP_GT_OQ);
+    __m256 mx = _mm256_max_ps(ax, ay);
+    __m256 z = _mm256_and_ps(_mm256_div_ps(_mm256_min_ps(ax, ay), mx),
+			     _mm256_cmp_ps(mx, zero, _CMP_GT_OQ)); 
+    __m256 s = _mm256_mul_ps(z, z);
+    __m256 p = _mm256_fmadd_ps(s, _mm256_set1_ps(atan_c11), _mm256_set1_ps(atan_c9));
+    p = _mm256_fmadd_ps(s, p, _mm256_set1_ps(atan_c7));
+    p = _mm256_fmadd_ps(s, p, _mm256_set1_ps(atan_c5));
+    p = _mm256_fmadd_ps(s, p, _mm256_set1_ps(atan_c3));
+    p = _mm256_fmadd_ps(s, p, _mm256_set1_ps(atan_c1));
+    __m256 r = _mm256_mul_ps(z, p);
+    r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps((float) M_PI_2), r), swap);
+    r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps((float) M_PI), r),
+			 _mm256_cmp_ps(x, zero, _CMP_LT_OQ));
+    return _mm256_or_ps(r, _mm256_and_ps(y, sign)); 
+  }
+
+  // The 8 wide shuffles below work within 128 bit lanes, so a
+  // deinterleaved vector holds samples 0 1 4 5 2 3 6 7.  Everything
+  // between the loads and the store is elementwise, so we put the
+  // results back in order just before the store.
+  SODA_TARGET_AVX2 inline __m256 unscrambleAVX2(__m256 v)
+  {
+    return _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(v), _MM_SHUFFLE(3, 1, 2, 0)));
+  }
+
+  SODA_TARGET_AVX2 void fmDiscAVX2(float * out, const float * in, float * prev, float gain, unsigned int len)
+  {
+    if(len == 0) return; 
+    fmDiscScalar(out, in, prev, gain, 1);
+    const __m256 vg = _mm256_set1_ps(gain); 
+    unsigned int i = 1;
+    for(; i + 8 <= len; i += 8) {
+      __m256 c0 = _mm256_loadu_ps(in + 2*i);
+      __m256 c1 = _mm256_loadu_ps(in + 2*i + 8);
+      __m256 p0 = _mm256_loadu_ps(in + 2*i - 2);
+      __m256 p1 = _mm256_loadu_ps(in + 2*i + 6);
+      __m256 cr = _mm256_shuffle_ps(c0, c1, _MM_SHUFFLE(2, 0, 2, 0));
+      __m256 ci = _mm256_shuffle_ps(c0, c1, _MM_SHUFFLE(3, 1, 3, 1));
+      __m256 pr = _mm256_shuffle_ps(p0, p1, _MM_SHUFFLE(2, 0, 2, 0));
+      __m256 pi = _mm256_shuffle_ps(p0, p1, _MM_SHUFFLE(3, 1, 3, 1));
+      __m256 y = _mm256_fmsub_ps(ci, pr, _mm256_mul_ps(cr, pi));
+      __m256 x = _mm256_fmadd_ps(cr, pr, _mm256_mul_ps(ci, pi));
+      _mm256_storeu_ps(out + i, unscrambleAVX2(_mm256_mul_ps(atan2AVX2(y, x), vg)));
+    }
+    prev[0] = in[2*i - 2];
+    prev[1] = in[2*i - 1];
+    fmDiscScalar(out + i, in + 2*i, prev, gain, len - i);
+  }
+
+  SODA_TARGET_AVX2 float magAVX2(float * out, const float * in, float scale, unsigned int len)
+  {
+    const __m256 vs = _mm256_set1_ps(scale); 
+    __m256 acc = _mm256_setzero_ps();
+    unsigned int i = 0;
+    for(; i + 8 <= len; i += 8) {
+      __m256 a0 = _mm256_loadu_ps(in + 2*i);
+      __m256 a1 = _mm256_loadu_ps(in + 2*i + 8);
+      __m256 m = _mm256_hadd_ps(_mm256_mul_ps(a0, a0), _mm256_mul_ps(a1, a1));
+      m = _mm256_mul_ps(_mm256_sqrt_ps(m), vs);
+      acc = _mm256_add_ps(acc, m); 
+      _mm256_storeu_ps(out + i, unscrambleAVX2(m));
+    }
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    float a[4];
+    _mm_storeu_ps(a, s);
+    return (a[0] + a[1]) + (a[2] + a[3]) + magScalar(out + i, in + 2*i, scale, len - i);
+  }
+
+  SODA_TARGET_AVX2 void ssbCombineAVX2(float * out, const float * in, float sbmul, unsigned int len)
+  {
+    const __m256 vm = _mm256_set1_ps(sbmul); 
+    unsigned int i = 0;
+    for(; i + 8 <= len; i += 8) {
+      __m256 a0 = _mm256_loadu_ps(in + 2*i);
+      __m256 a1 = _mm256_loadu_ps(in + 2*i + 8);
+      __m256 re = _mm256_shuffle_ps(a0, a1, _MM_SHUFFLE(2, 0, 2, 0));
+      __m256 im = _mm256_shuffle_ps(a0, a1, _MM_SHUFFLE(3, 1, 3, 1));
+      _mm256_storeu_ps(out + i, unscrambleAVX2(_mm256_fmadd_ps(im, vm, re)));
+    }
+    ssbCombineScalar(out + i, in + 2*i, sbmul, len - i);
+  }
+
+  SODA_TARGET_AVX2 void sumSqPeakAVX2(float * res, const float * in, unsigned int len)
+  {
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    __m256 acc = _mm256_setzero_ps();
+    __m256 pk = _mm256_setzero_ps();
+    unsigned int i = 0;
+    for(; i + 8 <= len; i += 8) {
+      __m256 v = _mm256_loadu_ps(in + i);
+      acc = _mm256_fmadd_ps(v, v, acc);
+      pk = _mm256_max_ps(pk, _mm256_andnot_ps(sign, v));
+    }
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    __m128 m = _mm_max_ps(_mm256_castps256_ps128(pk), _mm256_extractf128_ps(pk, 1));
+    float a[4], b[4];
+    _mm_storeu_ps(a, s);
+    _mm_storeu_ps(b, m);
+    sumSqPeakScalar(res, in + i, len - i);
+    res[0] += (a[0] + a[1]) + (a[2] + a[3]);
+    for(int j = 0; j < 4; j++) res[1] = (b[j] > res[1]) ? b[j] : res[1];
+  }
+
+  SODA_TARGET_AVX2 void dBAVX2(float * out, const float * in, float scale, unsigned int len)
+  {
+    const __m256 vscale = _mm256_set1_ps(scale);
+    const __m256 vmin = _mm256_set1_ps(db_min);
+    const __m256i mant_mask = _mm256_set1_epi32(0x007fffff);
+    const __m256i one_bits = _mm256_set1_epi32(0x3f800000);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 vsqrt2 = _mm256_set1_ps(db_sqrt2); 
+    unsigned int i = 0;
+    for(; i + 8 <= len; i += 8) {
+      __m256 x = _mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(in + i), vscale), vmin);
+      __m256i xi = _mm256_castps_si256(x);
+      __m256 e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(xi, 23), _mm256_set1_epi32(127)));
+      __m256 m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(xi, mant_mask), one_bits));
+      __m256 big = _mm256_cmp_ps(m, vsqrt2, _CMP_GT_OQ);
+      m = _mm256_blendv_ps(m, _mm256_mul_ps(m, half), big);
+      e = _mm256_add_ps(e, _mm256_and_ps(big, one)); 
+      __m256 s = _mm256_div_ps(_mm256_sub_ps(m, one), _mm256_add_ps(m, one));
+      __m256 s2 = _mm256_mul_ps(s, s);
+      __m256 p = _mm256_fmadd_ps(s2, _mm256_set1_ps(1.0f / 7.0f), _mm256_set1_ps(0.2f));
+      p = _mm256_fmadd_ps(s2, p, _mm256_set1_ps(1.0f / 3.0f));
+      p = _mm256_fmadd_ps(s2, p, one);
+      __m256 lnx = _mm256_fmadd_ps(e, _mm256_set1_ps(db_ln2), _mm256_mul_ps(_mm256_add_ps(s, s), p));
+      _mm256_storeu_ps(out + i, _mm256_mul_ps(lnx, _mm256_set1_ps(db_per_ln)));
+    }
+    dBScalar(out + i, in + i, scale, len - i); 
+  }
+#endif // SODA_VEC_X86
+
+#if SODA_VEC_NEON
+  // ---------------- NEON ----------------
+  // vld2/vst2 split the interleaved complex samples into real and
+  // imaginary vectors for us.
+
+  void cmulScaleNEON(float * out, const float * a, const float * b, float scale, unsigned int len)
+  {
+    unsigned int i = 0;
+    for(; i + 4 <= len; i += 4) {
+      float32x4x2_t va = vld2q_f32(a + 2*i);
+      float32x4x2_t vb = vld2q_f32(b + 2*i);
+      float32x4x2_t r;
+      r.val[0] = vmlsq_f32(vmulq_f32(va.val[0], vb.val[0]), va.val[1], vb.val[1]);
+      r.val[1] = vmlaq_f32(vmulq_f32(va.val[0], vb.val[1]), va.val[1], vb.val[0]);
+      r.val[0] = vmulq_n_f32(r.val[0], scale);
+      r.val[1] = vmulq_n_f32(r.val[1], scale);
+      vst2q_f32(out + 2*i, r);
+    }
+    cmulScaleScalar(out + 2*i, a + 2*i, b + 2*i, scale, len - i);
+  }
+
+  void cmulRealNEON(float * out, const float * a, const float * w, unsigned int len)
+  {
+    unsigned int i = 0;
+    for(; i + 4 <= len; i += 4) {
+      float32x4x2_t va = vld2q_f32(a + 2*i);
+      float32x4_t vw = vld1q_f32(w + i);
+      va.val[0] = vmulq_f32(va.val[0], vw);
+      va.val[1] = vmulq_f32(va.val[1], vw);
+      vst2q_f32(out + 2*i, va);
+    }
+    cmulRealScalar(out + 2*i, a + 2*i, w + i, len - i);
+  }
+
+  void magSqAccNEON(float * acc, const float * a, float gain, unsigned int len)
+  {
+    unsigned int i = 0;
+    for(; i + 4 <= len; i += 4) {
+      float32x4x2_t va = vld2q_f32(a + 2*i);
+      float32x4_t m = vmlaq_f32(vmulq_f32(va.val[0], va.val[0]), va.val[1], va.val[1]);
+      vst1q_f32(acc + i, vmlaq_n_f32(vld1q_f32(acc + i), m, gain));
+    }
+    magSqAccScalar(acc + i, a + 2*i, gain, len - i);
+  }
+
+  void expAvgNEON(float * acc, const float * in, float alpha, unsigned int len)
+  {
+    unsigned int i = 0;
+    for(; i + 4 <= len; i += 4) {
+      float32x4_t r = vmulq_n_f32(vld1q_f32(in + i), 1.0f - alpha);
+      vst1q_f32(acc + i, vmlaq_n_f32(r, vld1q_f32(acc + i), alpha));
+    }
+    expAvgScalar(acc + i, in + i, alpha, len - i); 
+  }
+
+  float dotRealNEON(const float * x, const float * h, unsigned int len)
+  {
+    float32x4_t acc = vdupq_n_f32(0.0f); 
+    unsigned int i = 0;
+    for(; i + 4 <= len; i += 4) {
+      acc = vmlaq_f32(acc, vld1q_f32(x + i), vld1q_f32(h + i));
+    }
+    float32x2_t s = vadd_f32(vget_low_f32(acc), vget_high_f32(acc)); 
+    return vget_lane_f32(vpadd_f32(s, s), 0) + dotRealScalar(x + i, h + i, len - i);
+  }
+
+  void dotCplxRealNEON(float * res, const float * x, const float * h, unsigned int len)
+  {
+    float32x4_t acc_re = vdupq_n_f32(0.0f);
+    float32x4_t acc_im = vdupq_n_f32(0.0f);
+    unsigned int i = 0;
+    for(; i + 4 <= len; i += 4) {
+      float32x4x2_t vx = vld2q_f32(x + 2*i);
+      float32x4_t vh = vld1q_f32(h + i);
+      acc_re = vmlaq_f32(acc_re, vx.val[0], vh);
+      acc_im = vmlaq_f32(acc_im, vx.val[1], vh);
+    }
+    dotCplxRealScalar(res, x + 2*i, h + i, len - i);
+    float32x2_t sr = vadd_f32(vget_low_f32(acc_re), vget_high_f32(acc_re));
+    float32x2_t si = vadd_f32(vget_low_f32(acc_im), vget_high_f32(acc_im));
+    float32x2_t s = vpadd_f32(sr, si); 
+    res[0] += vget_lane_f32(s, 0);
+    res[1] += vget_lane_f32(s, 1);
+  }
+
+  void dotCplxNEON(float * res, const float * x, const float * h, unsigned int len)
+  {
+    float32x4_t acc_re = vdupq_n_f32(0.0f);
+    float32x4_t acc_im = vdupq_n_f32(0.0f);
+    unsigned int i = 0;
+    for(; i + 4 <= len; i += 4) {
+      float32x4x2_t vx = vld2q_f32(x + 2*i);
+      float32x4x2_t vh = vld2q_f32(h + 2*i);
+      acc_re = vmlaq_f32(acc_re, vx.val[0], vh.val[0]);
+      acc_re = vmlsq_f32(acc_re, vx.val[1], vh.val[1]);
+      acc_im = vmlaq_f32(acc_im, vx.val[0], vh.val[1]);
+      acc_im = vmlaq_f32(acc_im, vx.val[1], vh.val[0]);
+    }
+    dotCplxScalar(res, x + 2*i, h + 2*i, len - i);
+    float32x2_t sr = vadd_f32(vget_low_f32(acc_re), vget_high_f32(acc_re));
+    float32x2_t si = vadd_f32(vget_low_f32(acc_im), vget_high_f32(acc_im));
+    float32x2_t s = vpadd_f32(sr, si); 
+    res[0] += vget_lane_f32(s, 0);
+    res[1] += vget_lane_f32(s, 1);
+  }
+  // armv7 NEON has no divide or square root, so we use the
+  // reciprocal estimates with two Newton steps.
+  inline float32x4_t recipNEON(float32x4_t d)
+  {
+    float32x4_t r = vrecpeq_f32(d);
+    r = vmulq_f32(r, vrecpsq_f32(d, r));
+    return vmulq_f32(r, vrecpsq_f32(d, r));
+  }
+
+  inline float32x4_t atan2NEON(float32x4_t y, float32x4_t x)
+  {
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    float32x4_t ax = vabsq_f32(x);
+    float32x4_t ay = vabsq_f32(y);
+    uint32x4_t swap = vcgtq_f32(ay, ax); 
+    float32x4_t mx = vmaxq_f32(ax, ay);
+    float32x4_t z = vmulq_f32(vminq_f32(ax, ay), recipNEON(mx));
+    z = vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(z), vcgtq_f32(mx, zero)));
+    float32x4_t s = vmulq_f32(z, z);
+    float32x4_t p = vmlaq_n_f32(vdupq_n_f32(atan_c9), s, atan_c11);
+    p = vmlaq_f32(vdupq_n_f32(atan_c7), s, p);
+    p = vmlaq_f32(vdupq_n_f32(atan_c5), s, p);
+    p = vmlaq_f32(vdupq_n_f32(atan_c3), s, p);
+    p = vmlaq_f32(vdupq_n_f32(atan_c1), s, p);
+    float32x4_t r = vmulq_f32(z, p);
+    r = vbslq_f32(swap, vsubq_f32(vdupq_n_f32((float) M_PI_2), r), r);
+    r = vbslq_f32(vcltq_f32(x, zero), vsubq_f32(vdupq_n_f32((float) M_PI), r), r);
+    uint32x4_t ysign = vandq_u32(vreinterpretq_u32_f32(y), vdupq_n_u32(0x80000000));
+    return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(r), ysign));
+  }
+
+  void fmDiscNEON(float * out, const float * in, float * prev, float gain, unsigned int len)
+  {
+    if(len == 0) return; 
+    fmDiscScalar(out, in, prev, gain, 1);
+    unsigned int i = 1;
+    for(; i + 4 <= len; i += 4) {
+      float32x4x2_t c = vld2q_f32(in + 2*i);
+      float32x4x2_t p = vld2q_f32(in + 2*i - 2);
+      float32x4_t y = vmlsq_f32(vmulq_f32(c.val[1], p.val[0]), c.val[0], p.val[1]);
+      float32x4_t x = vmlaq_f32(vmulq_f32(c.val[0], p.val[0]), c.val[1], p.val[1]);
+      vst1q_f32(out + i, vmulq_n_f32(atan2NEON(y, x), gain));
+    }
+    prev[0] = in[2*i - 2];
+    prev[1] = in[2*i - 1];
+    fmDiscScalar(out + i, in + 2*i, prev, gain, len - i);
+  }
+
+  float magNEON(float * out, const float * in, float scale, unsigned int len)
+  {
+    unsigned int i = 0;
+    float sum = 0.0; 
+#  if defined(__aarch64__)
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    for(; i + 4 <= len; i += 4) {
+      float32x4x2_t va = vld2q_f32(in + 2*i);
+      float32x4_t m = vmlaq_f32(vmulq_f32(va.val[0], va.val[0]), va.val[1], va.val[1]);
+      m = vmulq_n_f32(vsqrtq_f32(m), scale);
+      acc = vaddq_f32(acc, m); 
+      vst1q_f32(out + i, m);
+    }
+    sum = vaddvq_f32(acc); 
+#  endif
+    return sum + magScalar(out + i, in + 2*i, scale, len - i);
+  }
+
+  void ssbCombineNEON(float * out, const float * in, float sbmul, unsigned int len)
+  {
+    unsigned int i = 0;
+    for(; i + 4 <= len; i += 4) {
+      float32x4x2_t va = vld2q_f32(in + 2*i);
+      vst1q_f32(out + i, vmlaq_n_f32(va.val[0], va.val[1], sbmul));
+    }
+    ssbCombineScalar(out + i, in + 2*i, sbmul, len - i);
+  }
+
+  void sumSqPeakNEON(float * res, const float * in, unsigned int len)
+  {
+    float32x4_t acc = vdupq_n_f32(0.0f); 
+    float32x4_t pk = vdupq_n_f32(0.0f); 
+    unsigned int i = 0;
+    for(; i + 4 <= len; i += 4) {
+      float32x4_t v = vld1q_f32(in + i);
+      acc = vmlaq_f32(acc, v, v);
+      pk = vmaxq_f32(pk, vabsq_f32(v));
+    }
+    sumSqPeakScalar(res, in + i, len - i);
+    float32x2_t s = vadd_f32(vget_low_f32(acc), vget_high_f32(acc)); 
+    float32x2_t m = vmax_f32(vget_low_f32(pk), vget_high_f32(pk)); 
+    res[0] += vget_lane_f32(vpadd_f32(s, s), 0);
+    float p = vget_lane_f32(vpmax_f32(m, m), 0);
+    res[1] = (p > res[1]) ? p : res[1]; 
+  }
+
+  void dBNEON(float * out, const float * in, float scale, unsigned int len)
+  {
+    unsigned int i = 0;
+#  if defined(__aarch64__)
+    const float32x4_t vmin = vdupq_n_f32(db_min);
+    const uint32x4_t mant_mask = vdupq_n_u32(0x007fffff);
+    const uint32x4_t one_bits = vdupq_n_u32(0x3f800000);
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    for(; i + 4 <= len; i += 4) {
+      float32x4_t x = vmaxq_f32(vmulq_n_f32(vld1q_f32(in + i), scale), vmin);
+      uint32x4_t xi = vreinterpretq_u32_f32(x);
+      float32x4_t e = vcvtq_f32_s32(vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(xi, 23)), vdupq_n_s32(127)));
+      float32x4_t m = vreinterpretq_f32_u32(vorrq_u32(vandq_u32(xi, mant_mask), one_bits));
+      uint32x4_t big = vcgtq_f32(m, vdupq_n_f32(db_sqrt2));
+      m = vbslq_f32(big, vmulq_n_f32(m, 0.5f), m);
+      e = vaddq_f32(e, vreinterpretq_f32_u32(vandq_u32(big, vreinterpretq_u32_f32(one))));
+      float32x4_t s = vdivq_f32(vsubq_f32(m, one), vaddq_f32(m, one));
+      float32x4_t s2 = vmulq_f32(s, s);
+      float32x4_t p = vmlaq_n_f32(vdupq_n_f32(0.2f), s2, 1.0f / 7.0f);
+      p = vmlaq_f32(vdupq_n_f32(1.0f / 3.0f), s2, p);
+      p = vmlaq_f32(one, s2, p);
+      float32x4_t lnx = vmlaq_n_f32(vmulq_f32(vaddq_f32(s, s), p), e, db_ln2);
+      vst1q_f32(out + i, vmulq_n_f32(lnx, db_per_ln));
+    }
+#  endif
+    dBScalar(out + i, in + i, scale, len - i); 
+  }
+#endif // SODA_VEC_NEON
+}
+
+bool SoDa::VecOps::supported(ISA isa)
+{
+  switch(isa) {
+  case SCALAR:
+    return true;
+#if SODA_VEC_X86
+  case SSE2:
+    return __builtin_cpu_supports("sse2");
+  case AVX2:
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"); 
+#endif
+#if SODA_VEC_NEON
+  case NEON:
+    return true;
+#endif
+  default:
+    return false; 
+  }
+}
+
+SoDa::VecOps::ISA SoDa::VecOps::bestISA()
+{
+  if(supported(AVX2)) return AVX2;
+  if(supported(SSE2)) return SSE2;
+  if(supported(NEON)) return NEON;
+  return SCALAR; 
+}
+
+SoDa::VecOps::Kernels SoDa::VecOps::selectKernels(ISA isa)
+{
+  Kernels k = { SCALAR, cmulScaleScalar, cmulRealScalar, magSqAccScalar, expAvgScalar,
+		  dotRealScalar, dotCplxRealScalar, dotCplxScalar,
+		  fmDiscScalar, magScalar, ssbCombineScalar, sumSqPeakScalar, dBScalar };
+
+  switch(isa) {
+#if SODA_VEC_X86
+  case SSE2:
+    k = { SSE2, cmulScaleSSE2, cmulRealSSE2, magSqAccSSE2, expAvgSSE2,
+		  dotRealSSE2, dotCplxRealSSE2, dotCplxSSE2,
+		  fmDiscSSE2, magSSE2, ssbCombineSSE2, sumSqPeakSSE2, dBSSE2 };
+    break;
+  case AVX2:
+    k = { AVX2, cmulScaleAVX2, cmulRealAVX2, magSqAccAVX2, expAvgAVX2,
+		  dotRealAVX2, dotCplxRealAVX2, dotCplxAVX2,
+		  fmDiscAVX2, magAVX2, ssbCombineAVX2, sumSqPeakAVX2, dBAVX2 };
+    break; 
+#endif
+#if SODA_VEC_NEON
+  case NEON:
+    k = { NEON, cmulScaleNEON, cmulRealNEON, magSqAccNEON, expAvgNEON,
+		  dotRealNEON, dotCplxRealNEON, dotCplxNEON,
+		  fmDiscNEON, magNEON, ssbCombineNEON, sumSqPeakNEON, dBNEON };
+    break; 
+#endif
+  default:
+    break; 
+  }
+
+  return k; 
+}
+
+bool SoDa::VecOps::forceISA(ISA isa)
+{
+  if(!supported(isa)) return false;
+  getKernels() = selectKernels(isa);
+  return true; 
+}
+
+std::string SoDa::VecOps::isaName(ISA isa)
+{
+  switch(isa) {
+  case SSE2: return "SSE2";
+  case AVX2: return "AVX2+FMA";
+  case NEON: return "NEON";
+  default: return "scalar"; 
+  }
+}
@@ -0,0 +1,228 @@
+/*
+  Copyright (c) 2026, Matthew H. Reilly (kb1vc)
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+  Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in
+  the documentation and/or other materials provided with the
+  distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef VEC_OPS_HDR
+#define VEC_OPS_HDR
+
+#include <complex>
+#include <string>
+
+namespace SoDa {
+  /**
+   * @brief Vector kernels for the inner loops of the filters, the
+   * spectrogram, and the demodulators.
+   *
+   * The spectral multiply in OSFilter and HilbertTransformer, the
+   * window/magnitude/average loops in Spectrogram, and the FM/AM/SSB
+   * demodulators in BaseBandRX run over every audio and every IF
+   * buffer.  Each kernel here has a scalar version
+   * and SSE2, AVX2+FMA, and NEON versions; the first call picks the
+   * best one the CPU supports (by CPUID on x86) and everyone uses that
+   * from then on.
+   *
+   * None of the kernels care about alignment, and any length is fine
+   * -- the odd elements at the end are done one at a time.  Input
+   * and output may be the same array, but may not otherwise overlap.
+   */
+  class VecOps {
+  public:
+    enum ISA { SCALAR, SSE2, AVX2, NEON };
+
+    /**
+     * @brief out[i] = a[i] * b[i] * scale
+     */
+    static void cmulScale(std::complex<float> * out,
+			  const std::complex<float> * a,
+			  const std::complex<float> * b,
+			  float scale, unsigned int len) {
+      getKernels().cmul_scale((float*) out, (const float*) a, (const float*) b, scale, len);
+    }
+
+    /**
+     * @brief out[i] = a[i] * w[i] where w is real -- a window.
+     */
+    static void cmulReal(std::complex<float> * out,
+			 const std::complex<float> * a,
+			 const float * w, unsigned int len) {
+      getKernels().cmul_real((float*) out, (const float*) a, w, len);
+    }
+
+    /**
+     * @brief acc[i] += gain * |a[i]|^2
+     */
+    static void magSqAcc(float * acc, const std::complex<float> * a,
+			 float gain, unsigned int len) {
+      getKernels().mag_sq_acc(acc, (const float*) a, gain, len);
+    }
+
+    /**
+     * @brief acc[i] = in[i] * (1 - alpha) + acc[i] * alpha
+     */
+    static void expAvg(float * acc, const float * in,
+		       float alpha, unsigned int len) {
+      getKernels().exp_avg(acc, in, alpha, len);
+    }
+
+    /**
+     * @brief inner product of real samples and real taps
+     * @return sum of x[i] * h[i]
+     */
+    static float dot(const float * x, const float * h, unsigned int len) {
+      return getKernels().dot_real(x, h, len);
+    }
+
+    /**
+     * @brief inner product of complex samples and real taps
+     * @return sum of x[i] * h[i]
+     */
+    static std::complex<float> dot(const std::complex<float> * x, const float * h, unsigned int len) {
+      float r[2];
+      getKernels().dot_cplx_real(r, (const float*) x, h, len);
+      return std::complex<float>(r[0], r[1]); 
+    }
+
+    /**
+     * @brief inner product of complex samples and complex taps
+     * @return sum of x[i] * h[i]
+     */
+    static std::complex<float> dot(const std::complex<float> * x, const std::complex<float> * h, unsigned int len) {
+      float r[2];
+      getKernels().dot_cplx(r, (const float*) x, (const float*) h, len);
+      return std::complex<float>(r[0], r[1]); 
+    }
+
+    /**
+     * @brief FM discriminator: the angle between successive samples
+     *
+     * out[i] = gain * arg(in[i] * conj(in[i-1])) where in[-1] is prev.
+     * This is the same thing as the difference of the two sample
+     * phases, unwrapped to -pi..pi, but needs no unwrap, and the arg
+     * is a polynomial atan2 (good to about 1e-6 radians), not a libm
+     * call.
+     *
+     * @param out the demodulated samples
+     * @param in the IF samples
+     * @param prev the sample before in[0] -- updated to in[len-1]
+     * @param gain scale factor for the output
+     * @param len number of samples
+     */
+    static void fmDisc(float * out, const std::complex<float> * in,
+		       std::complex<float> & prev, float gain, unsigned int len) {
+      getKernels().fm_disc(out, (const float*) in, (float*) &prev, gain, len);
+    }
+
+    /**
+     * @brief envelope detector: out[i] = scale * |in[i]|
+     * @return the sum of the outputs
+     */
+    static float mag(float * out, const std::complex<float> * in,
+		     float scale, unsigned int len) {
+      return getKernels().mag(out, (const float*) in, scale, len);
+    }
+
+    /**
+     * @brief sideband combine: out[i] = in[i].real() + sbmul * in[i].imag()
+     */
+    static void ssbCombine(float * out, const std::complex<float> * in,
+			   float sbmul, unsigned int len) {
+      getKernels().ssb_combine(out, (const float*) in, sbmul, len);
+    }
+
+    /**
+     * @brief level meter: energy and peak in one pass
+     * @param in the samples
+     * @param len number of samples
+     * @param peak set to the largest |in[i]|
+     * @return sum of in[i]^2
+     */
+    static float sumSqPeak(const float * in, unsigned int len, float & peak) {
+      float r[2];
+      getKernels().sum_sq_peak(r, in, len);
+      peak = r[1];
+      return r[0];
+    }
+
+    /**
+     * @brief power to decibels: out[i] = 10 log10(scale * in[i])
+     *
+     * The log is an exponent/mantissa split and a short series (good
+     * to about 1e-5 dB), not a libm call.  Anything at or below zero
+     * comes out as about -300 dB.
+     */
+    static void dB(float * out, const float * in, float scale, unsigned int len) {
+      getKernels().db(out, in, scale, len);
+    }
+    /**
+     * @brief which kernel set are we using?
+     */
+    static ISA getISA() { return getKernels().isa; }
+
+    /**
+     * @brief use a particular kernel set (for testing and benchmarks).
+     * Call this before any other thread is using the kernels.
+     * @param isa the kernel set
+     * @return false if this CPU (or this build) can't run it.
+     */
+    static bool forceISA(ISA isa);
+
+    /**
+     * @brief does this CPU/build support the kernel set?
+     */
+    static bool supported(ISA isa);
+
+    /// the name of a kernel set
+    static std::string isaName(ISA isa);
+
+  private:
+    struct Kernels {
+      ISA isa;
+      void (*cmul_scale)(float * out, const float * a, const float * b, float scale, unsigned int len);
+      void (*cmul_real)(float * out, const float * a, const float * w, unsigned int len);
+      void (*mag_sq_acc)(float * acc, const float * a, float gain, unsigned int len);
+      void (*exp_avg)(float * acc, const float * in, float alpha, unsigned int len);
+      float (*dot_real)(const float * x, const float * h, unsigned int len);
+      void (*dot_cplx_real)(float * res, const float * x, const float * h, unsigned int len);
+      void (*dot_cplx)(float * res, const float * x, const float * h, unsigned int len);
+      void (*fm_disc)(float * out, const float * in, float * prev, float gain, unsigned int len);
+      float (*mag)(float * out, const float * in, float scale, unsigned int len);
+      void (*ssb_combine)(float * out, const float * in, float sbmul, unsigned int len);
+      void (*sum_sq_peak)(float * res, const float * in, unsigned int len);
+      void (*db)(float * out, const float * in, float scale, unsigned int len);
+    };
+
+    static Kernels & getKernels() {
+      static Kernels k = selectKernels(bestISA());
+      return k; 
+    }
+
+    static ISA bestISA();
+    static Kernels selectKernels(ISA isa);
+  };
+}
+
+#endif
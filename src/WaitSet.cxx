@@ -0,0 +1,126 @@
+/*
+  Copyright (c) 2026, Matthew H. Reilly (kb1vc)
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+  Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in
+  the documentation and/or other materials provided with the
+  distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "WaitSet.hxx"
+#include "SoDaBase.hxx"
+#include <poll.h>
+#include <fcntl.h>
+#include <errno.h>
+
+SoDa::WaitSet::WaitSet()
+{
+  armed = false;
+  if (pipe(wake_pipe) < 0)
+  {
+    throw SoDa::Radio::Exception(std::string("WaitSet couldn't create its wakeup pipe."));
+  }
+  // neither end should ever block -- a full pipe just means
+  // the owner has plenty of wakeups already pending.
+  for (int i = 0; i < 2; i++)
+  {
+    int x = fcntl(wake_pipe[i], F_GETFL, 0);
+    fcntl(wake_pipe[i], F_SETFL, x | O_NONBLOCK);
+  }
+
+  struct pollfd wake;
+  wake.fd = wake_pipe[0];
+  wake.events = POLLIN;
+  wake.revents = 0;
+  pfds.push_back(wake);
+}
+
+SoDa::WaitSet::~WaitSet()
+{
+  for (auto &m : mboxes)
+  {
+    m.mbox->attachWaitSet(m.subscriber_id, NULL);
+  }
+  close(wake_pipe[0]);
+  close(wake_pipe[1]);
+}
+
+void SoDa::WaitSet::add(BaseMBox *mbox, unsigned int subscriber_id)
+{
+  MBoxSub ms;
+  ms.mbox = mbox;
+  ms.subscriber_id = subscriber_id;
+  mboxes.push_back(ms);
+  mbox->attachWaitSet(subscriber_id, this);
+}
+
+void SoDa::WaitSet::addFD(int fd)
+{
+  if (fd >= 0)
+  {
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    pfds.push_back(pfd);
+  }
+}
+
+bool SoDa::WaitSet::anyReady()
+{
+  for (auto &m : mboxes)
+  {
+    if (m.mbox->isReady(m.subscriber_id))
+      return true;
+  }
+  return false;
+}
+
+bool SoDa::WaitSet::wait(int timeout_us)
+{
+  // arm first, then look.  A put that lands after the arm will
+  // poke the pipe; a put that landed before it shows up in anyReady.
+  armed = true;
+  if (anyReady())
+  {
+    armed = false;
+    return true;
+  }
+
+  int timeout_ms = (timeout_us < 0) ? -1 : ((timeout_us + 999) / 1000);
+  int stat = poll(pfds.data(), pfds.size(), timeout_ms);
+
+  armed = false;
+
+  // drain any pokes.
+  char buf[64];
+  while (read(wake_pipe[0], buf, sizeof(buf)) > 0)
+    ;
+
+  if (stat < 0)
+  {
+    // EINTR and friends -- let the caller go around again.
+    return false;
+  }
+
+  return (stat > 0) || anyReady();
+}
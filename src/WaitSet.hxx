@@ -0,0 +1,123 @@
+/*
+  Copyright (c) 2026, Matthew H. Reilly (kb1vc)
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions are
+  met:
+
+  Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+  Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in
+  the documentation and/or other materials provided with the
+  distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef WAITSET_HDR
+#define WAITSET_HDR
+
+#include <atomic>
+#include <vector>
+#include <unistd.h>
+#include <poll.h>
+
+namespace SoDa
+{
+  class BaseMBox;
+
+  /**
+   * @brief Block a thread until one of several mailboxes or file
+   * descriptors has something for it.
+   *
+   * Each (mailbox, subscriber id) pair added to the wait set registers
+   * the wait set with the mailbox.  From then on, every put on that
+   * mailbox pokes the wait set, but only if the owning thread is
+   * actually asleep in wait() -- a busy thread costs the producer one
+   * atomic exchange.  The poke is a byte written to a pipe, so file
+   * descriptors (sockets, serial ports...) can sit in the same poll.
+   *
+   * A wait set belongs to exactly one thread.  Only add mailboxes that
+   * the thread will drain after wait() returns, otherwise the thread
+   * will spin.
+   */
+  class WaitSet
+  {
+  public:
+    WaitSet();
+    ~WaitSet();
+
+    /**
+     * @brief watch a mailbox subscription
+     *
+     * @param mbox the mailbox
+     * @param subscriber_id the subscription that we'll be reading from
+     */
+    void add(BaseMBox *mbox, unsigned int subscriber_id);
+
+    /**
+     * @brief watch a file descriptor for input
+     *
+     * @param fd the descriptor
+     */
+    void addFD(int fd);
+
+    /**
+     * @brief forget all the file descriptors (mailboxes stay put)
+     */
+    void clearFDs() { pfds.resize(1); }
+
+    /**
+     * @brief wait for something to do.
+     *
+     * @param timeout_us give up after this many microseconds. (-1 means wait forever)
+     * @return true if a mailbox or fd is ready, false if we timed out.
+     */
+    bool wait(int timeout_us = -1);
+
+    /**
+     * @brief wake up the owner of this wait set if it is asleep.
+     * Called by the mailboxes from put.
+     */
+    void notify()
+    {
+      if (armed.exchange(false))
+      {
+        char c = 1;
+        ssize_t rv = ::write(wake_pipe[1], &c, 1);
+        (void)rv;
+      }
+    }
+
+  private:
+    bool anyReady();
+
+    struct MBoxSub
+    {
+      BaseMBox *mbox;
+      unsigned int subscriber_id;
+    };
+
+    std::vector<MBoxSub> mboxes; ///< the mailbox subscriptions we watch
+    /// the poll list: the wakeup pipe first, then the descriptors we watch.
+    /// Built by addFD, so wait doesn't allocate.
+    std::vector<struct pollfd> pfds;
+
+    std::atomic<bool> armed; ///< true while the owner is (about to be) asleep
+    int wake_pipe[2];        ///< the mailboxes poke the write end
+  };
+} // namespace SoDa
+
+#endif